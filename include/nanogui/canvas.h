@@ -45,7 +45,10 @@ public:
      *     The parent widget
      *
      * \param samples
-     *     The number of pixel samples (MSAA)
+     *     The number of pixel samples (MSAA). Pass 1 to render straight
+     *     into the screen using a scissored viewport instead of an
+     *     offscreen texture, provided that the screen has the requested
+     *     depth/stencil buffers.
      *
      * \param has_depth_buffer
      *     Should the widget allocate a depth buffer for
@@ -57,18 +60,28 @@ public:
      *
      * \param clear
      *     Should the widget clear its color/depth/stencil buffer?
+     *
+     * \param implicit_resolve
+     *     On GLES, should multisampled contents be resolved in tile memory
+     *     using EXT_multisampled_render_to_texture when it is available?
+     *     Otherwise, GLES 3 resolves them using a blit, and GLES 2 falls
+     *     back to a single sample. Ignored by the other backends.
      */
     Canvas(
         Widget *parent,
         uint8_t samples = 4,
         bool has_depth_buffer = true,
         bool has_stencil_buffer = false,
-        bool clear = true
+        bool clear = true,
+        bool implicit_resolve = true
     );
 
     /// Return the render pass associated with the canvas object
     RenderPass *render_pass() { return m_render_pass; }
 
+    /// Are multisampled contents resolved implicitly (see \ref Texture::ImplicitResolve)?
+    bool implicit_resolve() const { return m_implicit_resolve; }
+
     /// Specify whether to draw the widget border
     void set_draw_border(const bool draw_border) {
         m_draw_border = draw_border;
@@ -91,20 +104,94 @@ public:
     /// Return whether the widget border is drawn
     const Color &background_color() const;
 
+    /**
+     * \brief Render through the screen's \ref RenderGraph (the default)?
+     *
+     * Canvases that render to a texture (e.g. due to multisampling) are
+     * then drawn before the rest of the user interface and composited
+     * using NanoVG, which avoids flushing NanoVG and switching framebuffers
+     * in the middle of the frame. Other canvases always render directly.
+     */
+    void set_deferred(bool deferred) { m_deferred = deferred; }
+
+    /// Does the canvas render through the screen's \ref RenderGraph?
+    bool deferred() const { return m_deferred; }
+
+    /**
+     * \brief Render another canvas before this one (e.g. because this
+     * canvas samples its texture) when both are deferred
+     */
+    void add_dependency(Canvas *canvas);
+
+    /**
+     * \brief Keep the rendered texture and only invoke \ref
+     * draw_contents() again once the canvas is marked dirty?
+     *
+     * Until then, the cached texture is composited, which makes static
+     * contents (e.g. a 3D preview) almost free. Resizing the canvas marks
+     * it dirty, changes to the contents of canvases that it depends on
+     * (see \ref add_dependency()) don't. Only canvases that render to a
+     * texture (see \ref texture()) can be cached.
+     */
+    void set_cached(bool cached) { m_cached = cached; m_dirty = true; }
+
+    /// Does the canvas keep its rendered texture until marked dirty?
+    bool cached() const { return m_cached; }
+
+    /// Re-render the contents of a cached canvas when it is drawn next
+    void mark_dirty();
+
+    /// Will the contents of a cached canvas be re-rendered when it is drawn next?
+    bool dirty() const { return m_dirty; }
+
+    /**
+     * \brief Return the texture that holds the rendered contents, or \c
+     * nullptr if the canvas renders directly into the screen
+     *
+     * On OpenGL and GLES, multisampled canvases that are not deferred
+     * resolve straight into the screen and leave this texture untouched.
+     */
+    Texture *texture();
+
+    /// Add the render pass of a deferred canvas to a render graph (called by \ref Screen)
+    void schedule(RenderGraph *graph);
+
     /// Draw the widget contents. Override this method.
     virtual void draw_contents();
 
     /// Draw the widget
     virtual void draw(NVGcontext *ctx) override;
 
+    /// Release the NanoVG image of the texture
+    virtual ~Canvas();
+
+protected:
+    /// Compute the size and position (in pixels) of the rendered region
+    void framebuffer_region(Vector2i &size, Vector2i &offset);
+
+    /// Must \ref draw_contents() run to fill a texture of the given size?
+    bool needs_render(const Vector2i &fbsize);
+
 protected:
     ref<RenderPass> m_render_pass;
-#if defined(NANOGUI_USE_METAL)
+    /// Single-sample copy of a multisampled canvas
     ref<RenderPass> m_render_pass_resolved;
-#endif
+    std::vector<ref<RenderPass>> m_dependencies;
     bool m_draw_border;
     Color m_border_color;
     bool m_render_to_texture;
+    bool m_implicit_resolve = false;
+    bool m_deferred = true;
+    bool m_cached = false;
+    bool m_dirty = true;
+    /// Size of the texture when the cached contents were rendered
+    Vector2i m_cached_size = 0;
+    /// Was the render pass executed by the render graph this frame?
+    bool m_scheduled = false;
+    /// NanoVG image of \ref texture() and the context it belongs to
+    int m_nvg_image = 0;
+    NVGcontext *m_nvg_context = nullptr;
+    uintptr_t m_nvg_image_handle = 0;
 };
 
 NAMESPACE_END(nanogui)
@@ -160,7 +160,9 @@ class ColorWheel;
 class ColorPicker;
 class ComboBox;
 class GLFramebuffer;
+class GLState;
 class GLShader;
+class GPUTimer;
 class GridLayout;
 class GroupLayout;
 class ImagePanel;
@@ -172,9 +174,12 @@ class Object;
 class Popup;
 class PopupButton;
 class ProgressBar;
+class RenderGraph;
 class RenderPass;
 class Shader;
+class ShaderLibrary;
 class Screen;
+class StreamBuffer;
 class Serializer;
 class Slider;
 class TabWidgetBase;
@@ -182,7 +187,11 @@ class TabWidget;
 class TextBox;
 class TextArea;
 class Texture;
+class TextureAtlas;
+class TextureCache;
+class TiledImage;
 class Theme;
+class UniformBlock;
 class ToolButton;
 class VScrollPanel;
 class Widget;
@@ -336,6 +345,15 @@ extern NANOGUI_EXPORT std::string utf8(uint32_t c);
 extern NANOGUI_EXPORT std::vector<std::pair<int, std::string>>
     load_image_directory(NVGcontext *ctx, const std::string &path);
 
+/**
+ * \brief Load a directory of PNG images into the regions of an RGBA atlas
+ *
+ * Returns pairs of region identifiers and file names (without extension),
+ * which are suitable for use with an ImagePanel that draws from the atlas.
+ */
+extern NANOGUI_EXPORT std::vector<std::pair<int, std::string>>
+    load_image_directory(TextureAtlas *atlas, const std::string &path);
+
 /// Convenience function for instanting a PNG icon from the application's data segment (via bin2c)
 #define nvgImageIcon(ctx, name) nanogui::__nanogui_get_image(ctx, #name, name##_png, name##_png_size)
 /// Helper function used by nvg_image_icon
@@ -0,0 +1,202 @@
+/*
+    nanogui/glstate.h -- Shadow copy of the OpenGL state that is used to
+    skip redundant state changes
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/common.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+
+/**
+ * \class GLState glstate.h nanogui/glstate.h
+ *
+ * \brief Per-context shadow copy of the OpenGL state touched by \ref
+ * Shader and \ref RenderPass.
+ *
+ * The tracker covers the bound program, vertex array object, framebuffer,
+ * and 2D textures (per texture unit), the blending, depth test, face
+ * culling, and scissor test capabilities with their parameters, and the
+ * viewport and scissor rectangles. State changes issued through it are
+ * skipped when the shadow copy shows that they would have no effect.
+ *
+ * Entries start out as unknown, in which case the next change is always
+ * issued. Code that modifies the tracked state using direct OpenGL calls
+ * must call \ref invalidate() afterwards. \ref Screen does this after
+ * every NanoVG flush.
+ */
+class NANOGUI_EXPORT GLState {
+public:
+    /// Groups of state entries (see \ref invalidate())
+    enum Category : uint32_t {
+        Program      = 0x001,
+        VertexArray  = 0x002,
+        Textures     = 0x004,
+        Framebuffer  = 0x008,
+        Capabilities = 0x010,
+        Blend        = 0x020,
+        Depth        = 0x040,
+        Cull         = 0x080,
+        Viewport     = 0x100,
+        Scissor      = 0x200,
+        All          = 0x3FF,
+
+        /// Entries that the NanoVG renderer changes while flushing
+        NanoVG = Program | VertexArray | Textures | Capabilities | Blend | Cull
+    };
+
+    /// Capabilities that can be toggled using \ref set_enabled()
+    enum class Capability : uint32_t {
+        Blend,
+        DepthTest,
+        CullFace,
+        ScissorTest,
+        /// Desktop OpenGL only
+        ProgramPointSize,
+        Count
+    };
+
+    /// Number of texture units whose 2D texture binding is tracked
+    static constexpr size_t TextureUnits = 16;
+
+    /// Shadow copy of the tracked state (-1 denotes an unknown entry)
+    struct State {
+        int64_t program = -1;
+        int64_t vertex_array = -1;
+        int64_t framebuffer = -1;
+        int64_t active_texture = -1;
+        int64_t textures[TextureUnits];
+        int8_t enabled[(size_t) Capability::Count];
+        int64_t blend_src = -1, blend_dst = -1;
+        int64_t depth_func = -1;
+        int8_t depth_mask = -1;
+        int64_t cull_face = -1;
+        int viewport[4] = { -1, -1, -1, -1 };
+        int scissor[4] = { -1, -1, -1, -1 };
+
+        State();
+    };
+
+    /// Number of state changes that were issued and skipped
+    struct Stats {
+        size_t issued = 0;
+        size_t elided = 0;
+    };
+
+    /// Return the tracker of the OpenGL context that is current on this thread
+    static GLState &current();
+
+    /// Discard the tracker of a GLFW window's context that is about to be destroyed
+    static void release(void *glfw_window);
+
+    /// Mark the given categories of entries as unknown
+    void invalidate(uint32_t categories = All);
+
+    /// Return the shadow state, a copy of which can be passed to \ref restore()
+    const State &state() const { return m_state; }
+
+    /**
+     * \brief Reapply a state returned by \ref state()
+     *
+     * Entries that were unknown when the state was recorded are set to the
+     * OpenGL defaults (capabilities disabled, no program or framebuffer
+     * bound, <tt>glBlendFunc(GL_ONE, GL_ZERO)</tt>, \c GL_LESS, depth
+     * writes enabled, \c GL_BACK). Texture bindings are only restored when
+     * known, and viewport and scissor box should be made known beforehand
+     * using \ref query_rects().
+     */
+    void restore(const State &state);
+
+    /// Query the viewport and scissor box from OpenGL if they are unknown
+    void query_rects();
+
+    /// Bind a program (\c glUseProgram)
+    void use_program(uint32_t program);
+
+    /// Bind a vertex array object (\c glBindVertexArray, desktop OpenGL only)
+    void bind_vertex_array(uint32_t vertex_array);
+
+    /// Bind a framebuffer for both drawing and reading
+    void bind_framebuffer(uint32_t framebuffer);
+
+    /**
+     * \brief Bind a texture to the given texture unit
+     *
+     * Only \c GL_TEXTURE_2D bindings are tracked, other targets are always
+     * bound. The active texture unit is only changed when a binding has
+     * to be issued.
+     */
+    void bind_texture(uint32_t unit, uint32_t target, uint32_t texture);
+
+    /// Enable or disable a capability (\c glEnable / \c glDisable)
+    void set_enabled(Capability capability, bool value);
+
+    /// Set the blending factors (\c glBlendFunc)
+    void blend_func(uint32_t src, uint32_t dst);
+
+    /// Set the depth comparison function (\c glDepthFunc)
+    void depth_func(uint32_t func);
+
+    /// Enable or disable depth writes (\c glDepthMask)
+    void depth_mask(bool value);
+
+    /// Select the culled faces (\c glCullFace)
+    void cull_face(uint32_t mode);
+
+    /// Set the viewport rectangle (\c glViewport)
+    void viewport(int x, int y, int width, int height);
+
+    /// Set the scissor rectangle (\c glScissor)
+    void scissor(int x, int y, int width, int height);
+
+    /// Forget bindings of a texture that is about to be deleted
+    void texture_deleted(uint32_t texture);
+
+    /// Forget the binding of a program that is about to be deleted
+    void program_deleted(uint32_t program);
+
+    /// Forget the binding of a vertex array object that is about to be deleted
+    void vertex_array_deleted(uint32_t vertex_array);
+
+    /// Forget the binding of a framebuffer that is about to be deleted
+    void framebuffer_deleted(uint32_t framebuffer);
+
+    /// Return the number of issued and skipped state changes of the current frame
+    const Stats &stats() const { return m_stats; }
+
+    /// Return the number of issued and skipped state changes of the previous frame
+    const Stats &last_frame_stats() const { return m_last_frame_stats; }
+
+    /// Finish the current frame's statistics (called by \ref Screen::draw_setup())
+    void next_frame();
+
+protected:
+    /// Record whether a state change was skipped, returns \c true if it must be issued
+    bool track(bool redundant) {
+        if (redundant)
+            m_stats.elided++;
+        else
+            m_stats.issued++;
+        return !redundant;
+    }
+
+protected:
+    State m_state;
+    Stats m_stats;
+    Stats m_last_frame_stats;
+};
+
+#endif
+
+NAMESPACE_END(nanogui)
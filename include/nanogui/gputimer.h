@@ -0,0 +1,167 @@
+/*
+    nanogui/gputimer.h -- Asynchronous measurement of the GPU time
+    spent in a render pass
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/object.h>
+#include <string>
+#include <vector>
+#if defined(NANOGUI_USE_METAL)
+#  include <mutex>
+#endif
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class GPUTimer gputimer.h nanogui/gputimer.h
+ *
+ * \brief Measures the GPU time spent between two points of the command
+ * stream and keeps rolling statistics over the most recent samples.
+ *
+ * Attach a timer to a render pass using \ref RenderPass::set_gpu_timer() to
+ * measure the commands issued between \ref RenderPass::begin() and \ref
+ * RenderPass::end(), e.g. those of \ref Canvas::draw_contents().
+ *
+ * Results never stall the CPU: they are collected a few frames later,
+ * once the GPU has reached the measured commands.
+ *
+ * - On OpenGL, a pair of \c GL_TIMESTAMP queries (OpenGL 3.3 or
+ *   ARB_timer_query) brackets the measured commands. Pairs that are still
+ *   in flight are polled once per frame (see \ref poll_all()) using \c
+ *   GL_QUERY_RESULT_AVAILABLE. Timestamps (rather than \c
+ *   GL_TIME_ELAPSED) allow measurements to nest.
+ * - On GLES, the same is done using EXT_disjoint_timer_query. Results of
+ *   intervals that the driver reports as disjoint (e.g. due to a change of
+ *   the GPU clock) are dropped.
+ * - On Metal, the GPU start and end times of the render pass's command
+ *   buffer are recorded by its completion handler (macOS 10.15+).
+ *
+ * Timers register themselves in a global list (see \ref timers()), which
+ * the overlay of \ref Screen::set_gpu_timer_overlay() displays.
+ */
+class NANOGUI_EXPORT GPUTimer : public Object {
+public:
+    /// Rolling statistics in milliseconds
+    struct Stats {
+        /// Most recent sample
+        float last = 0.f;
+        float average = 0.f;
+        float minimum = 0.f;
+        float maximum = 0.f;
+        /// Number of samples that the statistics are based on
+        size_t samples = 0;
+    };
+
+    /**
+     * \brief Create a timer
+     *
+     * \param name
+     *     Label shown by the overlay of \ref Screen
+     *
+     * \param window
+     *     Number of recent samples that the statistics are computed over
+     */
+    GPUTimer(const std::string &name = "", size_t window = 60);
+
+    /// Return the label of the timer
+    const std::string &name() const { return m_name; }
+
+    /// Set the label of the timer
+    void set_name(const std::string &name) { m_name = name; }
+
+    /// Return the number of samples that the statistics are computed over
+    size_t window() const { return m_samples.size(); }
+
+    /// Return the rolling statistics
+    Stats stats() const;
+
+    /// Discard all samples
+    void reset();
+
+    /// Can GPU times be measured on the current context? (cached per context)
+    static bool supported();
+
+    /**
+     * \brief Collect the finished measurements of all timers that belong
+     * to the current context, without waiting
+     *
+     * \ref Screen calls this once per frame. Applications that drive
+     * timers without a \ref Screen should call it once per frame as well.
+     * Does nothing on Metal, where results arrive via completion handlers.
+     */
+    static void poll_all();
+
+    /// Return all timers that currently exist
+    static const std::vector<GPUTimer *> &timers();
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    /**
+     * \brief Start a measurement
+     *
+     * The measurement is skipped if all query pairs are still in flight
+     * after collecting the available results.
+     */
+    void begin();
+
+    /// Finish the measurement started by \ref begin()
+    void end();
+#endif
+
+    /// Add a sample in milliseconds (thread-safe on Metal)
+    void add_sample(float ms);
+
+    /// Release all resources
+    virtual ~GPUTimer();
+
+protected:
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    /**
+     * \brief Collect the results of finished measurements without waiting
+     *
+     * \param disjoint
+     *     Did the GPU report a disjoint event since the last poll? (GLES)
+     */
+    void poll(bool disjoint);
+
+    /// Read and reset the disjoint flag of EXT_disjoint_timer_query (GLES)
+    static bool query_disjoint();
+
+    /// Delete the query objects
+    void release_queries();
+
+    /// Number of measurements that can be in flight
+    static constexpr size_t QueryCount = 4;
+#endif
+
+protected:
+    std::string m_name;
+    /// Ring buffer of recent samples
+    std::vector<float> m_samples;
+    size_t m_sample_count = 0;
+    size_t m_sample_next = 0;
+    Stats m_stats;
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    /// Start and end query of each measurement
+    uint32_t m_queries[2 * QueryCount] { };
+    bool m_pending[QueryCount] { };
+    /// Slot of the next measurement, and of the oldest one in flight
+    size_t m_head = 0, m_tail = 0;
+    bool m_active = false;
+    /// GLFW window whose context owns the queries
+    void *m_context = nullptr;
+#elif defined(NANOGUI_USE_METAL)
+    mutable std::mutex m_mutex;
+#endif
+};
+
+NAMESPACE_END(nanogui)
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <nanogui/widget.h>
+#include <nanogui/textureatlas.h>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -21,6 +22,10 @@ NAMESPACE_BEGIN(nanogui)
  * \class ImagePanel imagepanel.h nanogui/imagepanel.h
  *
  * \brief Image panel widget which shows a number of square-shaped icons.
+ *
+ * The images are NanoVG image handles by default. When a \ref TextureAtlas
+ * is set, they instead refer to regions of the atlas, which allows drawing
+ * all thumbnails without switching between textures.
  */
 class NANOGUI_EXPORT ImagePanel : public Widget {
 public:
@@ -31,6 +36,16 @@ public:
     void set_images(const Images &data) { m_images = data; }
     const Images& images() const { return m_images; }
 
+    /**
+     * \brief Draw the images from regions of an atlas (see \ref load_image_directory())
+     *
+     * Images that the atlas has since evicted are skipped; re-add them and
+     * update the image list to show them again.
+     */
+    void set_atlas(TextureAtlas *atlas) { m_atlas = atlas; }
+    TextureAtlas *atlas() { return m_atlas.get(); }
+    const TextureAtlas *atlas() const { return m_atlas.get(); }
+
     const std::function<void(int)> &callback() const { return m_callback; }
     void set_callback(const std::function<void(int)> &callback) { m_callback = callback; }
 
@@ -46,6 +61,7 @@ protected:
     int index_for_position(const Vector2i &p) const;
 protected:
     Images m_images;
+    ref<TextureAtlas> m_atlas;
     std::function<void(int)> m_callback;
     int m_thumb_size;
     int m_spacing;
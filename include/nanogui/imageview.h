@@ -13,6 +13,7 @@
 #pragma once
 
 #include <nanogui/canvas.h>
+#include <nanogui/tiledimage.h>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -21,6 +22,10 @@ NAMESPACE_BEGIN(nanogui)
  *
  * \brief A widget for displaying, panning, and zooming images. Numerical RGBA
  * pixel information is shown at large magnifications.
+ *
+ * The image is either a single \ref Texture or a \ref TiledImage, whose
+ * tiles are paged in on demand. The latter supports images exceeding the
+ * maximum texture size or the available GPU memory.
  */
 class NANOGUI_EXPORT ImageView : public Canvas {
 public:
@@ -36,6 +41,16 @@ public:
     /// Set the currently active image
     void set_image(Texture *image);
 
+    /// Return the currently active tiled image
+    TiledImage *tiled_image() { return m_tiled_image; }
+    /// Return the currently active tiled image (const version)
+    const TiledImage *tiled_image() const { return m_tiled_image.get(); }
+    /// Display a tiled image instead of a texture
+    void set_tiled_image(TiledImage *image);
+
+    /// Return the size of the active (regular or tiled) image
+    Vector2i image_size() const;
+
     /// Center the image on the screen
     void center();
 
@@ -71,9 +86,16 @@ public:
     virtual void draw(NVGcontext *ctx) override;
     virtual void draw_contents() override;
 
+protected:
+    /// Finish setting up the (asynchronously compiled) image shader, returns \c false if it is not ready yet
+    bool prepare_image_shader();
+
 protected:
     nanogui::ref<Shader> m_image_shader;
+    bool m_image_shader_ready = false;
     nanogui::ref<Texture> m_image;
+    nanogui::ref<Shader> m_tiled_shader;
+    nanogui::ref<TiledImage> m_tiled_image;
     float m_scale = 0;
     Vector2f m_offset = 0;
     bool m_draw_image_border;
@@ -0,0 +1,67 @@
+/*
+    nanogui/mipmap.h -- CPU implementation of mip map filters
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/texture.h>
+#include <nanogui/traits.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+/// Return the number of levels of a full mip chain (down to 1x1) for the given size
+extern NANOGUI_EXPORT uint32_t mipmap_level_count(const Vector2i &size);
+
+/// Return the size of the given mip level
+extern NANOGUI_EXPORT Vector2i mipmap_level_size(const Vector2i &size, uint32_t level);
+
+/**
+ * \brief Compute a region of the next mip level of an image
+ *
+ * \param src
+ *     Densely packed source level with interleaved channels
+ *
+ * \param src_size
+ *     Size of the source level
+ *
+ * \param dst
+ *     Densely packed destination level of size <tt>mipmap_level_size(src_size, 1)</tt>.
+ *     Only the pixels within the specified region are written.
+ *
+ * \param dst_origin
+ *     Upper left corner of the destination region
+ *
+ * \param dst_size
+ *     Size of the destination region
+ *
+ * \param channels
+ *     Number of channels per pixel. With 2 or 4 channels, the last one
+ *     is treated as alpha.
+ *
+ * \param type
+ *     Component type (UInt8, UInt16, Float16, or Float32)
+ *
+ * \param filter
+ *     Either \ref Texture::MipmapFilter::Box or \ref Texture::MipmapFilter::Kaiser
+ *
+ * \param srgb
+ *     Convert color channels from sRGB to linear space before filtering
+ *     (and back afterwards)
+ *
+ * The filters run on SSE/AVX or NEON units when the compiler targets them.
+ */
+extern NANOGUI_EXPORT void mipmap_downsample(const void *src, const Vector2i &src_size,
+                                             void *dst, const Vector2i &dst_origin,
+                                             const Vector2i &dst_size, size_t channels,
+                                             VariableType type, Texture::MipmapFilter filter,
+                                             bool srgb);
+
+NAMESPACE_END(nanogui)
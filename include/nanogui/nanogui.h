@@ -38,7 +38,17 @@
 #include <nanogui/formhelper.h>
 #include <nanogui/tabwidget.h>
 #include <nanogui/texture.h>
+#include <nanogui/texturecache.h>
+#include <nanogui/textureatlas.h>
+#include <nanogui/mipmap.h>
 #include <nanogui/shader.h>
+#include <nanogui/shaderlibrary.h>
+#include <nanogui/uniformblock.h>
+#include <nanogui/streambuffer.h>
+#include <nanogui/glstate.h>
+#include <nanogui/gputimer.h>
 #include <nanogui/renderpass.h>
+#include <nanogui/rendergraph.h>
 #include <nanogui/canvas.h>
+#include <nanogui/tiledimage.h>
 #include <nanogui/imageview.h>
@@ -0,0 +1,101 @@
+/*
+    nanogui/rendergraph.h -- Frame-level scheduling of offscreen
+    render passes
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/renderpass.h>
+#include <functional>
+#include <vector>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class RenderGraph rendergraph.h nanogui/rendergraph.h
+ *
+ * \brief Collects the offscreen render passes of a frame and executes them
+ * in dependency order before the user interface is drawn.
+ *
+ * \ref Screen owns one graph. Before NanoVG starts drawing a frame, every
+ * visible \ref Canvas that renders to a texture adds its pass, and the
+ * screen calls \ref execute(). The canvases then composite their textures
+ * as part of the regular NanoVG traversal. Compared to rendering each
+ * canvas in the middle of the traversal, this avoids flushing NanoVG and
+ * switching framebuffers once per canvas.
+ *
+ * Callbacks that are added for the same render pass are merged into a
+ * single \ref RenderPass::begin() / \ref RenderPass::end() pair. Passes
+ * without dependencies between them run in the order in which they were
+ * added. The graph is cleared after every execution.
+ */
+class NANOGUI_EXPORT RenderGraph : public Object {
+public:
+    /// Statistics of the most recent \ref execute() call
+    struct Stats {
+        /// Number of executed render passes
+        size_t passes = 0;
+        /// Number of callbacks that shared a render pass with an earlier one
+        size_t merged = 0;
+    };
+
+    /// Create an empty graph
+    RenderGraph() = default;
+
+    /**
+     * \brief Schedule drawing code that renders into the given pass
+     *
+     * The callback is invoked between \ref RenderPass::begin() and \ref
+     * RenderPass::end() during the next \ref execute().
+     */
+    void add_pass(RenderPass *pass, const std::function<void()> &callback);
+
+    /**
+     * \brief Require \c dependency to be executed before \c pass (e.g.
+     * because \c pass samples a texture that \c dependency renders)
+     *
+     * Dependencies on passes that are not part of the graph are ignored.
+     */
+    void add_dependency(RenderPass *pass, RenderPass *dependency);
+
+    /// Return the number of scheduled render passes
+    size_t size() const { return m_nodes.size(); }
+
+    /**
+     * \brief Execute all scheduled passes and clear the graph
+     *
+     * Throws an exception if the dependencies contain a cycle.
+     */
+    void execute();
+
+    /// Discard all scheduled passes
+    void clear();
+
+    /// Return the statistics of the most recent \ref execute() call
+    const Stats &last_stats() const { return m_last_stats; }
+
+protected:
+    struct Node {
+        ref<RenderPass> pass;
+        std::vector<std::function<void()>> callbacks;
+        std::vector<RenderPass *> dependencies;
+    };
+
+    /// Return the index of the node of a pass, creating it if needed
+    size_t node(RenderPass *pass);
+
+protected:
+    std::vector<Node> m_nodes;
+    size_t m_merged = 0;
+    Stats m_last_stats;
+};
+
+NAMESPACE_END(nanogui)
@@ -18,6 +18,8 @@
 
 #include <nanogui/object.h>
 #include <nanogui/vector.h>
+#include <nanogui/glstate.h>
+#include <nanogui/gputimer.h>
 #include <unordered_map>
 
 NAMESPACE_BEGIN(nanogui)
@@ -43,6 +45,27 @@ public:
         Back
     };
 
+    /// Action applied to an attachment when the render pass begins
+    enum class LoadAction {
+        /// Clear to the clear color, depth, or stencil value
+        Clear,
+        /// Preserve the previous contents
+        Load,
+        /// The previous contents are not needed and become undefined
+        DontCare
+    };
+
+    /// Action applied to an attachment when the render pass ends
+    enum class StoreAction {
+        /// Preserve the rendered contents
+        Store,
+        /**
+         * The contents are not needed after the render pass (e.g. a depth
+         * buffer), which lets tile-based GPUs skip writing them to memory
+         */
+        Discard
+    };
+
     /**
      * \brief Create a new render pass for rendering to a specific
      * set of targets
@@ -70,7 +93,9 @@ public:
      *     framebuffers for display.
      *
      * \param clear
-     *     Should \ref enter() begin by clearing all buffers?
+     *     Should \ref enter() begin by clearing all buffers? This sets
+     *     the initial load action of all attachments to \ref
+     *     LoadAction::Clear or \ref LoadAction::Load.
      */
     RenderPass(const std::vector<Object *> &color_targets,
                Object *depth_target = nullptr,
@@ -98,6 +123,9 @@ public:
     /// Finish the render pass
     void end();
 
+    /// Is the render pass between \ref begin() and \ref end()?
+    bool active() const { return m_active; }
+
     /// Return the clear color for a given color attachment
     const Color &clear_color(size_t index) const { return m_clear_color.at(index); }
 
@@ -116,6 +144,36 @@ public:
     /// Set the clear stencil for the stencil attachment
     void set_clear_stencil(uint8_t stencil);
 
+    /**
+     * \brief Return the action applied to an attachment when the render
+     * pass begins
+     *
+     * Attachments are indexed as in \ref targets(): 0 refers to the depth
+     * target, 1 to the stencil target, and 2 onwards to the color targets.
+     */
+    LoadAction load_action(size_t index) const { return m_load_action.at(index); }
+
+    /// Set the action applied to an attachment when the render pass begins
+    void set_load_action(size_t index, LoadAction action) {
+        m_load_action.at(index) = action;
+    }
+
+    /**
+     * \brief Return the action applied to an attachment when the render
+     * pass ends
+     *
+     * Discarded attachments are invalidated using \c
+     * glInvalidateFramebuffer() (OpenGL 4.3 and GLES 3) or stored using
+     * \c MTLStoreActionDontCare (Metal). They are also skipped by \ref
+     * blit_to().
+     */
+    StoreAction store_action(size_t index) const { return m_store_action.at(index); }
+
+    /// Set the action applied to an attachment when the render pass ends
+    void set_store_action(size_t index, StoreAction action) {
+        m_store_action.at(index) = action;
+    }
+
     /// Specify the depth test and depth write mask of this render pass
     void set_depth_test(DepthTest depth_test, bool depth_write);
 
@@ -136,6 +194,21 @@ public:
     /// Return the culling mode associated with the render pass
     CullMode cull_mode() const { return m_cull_mode; }
 
+    /**
+     * \brief Measure the GPU time spent between \ref begin() and \ref
+     * end() using the given timer (or stop measuring if \c nullptr)
+     */
+    void set_gpu_timer(GPUTimer *timer) { m_gpu_timer = timer; }
+
+    /// Return the timer that measures this render pass (if any)
+    GPUTimer *gpu_timer() { return m_gpu_timer; }
+
+    /// Change the target that the render pass blits to when it ends (see \ref RenderPass())
+    void set_blit_target(Object *blit_target) { m_blit_target = blit_target; }
+
+    /// Return the target that the render pass blits to when it ends (if any)
+    Object *blit_target() { return m_blit_target.get(); }
+
     /**
      * \brief Return the set of all render targets (including depth + stencil)
      * associated with this render pass
@@ -163,11 +236,22 @@ public:
     void *command_buffer() const { return m_command_buffer; }
 #endif
 
+protected:
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    /**
+     * \brief Invalidate the attachments that are loaded using \ref
+     * LoadAction::DontCare (\c begin=true) or stored using \ref
+     * StoreAction::Discard (\c begin=false)
+     */
+    void invalidate_attachments(bool begin);
+#endif
+
 protected:
     std::vector<Object *> m_targets;
     std::vector<bool> m_targets_ref;
     std::vector<Color> m_clear_color;
-    bool m_clear;
+    std::vector<LoadAction> m_load_action;
+    std::vector<StoreAction> m_store_action;
     uint8_t m_clear_stencil;
     float m_clear_depth;
     Vector2i m_viewport_offset;
@@ -177,15 +261,12 @@ protected:
     bool m_depth_write;
     CullMode m_cull_mode;
     ref<Object> m_blit_target;
+    ref<GPUTimer> m_gpu_timer;
     bool m_active;
 #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
     uint32_t m_framebuffer_handle;
-    int m_viewport_backup[4], m_scissor_backup[4];
-    bool m_depth_test_backup;
-    bool m_depth_write_backup;
-    bool m_scissor_test_backup;
-    bool m_cull_face_backup;
-    bool m_blend_backup;
+    /// State that was set up before \ref begin(), restored by \ref end()
+    GLState::State m_state_backup;
 #elif defined(NANOGUI_USE_METAL)
     void *m_command_buffer;
     void *m_command_encoder;
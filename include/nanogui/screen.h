@@ -229,6 +229,23 @@ public:
     /// Is a tooltip currently fading in?
     bool tooltip_fade_in_progress() const;
 
+    /**
+     * \brief Show the statistics of all \ref GPUTimer instances in the
+     * top left corner of the screen
+     *
+     * The overlay is updated whenever the screen is redrawn.
+     */
+    void set_gpu_timer_overlay(bool value) { m_gpu_timer_overlay = value; m_redraw = true; }
+
+    /// Are the statistics of all \ref GPUTimer instances shown?
+    bool gpu_timer_overlay() const { return m_gpu_timer_overlay; }
+
+    /**
+     * \brief Return the graph that executes the render passes of deferred
+     * canvases (see \ref Canvas::set_deferred()) before the widgets are drawn
+     */
+    RenderGraph *render_graph() { return m_render_graph; }
+
     using Widget::perform_layout;
 
     /// Compute the layout of all widgets
@@ -271,6 +288,7 @@ public:
     void center_window(Window *window);
     void move_window_to_front(Window *window);
     void draw_widgets();
+    void draw_gpu_timer_overlay();
 
 protected:
     GLFWwindow *m_glfw_window = nullptr;
@@ -294,6 +312,8 @@ protected:
     bool m_stencil_buffer;
     bool m_float_buffer;
     bool m_redraw;
+    bool m_gpu_timer_overlay = false;
+    ref<RenderGraph> m_render_graph;
     std::function<void(Vector2i)> m_resize_callback;
 #if defined(NANOGUI_USE_METAL)
     void *m_metal_texture = nullptr;
@@ -19,6 +19,7 @@
 #include <nanogui/object.h>
 #include <nanogui/traits.h>
 #include <unordered_map>
+#include <vector>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -33,6 +34,57 @@ public:
         TriangleStrip
     };
 
+    /// Expected update frequency of a vertex or index buffer
+    enum class BufferUsage {
+        Static,  // Uploaded once and drawn many times
+        Dynamic, // Updated repeatedly and drawn many times
+        Stream   // Updated before (almost) every draw call
+    };
+
+    /// Description of an attribute within an interleaved vertex buffer
+    struct VertexAttribute {
+        /// Name of the vertex attribute in the shader
+        std::string name;
+        /// Byte offset of the attribute within a vertex
+        size_t offset = 0;
+        /// Type of the attribute's components
+        VariableType type = VariableType::Float32;
+        /// Number of components (must match the declaration in the shader)
+        size_t components = 1;
+        /// Map integer components to [0, 1] (unsigned) or [-1, 1] (signed)?
+        bool normalized = false;
+
+        VertexAttribute() = default;
+        VertexAttribute(const std::string &name, size_t offset, VariableType type,
+                        size_t components, bool normalized = false)
+            : name(name), offset(offset), type(type), components(components),
+              normalized(normalized) { }
+
+        /**
+         * \brief Describe a member of a vertex struct, e.g.
+         * <tt>VertexAttribute::member("position", &Vertex::position)</tt>
+         *
+         * The member must be a scalar or a nanogui array (e.g. \ref Vector3f),
+         * and the struct must be default-constructible.
+         */
+        template <typename T, typename M>
+        static VertexAttribute member(const std::string &name, M T::*ptr,
+                                      bool normalized = false) {
+            static_assert(std::is_default_constructible_v<T>,
+                          "VertexAttribute::member(): the vertex type must be "
+                          "default-constructible!");
+            const T instance{};
+            size_t offset = (size_t) (reinterpret_cast<const uint8_t *>(&(instance.*ptr)) -
+                                      reinterpret_cast<const uint8_t *>(&instance));
+
+            if constexpr (std::is_scalar_v<M>)
+                return VertexAttribute(name, offset, get_type<M>(), 1, normalized);
+            else
+                return VertexAttribute(name, offset, get_type<typename M::Value>(),
+                                       M::Size, normalized);
+        }
+    };
+
     /// Alpha blending mode
     enum class BlendMode {
         None,
@@ -54,12 +106,25 @@ public:
      *
      * \param fragment_shader
      *     The source of the fragment shader as a string.
+     *
+     * \param blend_mode
+     *     The blending mode used when drawing with this shader.
+     *
+     * \param asynchronous
+     *     Return once compilation has been submitted instead of waiting for
+     *     the result (OpenGL/GLES only). Drivers that implement
+     *     <tt>KHR_parallel_shader_compile</tt> then compile in the
+     *     background, and \ref ready() reports when the shader can be used
+     *     without blocking. The first call that needs the parameters of the
+     *     shader (e.g. \ref set_buffer() or \ref begin()) waits for the
+     *     compilation, and compilation errors are reported at this point.
      */
     Shader(RenderPass *render_pass,
            const std::string &name,
            const std::string &vertex_shader,
            const std::string &fragment_shader,
-           BlendMode blend_mode = BlendMode::None);
+           BlendMode blend_mode = BlendMode::None,
+           bool asynchronous = false);
 
     /// Release all resources
     virtual ~Shader();
@@ -73,6 +138,27 @@ public:
     /// Return the blending mode of this shader
     BlendMode blend_mode() const { return m_blend_mode; }
 
+    /**
+     * \brief Can the shader be used without waiting for its compilation?
+     *
+     * Always \c true unless the shader was created asynchronously and the
+     * driver is still compiling it in the background.
+     */
+    bool ready();
+
+    /// Handle to a named shader parameter, see \ref parameter()
+    class Parameter;
+
+    /**
+     * \brief Resolve a named shader parameter into a handle
+     *
+     * The handle can be passed to \ref set_buffer(), \ref set_uniform() and
+     * \ref set_texture() in place of the name, which avoids hashing and
+     * comparing the name on every call. It remains valid for the lifetime
+     * of the shader.
+     */
+    Parameter parameter(const std::string &name);
+
     /**
      * \brief Upload a buffer (e.g. vertex positions) that will be associated
      * with a named shader parameter.
@@ -91,11 +177,95 @@ public:
         set_buffer(name, type, shape.end() - shape.begin(), shape.begin(), data);
     }
 
+    /// Upload a buffer associated with a previously resolved shader parameter
+    void set_buffer(const Parameter &parameter, VariableType type, size_t ndim,
+                    const size_t *shape, const void *data);
+
+    void set_buffer(const Parameter &parameter, VariableType type,
+                    std::initializer_list<size_t> shape, const void *data) {
+        set_buffer(parameter, type, shape.end() - shape.begin(), shape.begin(), data);
+    }
+
+    /**
+     * \brief Upload a buffer that provides several vertex attributes in
+     * an interleaved (array of structs) layout
+     *
+     * \param layout
+     *     Location and type of each attribute within a vertex
+     *
+     * \param stride
+     *     Size of a vertex in bytes
+     *
+     * \param count
+     *     Number of vertices
+     *
+     * All attributes of the layout are sourced from a single buffer.
+     * Uploading again with the same attributes reuses its storage.
+     */
+    void set_interleaved_buffer(const std::vector<VertexAttribute> &layout,
+                                size_t stride, size_t count, const void *data);
+
+    /// Upload an array of vertex structs (see \ref VertexAttribute::member())
+    template <typename T>
+    void set_interleaved_buffer(const std::vector<VertexAttribute> &layout,
+                                const std::vector<T> &vertices) {
+        set_interleaved_buffer(layout, sizeof(T), vertices.size(), vertices.data());
+    }
+
+    /**
+     * \brief Overwrite a range of entries of a vertex or index buffer that
+     * was previously uploaded using \ref set_buffer().
+     *
+     * \c offset and <tt>shape[0]</tt> specify the range of entries (e.g.
+     * vertices) along the first dimension; the remaining dimensions and
+     * the type must match the existing buffer. Only the given range is
+     * transferred, and the GPU storage is not reallocated. The exception
+     * is Metal while the render pass is active: draw calls encoded before
+     * the update then keep reading the previous contents from the old
+     * storage.
+     */
+    void update_buffer(const std::string &name, size_t offset, VariableType type,
+                       size_t ndim, const size_t *shape, const void *data);
+
+    /// Overwrite a range of entries of a buffer associated with a previously resolved parameter
+    void update_buffer(const Parameter &parameter, size_t offset, VariableType type,
+                       size_t ndim, const size_t *shape, const void *data);
+
+    /**
+     * \brief Specify how often a vertex or index buffer will be updated
+     *
+     * The hint is passed to the graphics API when storage is allocated for
+     * the buffer (the default is \ref BufferUsage::Dynamic). Setting it
+     * causes the next \ref set_buffer() call to reallocate the storage.
+     */
+    void set_buffer_usage(const std::string &name, BufferUsage usage);
+
+    /// Specify how often a buffer associated with a previously resolved parameter will be updated
+    void set_buffer_usage(const Parameter &parameter, BufferUsage usage);
+
+    /**
+     * \brief Set the instance divisor of a vertex attribute
+     *
+     * With a divisor of zero (the default), the attribute advances once
+     * per vertex. Otherwise, it advances once per \c divisor instances
+     * drawn by \ref draw_array_instanced(). Not supported on OpenGL ES 2
+     * and Metal (Metal shaders should index per-instance data using
+     * <tt>[[instance_id]]</tt> instead).
+     */
+    void set_buffer_divisor(const std::string &name, uint32_t divisor);
+
+    /// Set the instance divisor of a vertex attribute associated with a previously resolved parameter
+    void set_buffer_divisor(const Parameter &parameter, uint32_t divisor);
+
     /**
      * \brief Upload a uniform variable (e.g. a vector or matrix) that will be
      * associated with a named shader parameter.
      */
     template <typename Array> void set_uniform(const std::string &name,
+                                               const Array &value);
+
+    /// Upload a uniform variable associated with a previously resolved shader parameter
+    template <typename Array> void set_uniform(const Parameter &parameter,
                                                const Array &value) {
         size_t shape[3] = { 1, 1, 1 };
         size_t ndim = (size_t) -1;
@@ -138,7 +308,7 @@ public:
         if (ndim == (size_t) -1)
             throw std::runtime_error("Shader::set_uniform(): invalid input array dimension!");
 
-        set_buffer(name, vtype, ndim, shape, data);
+        set_buffer(parameter, vtype, ndim, shape, data);
     }
 
     /**
@@ -148,6 +318,41 @@ public:
      */
     void set_texture(const std::string &name, Texture *texture);
 
+    /// Associate a texture with a previously resolved shader parameter
+    void set_texture(const Parameter &parameter, Texture *texture);
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    /**
+     * \brief Source a vertex attribute from a range of a \ref StreamBuffer
+     *
+     * \param offset
+     *     Offset of the data within the stream buffer in bytes (as returned
+     *     by \ref StreamBuffer::write())
+     *
+     * The remaining parameters describe the data as in \ref set_buffer().
+     * Calling \ref set_buffer() afterwards switches the attribute back to
+     * storage owned by the shader.
+     */
+    void set_stream_buffer(const std::string &name, StreamBuffer *buffer, size_t offset,
+                           VariableType type, size_t ndim, const size_t *shape);
+
+    /// Source a vertex attribute associated with a previously resolved parameter from a \ref StreamBuffer
+    void set_stream_buffer(const Parameter &parameter, StreamBuffer *buffer, size_t offset,
+                           VariableType type, size_t ndim, const size_t *shape);
+
+    /**
+     * \brief Associate a \ref UniformBlock with a uniform block declared by
+     * the shader
+     *
+     * The same block may be shared by many shaders. Its contents are
+     * uploaded (if modified) when any of them is activated via \ref begin().
+     */
+    void set_uniform_block(const std::string &name, UniformBlock *block);
+
+    /// Associate a \ref UniformBlock with a previously resolved shader parameter
+    void set_uniform_block(const Parameter &parameter, UniformBlock *block);
+#endif
+
     /**
      * \brief Begin drawing using this shader
      *
@@ -187,6 +392,22 @@ public:
                     size_t offset, size_t count,
                     bool indexed = false);
 
+    /**
+     * \brief Render several instances of geometry arrays, either directly
+     * or using an index array.
+     *
+     * Takes the same parameters as \ref draw_array(). Vertex attributes
+     * with a nonzero divisor (see \ref set_buffer_divisor()) advance per
+     * instance. Requires OpenGL 3.3, OpenGL ES 3, or Metal.
+     *
+     * \param instances
+     *     Number of instances to render
+     */
+    void draw_array_instanced(PrimitiveType primitive_type,
+                              size_t offset, size_t count,
+                              size_t instances,
+                              bool indexed = false);
+
 #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
     uint32_t shader_handle() const { return m_shader_handle; }
 #elif defined(NANOGUI_USE_METAL)
@@ -197,7 +418,33 @@ public:
     uint32_t vertex_array_handle() const { return m_vertex_array_handle; }
 #endif
 
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    /**
+     * \brief Cache linked programs in the given directory (which must exist)
+     *
+     * Shaders created afterwards first try to load a program binary
+     * (<tt>glProgramBinary()</tt>) that matches their source code and the
+     * OpenGL vendor, renderer, and version strings. When no binary is
+     * found or the driver rejects it, the shader is compiled from source
+     * and the resulting binary is written to the cache. An empty path
+     * (the default) disables the cache. Program binaries require OpenGL
+     * 4.1 or OpenGL ES 3, the setting has no effect otherwise.
+     */
+    static void set_binary_cache_directory(const std::string &path);
+
+    /// Return the directory used to cache linked programs (empty if disabled)
+    static const std::string &binary_cache_directory();
+
+    /// Was the program of this shader loaded from the binary cache?
+    bool loaded_from_cache() const { return m_loaded_from_cache; }
+#endif
+
 protected:
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    /// Wait for the program to link and look up its parameters (if not done yet)
+    void finish_linking();
+#endif
+
     enum BufferType {
         Unknown = 0,
         VertexBuffer,
@@ -208,6 +455,7 @@ protected:
         FragmentSampler,
         UniformBuffer,
         IndexBuffer,
+        UniformBlockBuffer,
     };
 
     struct Buffer {
@@ -218,6 +466,19 @@ protected:
         size_t ndim = 0;
         size_t shape[3] { 0, 0, 0 };
         size_t size = 0;
+        /// Size of the allocated storage (vertex and index buffers only)
+        size_t capacity = 0;
+        BufferUsage usage = BufferUsage::Dynamic;
+        /// Instance divisor of a vertex attribute
+        uint32_t divisor = 0;
+        /// Byte offset of the data within the buffer
+        size_t offset = 0;
+        /// Distance between consecutive vertices in bytes (0: tightly packed)
+        size_t stride = 0;
+        /// Map integer vertex data to normalized floating point values?
+        bool normalized = false;
+        /// Object that owns the buffer, if it is not owned by the shader
+        ref<Object> source;
         bool dirty = false;
 
         std::string to_string() const;
@@ -231,6 +492,13 @@ protected:
 
     #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
         uint32_t m_shader_handle = 0;
+        bool m_loaded_from_cache = false;
+        /// Is the program still being compiled/linked (see \ref finish_linking())?
+        bool m_linking = false;
+        uint32_t m_vertex_shader_handle = 0;
+        uint32_t m_fragment_shader_handle = 0;
+        /// Binary cache file of the program (empty if not cached)
+        std::string m_cache_path;
     #  if defined(NANOGUI_USE_OPENGL)
         uint32_t m_vertex_array_handle = 0;
         bool m_uses_point_size = false;
@@ -240,6 +508,39 @@ protected:
     #endif
 };
 
+/**
+ * \brief Lightweight handle to a named shader parameter
+ *
+ * Refers directly to the parameter's entry in the shader, hence using it
+ * involves no string operations. Obtained via \ref Shader::parameter().
+ */
+class NANOGUI_EXPORT Shader::Parameter {
+public:
+    /// Create an invalid handle
+    Parameter() = default;
+
+    /// Does this handle refer to a shader parameter?
+    bool valid() const { return m_entry != nullptr; }
+
+    /// Return the name of the referenced shader parameter
+    const std::string &name() const;
+
+private:
+    friend class Shader;
+
+    Shader *m_shader = nullptr;
+    std::pair<const std::string, Shader::Buffer> *m_entry = nullptr;
+#if defined(NANOGUI_USE_METAL)
+    /// Sampler state that accompanies a texture parameter (if any)
+    Shader::Buffer *m_sampler = nullptr;
+#endif
+};
+
+template <typename Array> void Shader::set_uniform(const std::string &name,
+                                                   const Array &value) {
+    set_uniform(parameter(name), value);
+}
+
 /// Access binary data stored in nanogui_resources.cpp
 #define NANOGUI_RESOURCE_STRING(name) std::string(name, name + name##_size)
 
@@ -252,5 +553,20 @@ protected:
 #  define NANOGUI_SHADER(name) NANOGUI_RESOURCE_STRING(name##_metallib)
 #endif
 
+/**
+ * \brief Access the source code of a shader stored in nanogui_resources.cpp
+ *
+ * Equivalent to \ref NANOGUI_SHADER on OpenGL and GLES. On Metal, this
+ * returns the source instead of the precompiled library, e.g. for
+ * specialization using \ref ShaderLibrary.
+ */
+#if defined(NANOGUI_USE_OPENGL)
+#  define NANOGUI_SHADER_SOURCE(name) NANOGUI_RESOURCE_STRING(name##_gl)
+#elif defined(NANOGUI_USE_GLES)
+#  define NANOGUI_SHADER_SOURCE(name) NANOGUI_RESOURCE_STRING(name##_gles)
+#elif defined(NANOGUI_USE_METAL)
+#  define NANOGUI_SHADER_SOURCE(name) NANOGUI_RESOURCE_STRING(name##_metal)
+#endif
+
 
 NAMESPACE_END(nanogui)
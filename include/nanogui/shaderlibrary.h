@@ -0,0 +1,123 @@
+/*
+    nanogui/shaderlibrary.h -- Lazily compiled permutations of a shader
+    with preprocessor feature switches
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/renderpass.h>
+#include <nanogui/shader.h>
+#include <unordered_map>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class ShaderLibrary shaderlibrary.h nanogui/shaderlibrary.h
+ *
+ * \brief Set of shader variants that are generated from a single vertex
+ * and fragment shader source containing <tt>#ifdef</tt> feature switches.
+ *
+ * Each feature name is assigned a bit according to its position in the
+ * list passed to the constructor. A variant is identified by a bit mask of
+ * the enabled features and compiled on first use, which prepends <tt>
+ * #define NAME 1</tt> lines for the enabled features to both sources
+ * (following the <tt>#version</tt> directive, if present). The shader
+ * compiler hence strips the code paths of disabled features. Compiled
+ * variants are cached by their bit mask.
+ *
+ * Variants inherit the disk cache of \ref Shader::set_binary_cache_directory(),
+ * since the defines are part of the hashed source code.
+ *
+ * Use \ref NANOGUI_SHADER_SOURCE to pass shaders embedded by bin2c. On
+ * Metal, this refers to the shader source code rather than to the
+ * precompiled library, which cannot be specialized.
+ */
+class NANOGUI_EXPORT ShaderLibrary : public Object {
+public:
+    /// Maximum number of feature switches
+    static constexpr size_t MaxFeatures = 32;
+
+    /**
+     * \brief Initialize the library (no shaders are compiled yet)
+     *
+     * \param render_pass
+     *     Render pass that the shader variants are used with (the library
+     *     keeps a reference to it)
+     *
+     * \param name
+     *     Name of the library, which also prefixes the variant names
+     *
+     * \param vertex_shader
+     *     Source of the vertex shader
+     *
+     * \param fragment_shader
+     *     Source of the fragment shader
+     *
+     * \param features
+     *     Names of the preprocessor switches (at most 32)
+     *
+     * \param blend_mode
+     *     Blend mode of all variants
+     *
+     * \param asynchronous
+     *     Compile variants asynchronously (see \ref Shader::Shader())
+     */
+    ShaderLibrary(RenderPass *render_pass,
+                  const std::string &name,
+                  const std::string &vertex_shader,
+                  const std::string &fragment_shader,
+                  const std::vector<std::string> &features,
+                  Shader::BlendMode blend_mode = Shader::BlendMode::None,
+                  bool asynchronous = false);
+
+    /// Return the name of the library
+    const std::string &name() const { return m_name; }
+
+    /// Return the names of the feature switches
+    const std::vector<std::string> &features() const { return m_features; }
+
+    /// Return the bit associated with a feature switch
+    uint32_t feature(const std::string &name) const;
+
+    /**
+     * \brief Return the variant with the given set of enabled features,
+     * compiling it if needed
+     *
+     * The returned shader remains owned by the library.
+     */
+    Shader *shader(uint32_t features = 0);
+
+    /// Has the variant with the given set of enabled features been compiled?
+    bool has_shader(uint32_t features) const {
+        return m_shaders.find(features) != m_shaders.end();
+    }
+
+    /// Return the number of compiled variants
+    size_t shader_count() const { return m_shaders.size(); }
+
+    /// Release all compiled variants
+    void clear() { m_shaders.clear(); }
+
+    /// Return the source code of a variant's shader stage
+    std::string specialize(const std::string &source, uint32_t features) const;
+
+protected:
+    ref<RenderPass> m_render_pass;
+    std::string m_name;
+    std::string m_vertex_shader;
+    std::string m_fragment_shader;
+    std::vector<std::string> m_features;
+    Shader::BlendMode m_blend_mode;
+    bool m_asynchronous;
+    std::unordered_map<uint32_t, ref<Shader>> m_shaders;
+};
+
+NAMESPACE_END(nanogui)
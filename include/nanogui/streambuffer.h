@@ -0,0 +1,121 @@
+/*
+    nanogui/streambuffer.h -- Ring buffer for geometry that is
+    regenerated every frame
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/object.h>
+#include <vector>
+
+NAMESPACE_BEGIN(nanogui)
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+
+/**
+ * \class StreamBuffer streambuffer.h nanogui/streambuffer.h
+ *
+ * \brief Vertex buffer for data that is regenerated every frame (e.g.
+ * immediate-mode overlays), which avoids reallocating GPU storage and
+ * waiting for the GPU on every upload.
+ *
+ * The buffer is split into three equally sized segments that are used
+ * for consecutive frames in round-robin fashion. \ref next_frame() places
+ * a fence after the commands of the current frame and, before a segment
+ * is reused, waits for the fence that protects it, which normally has
+ * long been signaled. Data is written to one of the following:
+ *
+ * - A persistently and coherently mapped buffer (<tt>glBufferStorage</tt>,
+ *   OpenGL 4.4 and newer).
+ * - Otherwise, a range mapped using <tt>glMapBufferRange()</tt> with \c
+ *   GL_MAP_UNSYNCHRONIZED_BIT (OpenGL 3 and OpenGL ES 3).
+ * - On OpenGL ES 2, a CPU staging area that is copied using
+ *   <tt>glBufferSubData()</tt>.
+ *
+ * Use \ref Shader::set_stream_buffer() to source a vertex attribute from
+ * an offset inside the buffer.
+ */
+class NANOGUI_EXPORT StreamBuffer : public Object {
+public:
+    /**
+     * \brief Allocate a stream buffer
+     *
+     * \param frame_size
+     *     Number of bytes that can be written per frame (the buffer
+     *     allocates three times as much)
+     */
+    StreamBuffer(size_t frame_size = 4 * 1024 * 1024);
+
+    /// Return the number of bytes that can be written per frame
+    size_t frame_size() const { return m_frame_size; }
+
+    /// Return the number of bytes written during the current frame
+    size_t used() const { return m_head - m_segment * m_frame_size; }
+
+    /// Does the buffer use a persistent mapping?
+    bool persistent() const { return m_persistent != nullptr; }
+
+    /// Return the OpenGL handle of the underlying buffer
+    uint32_t buffer_handle() const { return m_buffer_handle; }
+
+    /**
+     * \brief Reserve space in the current frame's segment and return a
+     * pointer that the caller fills with \c size bytes
+     *
+     * The write must be completed using \ref unmap() before drawing. The
+     * offset of the reserved range within the buffer (aligned to \c
+     * alignment bytes) is stored in \c offset.
+     */
+    uint8_t *map(size_t size, size_t &offset, size_t alignment = 16);
+
+    /// Finish a write started using \ref map()
+    void unmap();
+
+    /// Copy data into the current frame's segment and return its offset within the buffer
+    size_t write(const void *data, size_t size, size_t alignment = 16);
+
+    /**
+     * \brief Finish the current frame and move on to the next segment
+     *
+     * Must be called once per frame after the draw calls that read from
+     * the buffer have been issued.
+     */
+    void next_frame();
+
+    /// Release all resources
+    virtual ~StreamBuffer();
+
+protected:
+    static constexpr size_t SegmentCount = 3;
+
+    /// Wait until the GPU has finished reading from the given segment
+    void wait_segment(size_t segment);
+
+protected:
+    size_t m_frame_size;
+    size_t m_segment = 0;
+    /// Offset of the next write within the buffer
+    size_t m_head = 0;
+    uint32_t m_buffer_handle = 0;
+    /// Pointer to the persistently mapped buffer (if supported)
+    uint8_t *m_persistent = nullptr;
+    /// Fences protecting the segments (\c GLsync handles)
+    void *m_fences[SegmentCount] { };
+    /// Range of the pending write (see \ref map())
+    size_t m_map_offset = 0, m_map_size = 0;
+    bool m_mapped = false;
+    /// Staging area for OpenGL ES 2
+    std::vector<uint8_t> m_staging;
+};
+
+#endif
+
+NAMESPACE_END(nanogui)
@@ -22,6 +22,63 @@
 
 NAMESPACE_BEGIN(nanogui)
 
+/**
+ * \brief Handle to a pending asynchronous texture readback
+ *
+ * Instances are created by \ref Texture::download_async(). The GPU copies
+ * the texture contents into a staging buffer in the background;
+ * \ref ready() can be polled each frame, and \ref read() retrieves the
+ * data once it is available.
+ */
+class NANOGUI_EXPORT TextureReadback : public Object {
+    friend class Texture;
+public:
+    /// Has the GPU finished copying the texture contents? (never blocks)
+    bool ready();
+
+    /**
+     * \brief Copy the packed pixel data into \c data
+     *
+     * Blocks if the readback has not finished yet. The output has the
+     * same layout as the one produced by \ref Texture::download().
+     */
+    void read(uint8_t *data);
+
+    /// Return the size of the texture region that was read back
+    const Vector2i &size() const { return m_size; }
+
+    /// Return the number of channels of the data written by \ref read()
+    size_t channels() const { return m_channels; }
+
+    /// Return the number format of the data written by \ref read()
+    VariableType dtype() const { return m_dtype; }
+
+    /// Return the number of bytes per pixel of the data written by \ref read()
+    size_t bytes_per_pixel() const { return m_bytes_per_pixel; }
+
+    /// Release the staging buffer
+    virtual ~TextureReadback();
+
+protected:
+    TextureReadback() = default;
+
+protected:
+    Vector2i m_size;
+    size_t m_channels = 0;
+    VariableType m_dtype = VariableType::Invalid;
+    size_t m_bytes_per_pixel = 0;
+    size_t m_buffer_bytes_per_pixel = 0;
+    bool m_flip = false;
+
+    #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+        uint32_t m_buffer_handle = 0;
+        void *m_fence = nullptr;
+    #elif defined(NANOGUI_USE_METAL)
+        void *m_buffer = nullptr;
+        void *m_command_buffer = nullptr;
+    #endif
+};
+
 class NANOGUI_EXPORT Texture : public Object {
 public:
     /// Overall format of the texture (e.g. luminance-only or RGBA)
@@ -48,7 +105,25 @@ public:
         Depth,
 
         /// Combined depth + stencil map
-        DepthStencil
+        DepthStencil,
+
+        /// ETC2 block-compressed RGB bitmap (4x4 blocks of 8 bytes)
+        ETC2_RGB,
+
+        /// ETC2/EAC block-compressed RGB bitmap + alpha channel (4x4 blocks of 16 bytes)
+        ETC2_RGBA,
+
+        /// ASTC block-compressed RGB bitmap + alpha channel (4x4 blocks of 16 bytes)
+        ASTC_4x4_RGBA,
+
+        /// BC1 (DXT1) block-compressed RGB bitmap + 1 bit alpha (4x4 blocks of 8 bytes)
+        BC1_RGBA,
+
+        /// BC3 (DXT5) block-compressed RGB bitmap + alpha channel (4x4 blocks of 16 bytes)
+        BC3_RGBA,
+
+        /// BC7 block-compressed RGB bitmap + alpha channel (4x4 blocks of 16 bytes)
+        BC7_RGBA
     };
 
     /// Number format of pixel components
@@ -96,7 +171,47 @@ public:
         ShaderRead = 0x01,
 
         /// Target framebuffer for rendering
-        RenderTarget = 0x02
+        RenderTarget = 0x02,
+
+        /**
+         * Multisampled render target whose samples only exist in the tile
+         * memory of the GPU and are resolved implicitly when the render
+         * pass ends (GLES with EXT_multisampled_render_to_texture, see
+         * \ref implicit_resolve_supported()). The texture itself stores a
+         * single sample per pixel, hence it can be combined with \ref
+         * ShaderRead.
+         */
+        ImplicitResolve = 0x04
+    };
+
+    /// How are the levels of the mip map computed? (see \ref set_mipmap_filter())
+    enum class MipmapFilter : uint8_t {
+        /// Via \ref generate_mipmap() on the GPU (implementation-defined filter)
+        GPU,
+
+        /// 2x2 box filter evaluated on the CPU
+        Box,
+
+        /// Kaiser-windowed sinc filter (6 taps per dimension) evaluated on the CPU
+        Kaiser
+    };
+
+    /// Counters describing the pool of recycled GPU texture storage
+    struct PoolStats {
+        /// Number of allocations served from previously released storage
+        size_t hits = 0;
+
+        /// Number of allocations that required new storage
+        size_t misses = 0;
+
+        /// Number of idle entries freed to stay within the pool limit
+        size_t evictions = 0;
+
+        /// Number of idle entries currently held by the pool
+        size_t entries = 0;
+
+        /// Memory (in bytes) consumed by the idle entries
+        size_t bytes = 0;
     };
 
     /**
@@ -120,12 +235,43 @@ public:
             uint8_t flags = (uint8_t) TextureFlags::ShaderRead,
             bool mipmap_manual = false);
 
-    /// Load an image from the given file using stb-image
+    /**
+     * \brief Load an image from the given file
+     *
+     * KTX and KTX2 containers are recognized by their file signature and
+     * may hold block-compressed data as well as a pre-built mip chain.
+     * Other files are decoded using stb-image.
+     */
     Texture(const std::string &filename,
             InterpolationMode min_interpolation_mode = InterpolationMode::Bilinear,
             InterpolationMode mag_interpolation_mode = InterpolationMode::Bilinear,
             WrapMode wrap_mode                       = WrapMode::ClampToEdge);
 
+    /**
+     * \brief Load an image from the given file on a background thread
+     *
+     * Returns a 1x1 transparent RGBA texture that can be used as a
+     * placeholder right away. The file is decoded by a pool of worker
+     * threads, and the pixel data is then uploaded from the main loop via
+     * \ref async(), at which point the texture takes on the format and size
+     * of the image and \c callback is invoked with an empty error message.
+     * If the file cannot be loaded, the placeholder remains and \c callback
+     * receives a description of the problem. Decoding stalls while the
+     * decoded images awaiting upload exceed \ref set_load_limit().
+     */
+    static ref<Texture> load_async(
+        const std::string &filename,
+        const std::function<void(Texture *, const std::string &)> &callback = {},
+        InterpolationMode min_interpolation_mode = InterpolationMode::Bilinear,
+        InterpolationMode mag_interpolation_mode = InterpolationMode::Bilinear,
+        WrapMode wrap_mode                       = WrapMode::ClampToEdge);
+
+    /// Set the amount of decoded image data (in bytes) that may await upload
+    static void set_load_limit(size_t bytes);
+
+    /// Return the amount of decoded image data that may await upload
+    static size_t load_limit();
+
     /// Return the pixel format
     PixelFormat pixel_format() const { return m_pixel_format; }
 
@@ -156,21 +302,132 @@ public:
     /// Return the number of channels of this texture
     size_t channels() const;
 
-    /// Upload packed pixel data from the CPU to the GPU
+    /// Return whether the pixel format is block-compressed
+    bool compressed() const;
+
+    /// Return the size of the pixel blocks (1x1 for uncompressed formats)
+    Vector2i block_size() const;
+
+    /// Return the number of bytes needed to store an image of the given size
+    size_t data_size(const Vector2i &size) const;
+
+    /**
+     * \brief Upload packed pixel data from the CPU to the GPU
+     *
+     * Block-compressed data is passed as is. Since mip maps cannot be
+     * generated for compressed formats, only level 0 will be sampled
+     * unless the remaining levels are provided via \ref upload_mip_level().
+     */
     void upload(const uint8_t *data);
 
+    /**
+     * \brief Upload one level of a manually specified mip chain
+     *
+     * \ref upload() provides level 0, and the remaining levels must follow
+     * in increasing order. The size of level \c i is <tt>max(1, size >> i)</tt>.
+     */
+    void upload_mip_level(uint32_t level, const uint8_t *data);
+
     /// Upload packed pixel data to a rectangular sub-region of the texture from the CPU to the GPU
     void upload_sub_region(const uint8_t *data, const Vector2i& origin, const Vector2i& size);
 
-    /// Download packed pixel data from the GPU to the CPU
+    /**
+     * \brief Upload a rectangular region of a larger CPU-side image to a
+     * sub-region of the texture without an intermediate copy
+     *
+     * \param data
+     *     Pointer to the first pixel of the (larger) source image
+     *
+     * \param origin
+     *     Position of the destination region within the texture
+     *
+     * \param size
+     *     Size of the region in pixels
+     *
+     * \param row_pitch
+     *     Distance in bytes between consecutive rows of the source image
+     *
+     * \param src_origin
+     *     Position of the region within the source image
+     */
+    void upload_sub_region(const uint8_t *data, const Vector2i& origin, const Vector2i& size,
+                           size_t row_pitch, const Vector2i& src_origin = Vector2i(0, 0));
+
+    /**
+     * \brief Upload packed pixel data from the CPU to the GPU without
+     * waiting for the transfer to complete
+     *
+     * The data is copied into one of several pixel unpack buffers
+     * (PBOs) that are cycled through in a ring, and the texture is
+     * subsequently updated from that buffer on the GPU timeline. The
+     * caller may reuse or release \c data as soon as this function
+     * returns. Use \ref upload_finished() to check whether the GPU has
+     * consumed the uploaded data.
+     *
+     * Falls back to \ref upload() on backends without pixel buffer
+     * objects (GLES 2).
+     */
+    void upload_async(const uint8_t *data);
+
+    /// Asynchronous version of \ref upload_sub_region() (see \ref upload_async())
+    void upload_sub_region_async(const uint8_t *data, const Vector2i& origin,
+                                 const Vector2i& size);
+
+    /**
+     * \brief Check whether all uploads issued via \ref upload_async() and
+     * \ref upload_sub_region_async() have completed
+     *
+     * This function never blocks.
+     */
+    bool upload_finished();
+
+    /**
+     * \brief Download packed pixel data from the GPU to the CPU
+     *
+     * This is equivalent to <tt>download_async()->read(data)</tt> and
+     * blocks until the GPU has finished all pending work on the texture.
+     * Use \ref download_async() to overlap the transfer with rendering.
+     */
     void download(uint8_t *data);
 
+    /**
+     * \brief Begin an asynchronous download of the texture contents
+     *
+     * On OpenGL and GLES 3, the texture is attached to a temporary
+     * framebuffer and read via \c glReadPixels into a pixel pack buffer,
+     * which does not stall the rendering pipeline. Rows of render targets
+     * are flipped while copying the result out of the buffer. Not
+     * supported on GLES 2.
+     *
+     * GLES 3 only reads back RGB/RGBA color textures whose component
+     * format is \c UInt8, \c Float32, or the type reported by
+     * \c GL_IMPLEMENTATION_COLOR_READ_TYPE; other textures raise an
+     * exception.
+     */
+    ref<TextureReadback> download_async();
+
     /// Resize the texture (discards the current contents)
     void resize(const Vector2i &size);
 
     /// Generates the mipmap. Done automatically upon upload if manual mipmapping is disabled.
     void generate_mipmap();
 
+    /**
+     * \brief Compute the mip map on the CPU using the given filter
+     *
+     * Applies to subsequent uploads of textures that use trilinear
+     * interpolation without manual mip mapping. The texture then keeps a
+     * CPU copy of all levels, so that \ref upload_sub_region() only
+     * recomputes and uploads the affected region of each level. Until the
+     * first full upload, region updates use \ref generate_mipmap() instead.
+     * When \c srgb is set, color channels are filtered in linear space.
+     * Supports UInt8, UInt16, Float16, and Float32 components.
+     */
+    void set_mipmap_filter(MipmapFilter filter, bool srgb = false);
+
+    /// Return the filter used to compute the mip map
+    MipmapFilter mipmap_filter() const { return m_mipmap_filter; }
+
 #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
     uint32_t texture_handle() const { return m_texture_handle; }
     uint32_t renderbuffer_handle() const { return m_renderbuffer_handle; }
@@ -182,10 +439,68 @@ public:
     /// Release all resources
     virtual ~Texture();
 
+    /**
+     * \brief Set the amount of memory (in bytes) that may be held by idle
+     * texture storage awaiting reuse
+     *
+     * Textures created while a \ref Screen's context is current return their
+     * storage to a pool upon destruction instead of freeing it, and new
+     * textures with a matching format, size, sample count, and flags pick it
+     * up again. Render buffers (i.e. textures with only the \ref RenderTarget
+     * flag) are allocated with their size rounded up to a coarse granularity
+     * (except on GLES 2, which requires equally sized attachments), which
+     * also allows \ref resize() to skip the reallocation when the new size
+     * falls into the same bucket. Resizing other render targets swaps their
+     * storage for pooled storage of the new size. The least recently
+     * released entries are freed once the limit is exceeded. A limit of
+     * zero disables pooling.
+     *
+     * The pool is not synchronized. Like the OpenGL contexts that it
+     * belongs to, it must only be used by the thread that renders.
+     */
+    static void set_pool_limit(size_t bytes);
+
+    /// Return the amount of memory that may be held by idle pooled storage
+    static size_t pool_limit();
+
+    /// Return counters describing the texture pool
+    static PoolStats pool_stats();
+
+    /// Free all idle pooled storage belonging to the current OpenGL context
+    static void clear_pool();
+
+    /// Can the current context create textures with the \ref ImplicitResolve flag?
+    static bool implicit_resolve_supported();
+
 protected:
     /// Initialize the texture handle
     void init();
 
+    /**
+     * Refresh the mip map after a region of level 0 was replaced by 'data'
+     * (which may be \c nullptr when the contents were discarded)
+     */
+    void update_mipmap(const uint8_t *data, const Vector2i &origin,
+                       const Vector2i &size, size_t row_pitch);
+
+    /// Upload pixel data to a region of the given mip level
+    void upload_mip_sub_region(uint32_t level, const uint8_t *data, const Vector2i &origin,
+                               const Vector2i &size, size_t row_pitch);
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    /// Copy 'size' bytes into the next pixel unpack buffer and leave it bound
+    void stage_pixel_buffer(const uint8_t *data, size_t size);
+
+    /// Insert a fence after an upload sourced from the current pixel unpack buffer
+    void release_pixel_buffer();
+
+    /// Take a texture or render buffer handle from the pool or create a new one
+    void acquire_storage();
+
+    /// Return the texture or render buffer handle to the pool (or free it)
+    void release_storage();
+#endif
+
 protected:
     PixelFormat m_pixel_format;
     ComponentFormat m_component_format;
@@ -196,10 +511,26 @@ protected:
     uint8_t m_flags;
     Vector2i m_size;
     bool m_mipmap_manual;
+    MipmapFilter m_mipmap_filter = MipmapFilter::GPU;
+    bool m_mipmap_srgb = false;
+
+    /// CPU copy of the mip levels when they are computed by \ref update_mipmap()
+    std::vector<std::vector<uint8_t>> m_mipmap_levels;
 
     #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
         uint32_t m_texture_handle = 0;
         uint32_t m_renderbuffer_handle = 0;
+
+        /// Context that owns the handles, used to key the texture pool
+        GLFWwindow *m_context = nullptr;
+
+        /// Ring of pixel unpack buffers used by the asynchronous upload path
+        struct PixelBuffer {
+            uint32_t handle = 0;
+            size_t size = 0;
+            void *fence = nullptr;
+        } m_pixel_buffers[3];
+        uint32_t m_pixel_buffer_index = 0;
     #elif defined(NANOGUI_USE_METAL)
         void *m_texture_handle = nullptr;
         void *m_sampler_state_handle = nullptr;
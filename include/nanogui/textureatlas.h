@@ -0,0 +1,197 @@
+/*
+    nanogui/textureatlas.h -- Packs many small images into a single texture
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/texture.h>
+#include <map>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class TextureAtlas textureatlas.h nanogui/textureatlas.h
+ *
+ * \brief Packs many small images into the regions of a single texture,
+ * so that drawing them does not require switching between textures.
+ *
+ * Regions are placed using a skyline bottom-left packer and surrounded by
+ * a border that replicates their edge pixels, which prevents neighboring
+ * regions from bleeding into each other under bilinear interpolation.
+ * Removing a region does not immediately make its space reusable; \ref
+ * defragment() repacks the remaining regions (which happens automatically
+ * when \ref add() runs out of space). When eviction is enabled, \ref add()
+ * additionally drops the least recently used regions to make room.
+ *
+ * The atlas keeps a CPU copy of its contents, which it uses to repack
+ * regions without reading back the texture.
+ */
+class NANOGUI_EXPORT TextureAtlas : public Object {
+public:
+    using PixelFormat = Texture::PixelFormat;
+    using ComponentFormat = Texture::ComponentFormat;
+    using InterpolationMode = Texture::InterpolationMode;
+
+    /**
+     * \brief Allocate an empty atlas
+     *
+     * \param size
+     *     Size of the underlying texture
+     *
+     * \param padding
+     *     Width of the border around each region
+     */
+    TextureAtlas(const Vector2i &size = Vector2i(1024, 1024),
+                 PixelFormat pixel_format = PixelFormat::RGBA,
+                 ComponentFormat component_format = ComponentFormat::UInt8,
+                 int padding = 1,
+                 InterpolationMode min_interpolation_mode = InterpolationMode::Bilinear,
+                 InterpolationMode mag_interpolation_mode = InterpolationMode::Bilinear);
+
+    /**
+     * \brief Copy an image into a free region of the atlas
+     *
+     * The image uses the atlas's pixel and component format. When \c
+     * row_pitch is zero, rows are assumed to be densely packed.
+     *
+     * \return An identifier of the region, or -1 if the image does not
+     * fit (even after defragmentation and eviction). A failed call leaves
+     * all existing regions in place.
+     */
+    int add(const uint8_t *data, const Vector2i &size, size_t row_pitch = 0);
+
+    /// Replace the contents of an existing region (the size must match)
+    void update(int id, const uint8_t *data, size_t row_pitch = 0);
+
+    /// Release a region
+    void remove(int id);
+
+    /// Does the atlas contain the given region?
+    bool contains(int id) const { return m_regions.find(id) != m_regions.end(); }
+
+    /// Return the position of a region within the texture (in pixels)
+    Vector2i position(int id) const { return region(id).position; }
+
+    /// Return the size of a region (in pixels)
+    Vector2i region_size(int id) const { return region(id).size; }
+
+    /**
+     * \brief Return the texture coordinates of a region as <tt>(u0, v0,
+     * u1, v1)</tt> and mark it as recently used
+     *
+     * Regions move when the atlas is defragmented, hence the coordinates
+     * should be queried again before drawing.
+     */
+    Vector4f uv(int id);
+
+    /**
+     * \brief Repack the regions to reclaim the space of removed ones
+     *
+     * \return \c false (leaving the layout unchanged) if the regions could
+     * not be repacked
+     */
+    bool defragment();
+
+    /// Evict least recently used regions when \ref add() runs out of space?
+    void set_eviction(bool eviction) { m_eviction = eviction; }
+
+    /// Evict least recently used regions when \ref add() runs out of space?
+    bool eviction() const { return m_eviction; }
+
+    /// Return the number of regions currently held by the atlas
+    size_t region_count() const { return m_regions.size(); }
+
+    /// Return the number of regions dropped to make room for new ones
+    size_t evictions() const { return m_evictions; }
+
+    /// Return the fraction of the texture covered by regions (including padding)
+    float occupancy() const;
+
+    /// Return the size of the underlying texture
+    const Vector2i &size() const { return m_texture->size(); }
+
+    /// Return the underlying texture
+    Texture *texture() { return m_texture.get(); }
+
+    /// Return the underlying texture
+    const Texture *texture() const { return m_texture.get(); }
+
+    /**
+     * \brief Return a NanoVG image that refers to the underlying texture
+     *
+     * To draw a region, pass its position and the atlas size (scaled to
+     * the destination) to \c nvgImagePattern(). The image is created once
+     * per NanoVG context and deleted along with the atlas.
+     */
+    int nvg_image(NVGcontext *ctx);
+
+    /// Release all resources
+    virtual ~TextureAtlas();
+
+protected:
+    struct Region {
+        Vector2i position;
+        Vector2i size;
+        uint64_t last_use;
+    };
+
+    /// Segment of the skyline: the span [x, x+width) is filled up to row y
+    struct SkylineNode {
+        int x, y, width;
+    };
+
+    /// New padded position (second) of each region (first) after repacking
+    using Layout = std::vector<std::pair<Region *, Vector2i>>;
+
+    const Region &region(int id) const;
+
+    /**
+     * \brief Compute a compacted layout of the current regions, followed by
+     * an additional padded rectangle of size \c extra (if nonzero)
+     *
+     * On success, the skyline reflects the new layout, but no pixels have
+     * moved yet (see \ref move_regions()). On failure, the skyline is left
+     * unchanged.
+     */
+    bool relayout(Layout &layout, const Vector2i &extra, Vector2i &extra_position);
+
+    /// Compute a compacted layout of the current regions
+    bool relayout(Layout &layout);
+
+    /// Move regions within the CPU copy according to a layout from \ref relayout()
+    void move_regions(const Layout &layout);
+
+    /// Find a spot for a padded rectangle using the skyline bottom-left heuristic
+    bool pack(const Vector2i &size, Vector2i &position);
+
+    /// Copy an image (and its replicated edges) into the CPU copy
+    void blit(const Region &region, const uint8_t *data, size_t row_pitch);
+
+    /// Upload the padded rectangle of a region from the CPU copy
+    void upload_region(const Region &region);
+
+protected:
+    ref<Texture> m_texture;
+    int m_padding;
+    size_t m_bytes_per_pixel;
+    std::vector<uint8_t> m_pixels;
+    std::vector<SkylineNode> m_skyline;
+    std::map<int, Region> m_regions;
+    std::map<NVGcontext *, int> m_nvg_images;
+    int m_next_id = 0;
+    uint64_t m_use_counter = 0;
+    /// Area (in pixels, including padding) lost to removed regions
+    size_t m_wasted_area = 0;
+    bool m_eviction = false;
+    size_t m_evictions = 0;
+};
+
+NAMESPACE_END(nanogui)
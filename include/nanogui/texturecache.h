@@ -0,0 +1,85 @@
+/*
+    nanogui/texturecache.h -- Shared, size-bounded cache of file-backed
+    textures and NanoVG images
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/texture.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class TextureCache texturecache.h nanogui/texturecache.h
+ *
+ * \brief Process-wide cache that hands out shared instances of textures
+ * loaded from files, as well as NanoVG images created from memory.
+ *
+ * Textures are keyed by their path, modification time, sampler settings,
+ * and the OpenGL context that was current when they were requested, so
+ * that editing a file on disk causes it to be loaded again. When the
+ * resident entries exceed the budget, the least recently requested
+ * textures are dropped from the cache. Dropped textures remain valid for
+ * as long as other references to them exist.
+ *
+ * NanoVG images count towards the budget but are never evicted, since
+ * widgets keep their integer handles (e.g. via \ref nvgImageIcon()). They
+ * are only deleted along with their NanoVG context (see \ref release()).
+ */
+class NANOGUI_EXPORT TextureCache {
+public:
+    /// Cache statistics
+    struct Stats {
+        /// Number of requests served from the cache
+        size_t hits = 0;
+
+        /// Number of requests that had to load the image
+        size_t misses = 0;
+
+        /// Number of entries dropped to stay within the budget
+        size_t evictions = 0;
+
+        /// Number of entries currently held by the cache
+        size_t entries = 0;
+
+        /// Estimated GPU memory (in bytes) consumed by the entries
+        size_t bytes = 0;
+    };
+
+    /// Return a shared texture for the given image file (see \ref Texture::Texture())
+    static ref<Texture> texture(const std::string &filename,
+                                Texture::InterpolationMode min_interpolation_mode =
+                                    Texture::InterpolationMode::Bilinear,
+                                Texture::InterpolationMode mag_interpolation_mode =
+                                    Texture::InterpolationMode::Bilinear,
+                                Texture::WrapMode wrap_mode = Texture::WrapMode::ClampToEdge);
+
+    /// Return a shared NanoVG image created from an in-memory image file
+    static int nvg_image(NVGcontext *ctx, const std::string &name,
+                         const uint8_t *data, uint32_t size);
+
+    /// Set the amount of GPU memory (in bytes) that cache entries may consume
+    static void set_budget(size_t bytes);
+
+    /// Return the amount of GPU memory that cache entries may consume
+    static size_t budget();
+
+    /// Return the cache statistics
+    static Stats stats();
+
+    /// Drop all textures (NanoVG images are kept, see \ref release())
+    static void clear();
+
+    /// Drop the entries belonging to a window and its NanoVG context
+    static void release(GLFWwindow *window, NVGcontext *ctx);
+};
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,178 @@
+/*
+    nanogui/tiledimage.h -- Multi-resolution image that is paged into a
+    fixed-size GPU tile cache
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/texture.h>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+NAMESPACE_BEGIN(nanogui)
+
+/**
+ * \class TiledImage tiledimage.h nanogui/tiledimage.h
+ *
+ * \brief Image of arbitrary size that is displayed from a pyramid of
+ * square tiles (a "virtual texture"), for use with \ref ImageView.
+ *
+ * Level 0 of the pyramid holds the image at full resolution, and every
+ * further level halves the resolution until the whole image fits into a
+ * single tile. A user-provided loader produces tiles on a background
+ * thread. Only the tiles needed for the visible part of the image at the
+ * current magnification are requested; they are stored in a fixed-size
+ * cache texture, and least recently used tiles are replaced as the view
+ * changes.
+ *
+ * An indirection texture with one texel per level 0 tile records which
+ * cache slot (and pyramid level) provides the pixels of that tile.
+ * Missing tiles resolve to the finest coarser tile that is resident, so
+ * the image gradually sharpens while tiles are still loading.
+ */
+class NANOGUI_EXPORT TiledImage : public Object {
+public:
+    using PixelFormat = Texture::PixelFormat;
+    using ComponentFormat = Texture::ComponentFormat;
+
+    /**
+     * \brief Callback that produces a tile of the pyramid
+     *
+     * Must write <tt>tile_size x tile_size</tt> densely packed pixels to \c
+     * data, covering the level pixels starting at <tt>tile * tile_size</tt>
+     * (pixels beyond the edge of the level are ignored). Pixel \c (x, y) of
+     * level \c l corresponds to level 0 pixels <tt>[x*2^l, (x+1)*2^l)</tt>.
+     * Returns \c false (or throws) if the tile could not be produced, in
+     * which case the tile is not requested again. The callback runs on a
+     * background thread.
+     */
+    using TileLoader = std::function<bool(uint32_t level, const Vector2i &tile, uint8_t *data)>;
+
+    /**
+     * \brief Create a tiled image
+     *
+     * \param size
+     *     Size of the image (level 0) in pixels
+     *
+     * \param loader
+     *     Callback that produces the tiles
+     *
+     * \param tile_size
+     *     Size of the square tiles in pixels
+     *
+     * \param cache_size
+     *     Number of tiles along each axis of the GPU tile cache
+     */
+    TiledImage(const Vector2i &size,
+               const TileLoader &loader,
+               int tile_size = 256,
+               const Vector2i &cache_size = Vector2i(16, 16),
+               PixelFormat pixel_format = PixelFormat::RGBA,
+               ComponentFormat component_format = ComponentFormat::UInt8);
+
+    /// Return the size of the image (level 0) in pixels
+    const Vector2i &size() const { return m_size; }
+
+    /// Return the size of the square tiles in pixels
+    int tile_size() const { return m_tile_size; }
+
+    /// Return the number of bytes that the loader writes per tile
+    size_t tile_bytes() const;
+
+    /// Return the number of pyramid levels
+    uint32_t level_count() const { return m_level_count; }
+
+    /// Return the size of a pyramid level in pixels
+    Vector2i level_size(uint32_t level) const;
+
+    /// Return the number of tiles along each axis of a pyramid level
+    Vector2i tile_count(uint32_t level) const;
+
+    /**
+     * \brief Page in the tiles covering a region of the image
+     *
+     * Uploads tiles that finished loading, requests the missing tiles of
+     * the region (coarse levels first), and refreshes the indirection
+     * texture. Called by \ref ImageView before drawing.
+     *
+     * \param min
+     *     Upper left corner of the visible region (in level 0 pixels)
+     *
+     * \param max
+     *     Lower right corner of the visible region (in level 0 pixels)
+     *
+     * \param scale
+     *     Number of screen pixels per level 0 pixel
+     *
+     * \return \c true when all tiles of the region are resident
+     */
+    bool update(const Vector2f &min, const Vector2f &max, float scale);
+
+    /// Return the number of tiles currently held by the cache
+    size_t resident_tiles() const { return m_resident.size(); }
+
+    /// Return the number of requested tiles that have not been loaded yet
+    size_t pending_tiles() const;
+
+    /// Return the texture holding the cached tiles
+    Texture *cache_texture() { return m_cache.get(); }
+
+    /// Return the texture mapping level 0 tiles to cache slots
+    Texture *indirection_texture() { return m_indirection.get(); }
+
+    /// Release all resources
+    virtual ~TiledImage();
+
+protected:
+    struct Slot {
+        uint64_t key = 0;
+        uint64_t last_use = 0;
+        bool used = false;
+    };
+
+    /// State shared with the loader thread
+    struct LoaderState;
+
+    static uint64_t tile_key(uint32_t level, const Vector2i &tile) {
+        return ((uint64_t) level << 48) | ((uint64_t) (uint32_t) tile.y() << 24) |
+               (uint64_t) (uint32_t) tile.x();
+    }
+
+    /// Body of the threads that run the tile loader
+    static void loader_thread(std::shared_ptr<LoaderState> state);
+
+    /// Upload a loaded tile into a free or least recently used slot
+    void insert_tile(uint64_t key, const uint8_t *data);
+
+    /// Recompute and upload the indirection texture for the given target level
+    void update_indirection(uint32_t level);
+
+protected:
+    Vector2i m_size;
+    int m_tile_size;
+    uint32_t m_level_count;
+    Vector2i m_cache_size;
+    ref<Texture> m_cache;
+    ref<Texture> m_indirection;
+    std::vector<Slot> m_slots;
+    /// Maps tile keys to slot indices
+    std::unordered_map<uint64_t, uint32_t> m_resident;
+    /// Tiles that the loader failed to produce (these are not requested again)
+    std::unordered_set<uint64_t> m_failed;
+    std::vector<uint8_t> m_indirection_data;
+    std::shared_ptr<LoaderState> m_loader;
+    uint64_t m_frame = 0;
+    uint32_t m_indirection_level = (uint32_t) -1;
+    bool m_indirection_dirty = true;
+};
+
+NAMESPACE_END(nanogui)
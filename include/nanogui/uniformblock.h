@@ -0,0 +1,153 @@
+/*
+    nanogui/uniformblock.h -- std140 uniform buffer that can be shared
+    by several shaders
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+/** \file */
+
+#pragma once
+
+#include <nanogui/object.h>
+#include <nanogui/traits.h>
+#include <unordered_map>
+
+NAMESPACE_BEGIN(nanogui)
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+
+/**
+ * \class UniformBlock uniformblock.h nanogui/uniformblock.h
+ *
+ * \brief CPU mirror of a GLSL uniform block that is stored in a uniform
+ * buffer object and can be shared by any number of shaders.
+ *
+ * The layout (member offsets and strides) is queried from a shader that
+ * declares the block. Blocks should be declared with
+ * <tt>layout(std140)</tt>, which guarantees an identical layout in every
+ * shader that uses the same declaration. Member updates only modify the
+ * CPU copy; the modified byte range is uploaded using a single
+ * <tt>glBufferSubData()</tt> call by \ref upload(), which \ref
+ * Shader::begin() invokes automatically.
+ *
+ * Each block owns a dedicated uniform buffer binding point, hence the
+ * buffer stays bound while switching between shaders. Uniform blocks
+ * require OpenGL 3.1 or OpenGL ES 3.
+ */
+class NANOGUI_EXPORT UniformBlock : public Object {
+public:
+    /**
+     * \brief Allocate a uniform buffer matching a block declared by a shader
+     *
+     * \param shader
+     *     A shader that declares the block
+     *
+     * \param name
+     *     The name of the block (not of its instance)
+     */
+    UniformBlock(Shader *shader, const std::string &name);
+
+    /// Return the name of the block
+    const std::string &name() const { return m_name; }
+
+    /// Return the size of the block in bytes
+    size_t size() const { return m_data.size(); }
+
+    /// Return the uniform buffer binding point used by this block
+    uint32_t binding() const { return m_binding; }
+
+    /// Return the OpenGL handle of the uniform buffer
+    uint32_t buffer_handle() const { return m_buffer_handle; }
+
+    /// Does the block have a member with the given name?
+    bool has_member(const std::string &name) const {
+        return m_members.find(name) != m_members.end();
+    }
+
+    /**
+     * \brief Write a member of the block (into the CPU copy)
+     *
+     * Matrices should be specified in column-major order. Arrays of
+     * scalars and vectors are indexed by the first dimension of \c shape.
+     */
+    void set_member(const std::string &name, VariableType dtype, size_t ndim,
+                    const size_t *shape, const void *data);
+
+    /// Write a scalar, vector, or matrix member of the block (into the CPU copy)
+    template <typename Array> void set_uniform(const std::string &name,
+                                               const Array &value) {
+        size_t shape[3] = { 1, 1, 1 };
+        size_t ndim = (size_t) -1;
+        const void *data;
+        VariableType vtype = VariableType::Invalid;
+
+        if constexpr (std::is_scalar_v<Array>) {
+            data = &value;
+            ndim = 0;
+            vtype = get_type<Array>();
+        } else if constexpr (is_nanogui_array_v<Array>) {
+            data = value.v;
+            ndim = 1;
+            shape[0] = Array::Size;
+            vtype = get_type<typename Array::Value>();
+        } else if constexpr (is_nanogui_matrix_v<Array>) {
+            data = value.m;
+            ndim = 2;
+            shape[0] = Array::Size;
+            shape[1] = Array::Size;
+            vtype = get_type<typename Array::Value>();
+        }
+
+        if (ndim == (size_t) -1)
+            throw std::runtime_error("UniformBlock::set_uniform(): invalid input array dimension!");
+
+        set_member(name, vtype, ndim, shape, data);
+    }
+
+    /// Return the CPU copy of the block
+    const uint8_t *data() const { return m_data.data(); }
+
+    /// Upload the modified part of the block (if any) to the uniform buffer
+    void upload();
+
+    /**
+     * \brief Bind the uniform buffer to its binding point
+     *
+     * This happens automatically when the block is created or uploaded,
+     * and only needs to be repeated when other code changed the binding.
+     */
+    void bind();
+
+    /// Release all resources
+    virtual ~UniformBlock();
+
+protected:
+    struct Member {
+        size_t offset;
+        VariableType dtype;
+        /// Number of rows and columns (1 for scalars)
+        size_t rows, cols;
+        /// Array length (1 for non-array members)
+        size_t count;
+        size_t array_stride;
+        size_t matrix_stride;
+    };
+
+protected:
+    std::string m_name;
+    std::unordered_map<std::string, Member> m_members;
+    std::vector<uint8_t> m_data;
+    /// Byte range that changed since the last upload
+    size_t m_dirty_begin, m_dirty_end;
+    uint32_t m_buffer_handle = 0;
+    uint32_t m_binding = 0;
+};
+
+#endif
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,42 @@
+#include <metal_stdlib>
+
+using namespace metal;
+
+struct VertexOut {
+    float4 position_image [[position]];
+    float2 position_background;
+    float2 uv;
+};
+
+fragment float4 fragment_main(VertexOut vert [[stage_in]],
+                              texture2d<float, access::sample> image,
+                              texture2d<float, access::sample> indirection,
+                              constant float4 &background_color,
+                              constant float2 &image_size,
+                              constant float2 &indirection_size,
+                              constant float2 &cache_size,
+                              constant float &tile_size,
+                              sampler image_sampler,
+                              sampler indirection_sampler) {
+    float2 frac = vert.position_background - floor(vert.position_background);
+    float checkerboard = ((frac.x > .5f) == (frac.y > .5f)) ? .4f : .5f;
+
+    float4 background = (1.f - background_color.a) * float4(float3(checkerboard), 1.f) +
+                                background_color.a * float4(background_color.rgb, 1.f);
+
+    /* Look up the cache slot and pyramid level that provide this tile */
+    float2 texel = vert.uv * image_size;
+    float4 entry = floor(indirection.sample(indirection_sampler,
+                                            (floor(texel / tile_size) + .5f) /
+                                            indirection_size) * 255.f + .5f);
+
+    float4 value = float4(0.f);
+    if (entry.a > 0.f) {
+        float2 level_texel = texel / exp2(entry.b);
+        float2 local = clamp(level_texel - floor(level_texel / tile_size) * tile_size,
+                             float2(.5f), float2(tile_size - .5f));
+        value = image.sample(image_sampler, (entry.rg * tile_size + local) / cache_size);
+    }
+
+    return (1.f - value.a) * background + value.a * float4(value.rgb, 1.f);
+}
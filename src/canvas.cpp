@@ -16,27 +16,63 @@
 #include <nanogui/canvas.h>
 #include <nanogui/texture.h>
 #include <nanogui/renderpass.h>
+#include <nanogui/rendergraph.h>
 #include <nanogui/theme.h>
 #include <nanogui/opengl.h>
 #include "opengl_check.h"
+#include <algorithm>
+#include <map>
+
+#if defined(NANOGUI_USE_OPENGL)
+#  define NANOVG_GL3
+#  include <nanovg_gl.h>
+#elif defined(NANOGUI_USE_GLES)
+#  define NANOVG_GLES2
+#  include <nanovg_gl.h>
+#elif defined(NANOGUI_USE_METAL)
+#  include <nanovg_mtl.h>
+#endif
+
+#if defined(NANOGUI_USE_GLES) && !defined(GL_MAX_SAMPLES)
+#  define GL_MAX_SAMPLES 0x8D57
+#endif
 
 NAMESPACE_BEGIN(nanogui)
 
+extern std::map<GLFWwindow *, Screen *> __nanogui_screens;
+
 Canvas::Canvas(Widget *parent, uint8_t samples,
                bool has_depth_buffer, bool has_stencil_buffer,
-               bool clear)
+               bool clear, bool implicit_resolve)
     : Widget(parent), m_draw_border(true) {
     m_size = Vector2i(250, 250);
     m_border_color = m_theme->m_border_light;
 
-#if defined(NANOGUI_USE_GLES)
-    samples = 1;
-#endif
-
     Screen *scr = screen();
     if (scr == nullptr)
         throw std::runtime_error("Canvas::Canvas(): could not find parent screen!");
 
+#if defined(NANOGUI_USE_GLES)
+    /* Tile-based GPUs can keep the samples in tile memory and only write
+       the resolved pixels back. GLES 3 can otherwise resolve multisampled
+       render buffers using a blit, which GLES 2 lacks */
+    m_implicit_resolve = implicit_resolve && samples > 1 &&
+                         Texture::implicit_resolve_supported();
+#  if NANOGUI_GLES_VERSION == 2
+    if (!m_implicit_resolve)
+        samples = 1;
+#  endif
+    if (samples > 1) {
+        GLint max_samples = 1;
+        CHK(glGetIntegerv(GL_MAX_SAMPLES, &max_samples));
+        samples = (uint8_t) std::max(1, std::min((int) samples, (int) max_samples));
+        if (samples == 1)
+            m_implicit_resolve = false;
+    }
+#else
+    (void) implicit_resolve;
+#endif
+
     m_render_to_texture = samples != 1
         || (has_depth_buffer && !scr->has_depth_buffer())
         || (has_stencil_buffer && !scr->has_stencil_buffer());
@@ -58,6 +94,18 @@ Canvas::Canvas(Widget *parent, uint8_t samples,
 #endif
         }
     } else {
+        /* Single-sample contents are composited by NanoVG when the canvas
+           is deferred, hence they must be readable by shaders */
+        uint8_t color_flags = Texture::TextureFlags::RenderTarget;
+        if (samples == 1 || m_implicit_resolve)
+            color_flags |= Texture::TextureFlags::ShaderRead;
+
+        uint8_t depth_flags = Texture::TextureFlags::RenderTarget;
+        if (m_implicit_resolve) {
+            color_flags |= Texture::TextureFlags::ImplicitResolve;
+            depth_flags |= Texture::TextureFlags::ImplicitResolve;
+        }
+
         color_texture = new Texture(
             scr->pixel_format(),
             scr->component_format(),
@@ -66,14 +114,11 @@ Canvas::Canvas(Widget *parent, uint8_t samples,
             Texture::InterpolationMode::Bilinear,
             Texture::WrapMode::ClampToEdge,
             samples,
-            Texture::TextureFlags::RenderTarget
+            color_flags
         );
 
-#if defined(NANOGUI_USE_METAL)
-        Texture *color_texture_resolved = nullptr;
-
-        if (samples > 1) {
-            color_texture_resolved = new Texture(
+        if (samples > 1 && !m_implicit_resolve) {
+            Texture *color_texture_resolved = new Texture(
                 scr->pixel_format(),
                 scr->component_format(),
                 m_size,
@@ -81,6 +126,7 @@ Canvas::Canvas(Widget *parent, uint8_t samples,
                 Texture::InterpolationMode::Bilinear,
                 Texture::WrapMode::ClampToEdge,
                 1,
+                Texture::TextureFlags::ShaderRead |
                 Texture::TextureFlags::RenderTarget
             );
 
@@ -88,7 +134,6 @@ Canvas::Canvas(Widget *parent, uint8_t samples,
                 { color_texture_resolved }
             );
         }
-#endif
 
         depth_texture = new Texture(
             has_stencil_buffer ? Texture::PixelFormat::DepthStencil
@@ -99,7 +144,7 @@ Canvas::Canvas(Widget *parent, uint8_t samples,
             Texture::InterpolationMode::Bilinear,
             Texture::WrapMode::ClampToEdge,
             samples,
-            Texture::TextureFlags::RenderTarget
+            depth_flags
         );
     }
 
@@ -107,17 +152,21 @@ Canvas::Canvas(Widget *parent, uint8_t samples,
         { color_texture },
         depth_texture,
         has_stencil_buffer ? depth_texture : nullptr,
-#if defined(NANOGUI_USE_METAL)
         m_render_pass_resolved,
-#else
-        nullptr,
-#endif
         clear
     );
+
+    /* The depth and stencil contents of an offscreen canvas are not needed
+       after drawing, which spares tile-based GPUs from writing them back */
+    if (m_render_to_texture) {
+        m_render_pass->set_store_action(0, RenderPass::StoreAction::Discard);
+        m_render_pass->set_store_action(1, RenderPass::StoreAction::Discard);
+    }
 }
 
 void Canvas::set_background_color(const Color &background_color) {
     m_render_pass->set_clear_color(0, background_color);
+    m_dirty = true;
 }
 
 const Color& Canvas::background_color() const {
@@ -126,19 +175,38 @@ const Color& Canvas::background_color() const {
 
 void Canvas::draw_contents() { /* No-op. */ }
 
-void Canvas::draw(NVGcontext *ctx) {
+void Canvas::mark_dirty() {
+    m_dirty = true;
     Screen *scr = screen();
-    if (scr == nullptr)
-        throw std::runtime_error("Canvas::draw(): could not find parent screen!");
+    if (scr)
+        scr->redraw();
+}
 
-    float pixel_ratio = scr->pixel_ratio();
+bool Canvas::needs_render(const Vector2i &fbsize) {
+    if (m_cached && !m_dirty && fbsize == m_cached_size)
+        return false;
+    m_dirty = false;
+    m_cached_size = fbsize;
+    return true;
+}
 
-    Widget::draw(ctx);
+void Canvas::add_dependency(Canvas *canvas) {
+    m_dependencies.push_back(canvas->render_pass());
+}
+
+Texture *Canvas::texture() {
+    if (!m_render_to_texture)
+        return nullptr;
+    RenderPass *rp = m_render_pass_resolved ? m_render_pass_resolved : m_render_pass;
+    return dynamic_cast<Texture *>(rp->targets()[2]);
+}
 
-    scr->nvg_flush();
+void Canvas::framebuffer_region(Vector2i &fbsize, Vector2i &offset) {
+    Screen *scr = screen();
+    float pixel_ratio = scr->pixel_ratio();
 
-    Vector2i fbsize = m_size;
-    Vector2i offset = absolute_position();
+    fbsize = m_size;
+    offset = absolute_position();
     if (m_draw_border)
         fbsize -= 2;
 
@@ -152,21 +220,147 @@ void Canvas::draw(NVGcontext *ctx) {
 
     fbsize = Vector2i(Vector2f(fbsize) * pixel_ratio);
     offset = Vector2i(Vector2f(offset) * pixel_ratio);
+}
 
-    if (m_render_to_texture) {
+void Canvas::schedule(RenderGraph *graph) {
+    if (!m_render_to_texture || !m_deferred)
+        return;
+
+    Vector2i fbsize, offset;
+    framebuffer_region(fbsize, offset);
+    if (fbsize.x() <= 0 || fbsize.y() <= 0)
+        return;
+
+    // Deferred canvases composite the resolved texture
+    if (m_render_pass->blit_target() != m_render_pass_resolved.get()) {
+        m_render_pass->set_blit_target(m_render_pass_resolved);
+        m_dirty = true;
+    }
+
+    // Cached contents are composited without adding a pass
+    if (needs_render(fbsize)) {
         m_render_pass->resize(fbsize);
-#if defined(NANOGUI_USE_METAL)
         if (m_render_pass_resolved)
             m_render_pass_resolved->resize(fbsize);
+
+        graph->add_pass(m_render_pass, [this]() { draw_contents(); });
+        for (RenderPass *dependency : m_dependencies)
+            graph->add_dependency(m_render_pass, dependency);
+    }
+    m_scheduled = true;
+}
+
+void Canvas::draw(NVGcontext *ctx) {
+    Screen *scr = screen();
+    if (scr == nullptr)
+        throw std::runtime_error("Canvas::draw(): could not find parent screen!");
+
+    Widget::draw(ctx);
+
+    if (m_scheduled) {
+        // The render graph has already rendered the contents, composite them
+        m_scheduled = false;
+
+        Texture *tex = texture();
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+        uintptr_t handle = tex->texture_handle();
+#elif defined(NANOGUI_USE_METAL)
+        uintptr_t handle = (uintptr_t) tex->texture_handle();
 #endif
+        const Vector2i &size = tex->size();
+        if (m_nvg_image) {
+            Vector2i image_size;
+            if (m_nvg_context == ctx)
+                nvgImageSize(ctx, m_nvg_image, &image_size.x(), &image_size.y());
+            if (m_nvg_context != ctx || m_nvg_image_handle != handle || image_size != size) {
+                if (m_nvg_context == ctx)
+                    nvgDeleteImage(ctx, m_nvg_image);
+                m_nvg_image = 0;
+            }
+        }
+
+        if (!m_nvg_image) {
+#if defined(NANOGUI_USE_OPENGL)
+            m_nvg_image = nvglCreateImageFromHandleGL3(
+                ctx, (GLuint) handle, size.x(), size.y(),
+                NVG_IMAGE_NODELETE | NVG_IMAGE_FLIPY | NVG_IMAGE_PREMULTIPLIED);
+#elif defined(NANOGUI_USE_GLES)
+            m_nvg_image = nvglCreateImageFromHandleGLES2(
+                ctx, (GLuint) handle, size.x(), size.y(),
+                NVG_IMAGE_NODELETE | NVG_IMAGE_FLIPY | NVG_IMAGE_PREMULTIPLIED);
+#elif defined(NANOGUI_USE_METAL)
+            (void) size;
+            m_nvg_image = mnvgCreateImageFromHandle(ctx, tex->texture_handle(),
+                                                    NVG_IMAGE_PREMULTIPLIED);
+#endif
+            if (m_nvg_image == 0)
+                throw std::runtime_error("Canvas::draw(): could not create NanoVG image!");
+            m_nvg_context = ctx;
+            m_nvg_image_handle = handle;
+        }
+
+        float x = m_pos.x(), y = m_pos.y(), w = m_size.x(), h = m_size.y();
+        if (m_draw_border) {
+            x += 1.f; y += 1.f;
+            w -= 2.f; h -= 2.f;
+        }
+
+        /* The blit used by inline canvases replaces the pixels. Filling the
+           area with opaque black first and then blending the premultiplied
+           contents on top yields the same colors, while still respecting
+           the NanoVG scissor of the parent widgets */
+        nvgSave(ctx);
+        nvgShapeAntiAlias(ctx, 0);
+        nvgBeginPath(ctx);
+        nvgRect(ctx, x, y, w, h);
+        nvgFillColor(ctx, Color(0, 255));
+        nvgFill(ctx);
+        nvgFillPaint(ctx, nvgImagePattern(ctx, x, y, w, h, 0.f, m_nvg_image, 1.f));
+        nvgFill(ctx);
+        nvgRestore(ctx);
     } else {
-        m_render_pass->resize(scr->framebuffer_size());
-        m_render_pass->set_viewport(offset, fbsize);
-    }
+        scr->nvg_flush();
+
+        Vector2i fbsize, offset;
+        framebuffer_region(fbsize, offset);
+
+#if defined(NANOGUI_USE_OPENGL)
+        /* Resolve the samples directly into the screen below instead of
+           going through the texture that only deferred canvases need. GLES
+           3 only resolves between identical rectangles and formats, hence
+           it keeps resolving into that texture first. */
+        if (m_render_to_texture && m_render_pass->blit_target() != nullptr) {
+            m_render_pass->set_blit_target(nullptr);
+            m_dirty = true;
+        }
+#endif
 
-    m_render_pass->begin();
-    draw_contents();
-    m_render_pass->end();
+        bool render = true;
+        if (m_render_to_texture) {
+            render = needs_render(fbsize);
+            if (render) {
+                m_render_pass->resize(fbsize);
+                if (m_render_pass_resolved)
+                    m_render_pass_resolved->resize(fbsize);
+            }
+        } else {
+            m_render_pass->resize(scr->framebuffer_size());
+            m_render_pass->set_viewport(offset, fbsize);
+        }
+
+        if (render) {
+            m_render_pass->begin();
+            draw_contents();
+            m_render_pass->end();
+        }
+
+        if (m_render_to_texture) {
+            RenderPass *rp = m_render_pass;
+            if (m_render_pass->blit_target() != nullptr)
+                rp = m_render_pass_resolved;
+            rp->blit_to(Vector2i(0, 0), fbsize, scr, offset);
+        }
+    }
 
     if (m_draw_border) {
         nvgBeginPath(ctx);
@@ -177,14 +371,18 @@ void Canvas::draw(NVGcontext *ctx) {
                        m_theme->m_window_corner_radius);
         nvgStroke(ctx);
     }
+}
 
-    if (m_render_to_texture) {
-        RenderPass *rp = m_render_pass;
-#if defined(NANOGUI_USE_METAL)
-        if (m_render_pass_resolved)
-            rp = m_render_pass_resolved;
-#endif
-        rp->blit_to(Vector2i(0, 0), fbsize, scr, offset);
+Canvas::~Canvas() {
+    if (!m_nvg_image)
+        return;
+
+    // The context is gone if the canvas is destroyed along with its screen
+    for (auto &kv : __nanogui_screens) {
+        if (kv.second->nvg_context() == m_nvg_context) {
+            nvgDeleteImage(m_nvg_context, m_nvg_image);
+            break;
+        }
     }
 }
 
@@ -10,6 +10,8 @@
 */
 
 #include <nanogui/screen.h>
+#include <nanogui/texturecache.h>
+#include <nanogui/textureatlas.h>
 
 #if defined(_WIN32)
 #  ifndef NOMINMAX
@@ -20,11 +22,13 @@
 
 #include <nanogui/opengl.h>
 #include <nanogui/metal.h>
+#include <atomic>
 #include <map>
 #include <thread>
 #include <chrono>
 #include <mutex>
 #include <iostream>
+#include <stb_image.h>
 
 #if !defined(_WIN32)
 #  include <locale.h>
@@ -73,7 +77,8 @@ void init() {
     glfwSetTime(0);
 }
 
-static bool mainloop_active = false;
+/* Read by the refresh thread and by async() calls from worker threads */
+static std::atomic<bool> mainloop_active { false };
 
 #if defined(EMSCRIPTEN)
 static double emscripten_last = 0;
@@ -99,11 +104,15 @@ void mainloop(float refresh) {
             }
         #endif
 
-        /* Run async functions */ {
-            std::lock_guard<std::mutex> guard(m_async_mutex);
-            for (auto &f : m_async_functions)
+        /* Run async functions (without holding the lock, so that they
+           can enqueue further work) */ {
+            std::vector<std::function<void()>> functions;
+            {
+                std::lock_guard<std::mutex> guard(m_async_mutex);
+                functions.swap(m_async_functions);
+            }
+            for (auto &f : functions)
                 f();
-            m_async_functions.clear();
         }
 
         for (auto kv : __nanogui_screens) {
@@ -195,8 +204,14 @@ void mainloop(float refresh) {
 }
 
 void async(const std::function<void()> &func) {
-    std::lock_guard<std::mutex> guard(m_async_mutex);
-    m_async_functions.push_back(func);
+    {
+        std::lock_guard<std::mutex> guard(m_async_mutex);
+        m_async_functions.push_back(func);
+    }
+
+    /* Wake up the main loop if it is waiting for events */
+    if (mainloop_active)
+        glfwPostEmptyEvent();
 }
 
 void leave() {
@@ -254,20 +269,12 @@ std::string utf8(uint32_t c) {
 }
 
 int __nanogui_get_image(NVGcontext *ctx, const std::string &name, uint8_t *data, uint32_t size) {
-    static std::map<std::string, int> icon_cache;
-    auto it = icon_cache.find(name);
-    if (it != icon_cache.end())
-        return it->second;
-    int icon_id = nvgCreateImageMem(ctx, 0, data, size);
-    if (icon_id == 0)
-        throw std::runtime_error("Unable to load resource data.");
-    icon_cache[name] = icon_id;
-    return icon_id;
+    return TextureCache::nvg_image(ctx, name, data, size);
 }
 
-std::vector<std::pair<int, std::string>>
-load_image_directory(NVGcontext *ctx, const std::string &path) {
-    std::vector<std::pair<int, std::string> > result;
+/// Return the paths of the PNG images in a directory
+static std::vector<std::string> image_directory_files(const std::string &path) {
+    std::vector<std::string> result;
 #if !defined(_WIN32)
     DIR *dp = opendir(path.c_str());
     if (!dp)
@@ -286,12 +293,7 @@ load_image_directory(NVGcontext *ctx, const std::string &path) {
 #endif
         if (strstr(fname, "png") == nullptr)
             continue;
-        std::string full_name = path + "/" + std::string(fname);
-        int img = nvgCreateImage(ctx, full_name.c_str(), 0);
-        if (img == 0)
-            throw std::runtime_error("Could not open image data!");
-        result.push_back(
-            std::make_pair(img, full_name.substr(0, full_name.length() - 4)));
+        result.push_back(path + "/" + std::string(fname));
 #if !defined(_WIN32)
     }
     closedir(dp);
@@ -302,6 +304,43 @@ load_image_directory(NVGcontext *ctx, const std::string &path) {
     return result;
 }
 
+std::vector<std::pair<int, std::string>>
+load_image_directory(NVGcontext *ctx, const std::string &path) {
+    std::vector<std::pair<int, std::string> > result;
+    for (const std::string &full_name : image_directory_files(path)) {
+        int img = nvgCreateImage(ctx, full_name.c_str(), 0);
+        if (img == 0)
+            throw std::runtime_error("Could not open image data!");
+        result.push_back(
+            std::make_pair(img, full_name.substr(0, full_name.length() - 4)));
+    }
+    return result;
+}
+
+std::vector<std::pair<int, std::string>>
+load_image_directory(TextureAtlas *atlas, const std::string &path) {
+    if (atlas->texture()->pixel_format() != Texture::PixelFormat::RGBA ||
+        atlas->texture()->component_format() != Texture::ComponentFormat::UInt8)
+        throw std::runtime_error("load_image_directory(): the atlas must store RGBA "
+                                 "images with UInt8 components!");
+
+    std::vector<std::pair<int, std::string> > result;
+    for (const std::string &full_name : image_directory_files(path)) {
+        Vector2i size;
+        int n = 0;
+        uint8_t *data = stbi_load(full_name.c_str(), &size.x(), &size.y(), &n, 4);
+        if (!data)
+            throw std::runtime_error("Could not open image data!");
+        int id = atlas->add(data, size);
+        stbi_image_free(data);
+        if (id < 0)
+            throw std::runtime_error("load_image_directory(): the atlas is full!");
+        result.push_back(
+            std::make_pair(id, full_name.substr(0, full_name.length() - 4)));
+    }
+    return result;
+}
+
 std::string file_dialog(const std::vector<std::pair<std::string, std::string>> &filetypes, bool save) {
     auto result = file_dialog(filetypes, save, false);
     return result.empty() ? "" : result.front();
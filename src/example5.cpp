@@ -641,6 +641,9 @@ public:
         glEnable(GL_STENCIL_TEST);
 
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        // The direct OpenGL calls above bypassed NanoGUI's state tracker
+        GLState::current().invalidate();
     }
 
     virtual ~MyTextureCanvas() {
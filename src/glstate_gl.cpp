@@ -0,0 +1,244 @@
+#include <nanogui/glstate.h>
+#include <nanogui/opengl.h>
+#include "opengl_check.h"
+#include <memory>
+#include <unordered_map>
+
+NAMESPACE_BEGIN(nanogui)
+
+/// Trackers of all contexts, and the most recently used one
+static std::unordered_map<GLFWwindow *, std::unique_ptr<GLState>> gl_states;
+static GLFWwindow *gl_state_context = nullptr;
+static GLState *gl_state_cached = nullptr;
+
+static const GLenum gl_capabilities[] = {
+    GL_BLEND,
+    GL_DEPTH_TEST,
+    GL_CULL_FACE,
+    GL_SCISSOR_TEST,
+#if defined(NANOGUI_USE_OPENGL)
+    GL_PROGRAM_POINT_SIZE
+#else
+    0
+#endif
+};
+
+GLState::State::State() {
+    for (size_t i = 0; i < TextureUnits; ++i)
+        textures[i] = -1;
+    for (size_t i = 0; i < (size_t) Capability::Count; ++i)
+        enabled[i] = -1;
+}
+
+GLState &GLState::current() {
+    GLFWwindow *context = glfwGetCurrentContext();
+    if (context == gl_state_context && gl_state_cached)
+        return *gl_state_cached;
+
+    std::unique_ptr<GLState> &state = gl_states[context];
+    if (!state)
+        state.reset(new GLState());
+    gl_state_context = context;
+    gl_state_cached = state.get();
+    return *state;
+}
+
+void GLState::release(void *glfw_window) {
+    if (glfw_window == gl_state_context) {
+        gl_state_context = nullptr;
+        gl_state_cached = nullptr;
+    }
+    gl_states.erase((GLFWwindow *) glfw_window);
+}
+
+void GLState::invalidate(uint32_t categories) {
+    if (categories & Program)
+        m_state.program = -1;
+    if (categories & VertexArray)
+        m_state.vertex_array = -1;
+    if (categories & Framebuffer)
+        m_state.framebuffer = -1;
+    if (categories & Textures) {
+        m_state.active_texture = -1;
+        for (size_t i = 0; i < TextureUnits; ++i)
+            m_state.textures[i] = -1;
+    }
+    if (categories & Capabilities) {
+        for (size_t i = 0; i < (size_t) Capability::Count; ++i)
+            m_state.enabled[i] = -1;
+    }
+    if (categories & Blend)
+        m_state.blend_src = m_state.blend_dst = -1;
+    if (categories & Depth) {
+        m_state.depth_func = -1;
+        m_state.depth_mask = -1;
+    }
+    if (categories & Cull)
+        m_state.cull_face = -1;
+    if (categories & Viewport) {
+        for (int i = 0; i < 4; ++i)
+            m_state.viewport[i] = -1;
+    }
+    if (categories & Scissor) {
+        for (int i = 0; i < 4; ++i)
+            m_state.scissor[i] = -1;
+    }
+}
+
+void GLState::restore(const State &state) {
+    /* Entries that were unknown when the state was recorded (e.g. after
+       NanoVG flushed its draw calls) are reset to the OpenGL defaults
+       instead of keeping whatever a render pass left behind */
+    use_program(state.program >= 0 ? (uint32_t) state.program : 0);
+    bind_vertex_array(state.vertex_array >= 0 ? (uint32_t) state.vertex_array : 0);
+    bind_framebuffer(state.framebuffer >= 0 ? (uint32_t) state.framebuffer : 0);
+    for (size_t i = 0; i < TextureUnits; ++i) {
+        if (state.textures[i] >= 0)
+            bind_texture((uint32_t) i, GL_TEXTURE_2D, (uint32_t) state.textures[i]);
+    }
+    for (size_t i = 0; i < (size_t) Capability::Count; ++i)
+        set_enabled((Capability) i, state.enabled[i] > 0);
+    if (state.blend_src >= 0)
+        blend_func((uint32_t) state.blend_src, (uint32_t) state.blend_dst);
+    else
+        blend_func(GL_ONE, GL_ZERO);
+    depth_func(state.depth_func >= 0 ? (uint32_t) state.depth_func : GL_LESS);
+    depth_mask(state.depth_mask != 0);
+    cull_face(state.cull_face >= 0 ? (uint32_t) state.cull_face : GL_BACK);
+    if (state.viewport[2] >= 0)
+        viewport(state.viewport[0], state.viewport[1], state.viewport[2], state.viewport[3]);
+    if (state.scissor[2] >= 0)
+        scissor(state.scissor[0], state.scissor[1], state.scissor[2], state.scissor[3]);
+}
+
+void GLState::query_rects() {
+    GLint value[4];
+    if (m_state.viewport[2] < 0) {
+        CHK(glGetIntegerv(GL_VIEWPORT, value));
+        for (int i = 0; i < 4; ++i)
+            m_state.viewport[i] = value[i];
+    }
+    if (m_state.scissor[2] < 0) {
+        CHK(glGetIntegerv(GL_SCISSOR_BOX, value));
+        for (int i = 0; i < 4; ++i)
+            m_state.scissor[i] = value[i];
+    }
+}
+
+void GLState::use_program(uint32_t program) {
+    if (track(m_state.program == (int64_t) program))
+        CHK(glUseProgram(program));
+    m_state.program = program;
+}
+
+void GLState::bind_vertex_array(uint32_t vertex_array) {
+#if defined(NANOGUI_USE_OPENGL)
+    if (track(m_state.vertex_array == (int64_t) vertex_array))
+        CHK(glBindVertexArray(vertex_array));
+    m_state.vertex_array = vertex_array;
+#else
+    (void) vertex_array;
+#endif
+}
+
+void GLState::bind_framebuffer(uint32_t framebuffer) {
+    if (track(m_state.framebuffer == (int64_t) framebuffer))
+        CHK(glBindFramebuffer(GL_FRAMEBUFFER, framebuffer));
+    m_state.framebuffer = framebuffer;
+}
+
+void GLState::bind_texture(uint32_t unit, uint32_t target, uint32_t texture) {
+    bool tracked = target == GL_TEXTURE_2D && unit < TextureUnits;
+    if (!track(tracked && m_state.textures[unit] == (int64_t) texture))
+        return;
+
+    if (m_state.active_texture != (int64_t) unit) {
+        CHK(glActiveTexture(GL_TEXTURE0 + unit));
+        m_state.active_texture = unit;
+    }
+    CHK(glBindTexture(target, texture));
+
+    if (tracked)
+        m_state.textures[unit] = texture;
+}
+
+void GLState::set_enabled(Capability capability, bool value) {
+    GLenum cap = gl_capabilities[(size_t) capability];
+    int8_t &entry = m_state.enabled[(size_t) capability];
+    if (cap == 0 || !track(entry == (int8_t) value))
+        return;
+
+    if (value)
+        CHK(glEnable(cap));
+    else
+        CHK(glDisable(cap));
+    entry = (int8_t) value;
+}
+
+void GLState::blend_func(uint32_t src, uint32_t dst) {
+    if (track(m_state.blend_src == (int64_t) src && m_state.blend_dst == (int64_t) dst))
+        CHK(glBlendFunc(src, dst));
+    m_state.blend_src = src;
+    m_state.blend_dst = dst;
+}
+
+void GLState::depth_func(uint32_t func) {
+    if (track(m_state.depth_func == (int64_t) func))
+        CHK(glDepthFunc(func));
+    m_state.depth_func = func;
+}
+
+void GLState::depth_mask(bool value) {
+    if (track(m_state.depth_mask == (int8_t) value))
+        CHK(glDepthMask(value ? GL_TRUE : GL_FALSE));
+    m_state.depth_mask = (int8_t) value;
+}
+
+void GLState::cull_face(uint32_t mode) {
+    if (track(m_state.cull_face == (int64_t) mode))
+        CHK(glCullFace(mode));
+    m_state.cull_face = mode;
+}
+
+void GLState::viewport(int x, int y, int width, int height) {
+    int *v = m_state.viewport;
+    if (track(v[0] == x && v[1] == y && v[2] == width && v[3] == height))
+        CHK(glViewport(x, y, width, height));
+    v[0] = x; v[1] = y; v[2] = width; v[3] = height;
+}
+
+void GLState::scissor(int x, int y, int width, int height) {
+    int *s = m_state.scissor;
+    if (track(s[0] == x && s[1] == y && s[2] == width && s[3] == height))
+        CHK(glScissor(x, y, width, height));
+    s[0] = x; s[1] = y; s[2] = width; s[3] = height;
+}
+
+void GLState::texture_deleted(uint32_t texture) {
+    for (size_t i = 0; i < TextureUnits; ++i) {
+        if (m_state.textures[i] == (int64_t) texture)
+            m_state.textures[i] = -1;
+    }
+}
+
+void GLState::program_deleted(uint32_t program) {
+    if (m_state.program == (int64_t) program)
+        m_state.program = -1;
+}
+
+void GLState::vertex_array_deleted(uint32_t vertex_array) {
+    if (m_state.vertex_array == (int64_t) vertex_array)
+        m_state.vertex_array = -1;
+}
+
+void GLState::framebuffer_deleted(uint32_t framebuffer) {
+    if (m_state.framebuffer == (int64_t) framebuffer)
+        m_state.framebuffer = -1;
+}
+
+void GLState::next_frame() {
+    m_last_frame_stats = m_stats;
+    m_stats = Stats();
+}
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,75 @@
+#include <nanogui/gputimer.h>
+#include <algorithm>
+#include <stdexcept>
+
+NAMESPACE_BEGIN(nanogui)
+
+static std::vector<GPUTimer *> gpu_timers;
+
+GPUTimer::GPUTimer(const std::string &name, size_t window)
+    : m_name(name), m_samples(window) {
+    if (window == 0)
+        throw std::runtime_error("GPUTimer::GPUTimer(): the window must be positive!");
+    gpu_timers.push_back(this);
+}
+
+GPUTimer::~GPUTimer() {
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    release_queries();
+#endif
+    gpu_timers.erase(std::remove(gpu_timers.begin(), gpu_timers.end(), this),
+                     gpu_timers.end());
+}
+
+const std::vector<GPUTimer *> &GPUTimer::timers() {
+    return gpu_timers;
+}
+
+GPUTimer::Stats GPUTimer::stats() const {
+#if defined(NANOGUI_USE_METAL)
+    std::lock_guard<std::mutex> guard(m_mutex);
+#endif
+    return m_stats;
+}
+
+void GPUTimer::reset() {
+#if defined(NANOGUI_USE_METAL)
+    std::lock_guard<std::mutex> guard(m_mutex);
+#endif
+    m_sample_count = m_sample_next = 0;
+    m_stats = Stats();
+}
+
+void GPUTimer::add_sample(float ms) {
+#if defined(NANOGUI_USE_METAL)
+    // Completion handlers of Metal command buffers run on another thread
+    std::lock_guard<std::mutex> guard(m_mutex);
+#endif
+    m_samples[m_sample_next] = ms;
+    m_sample_next = (m_sample_next + 1) % m_samples.size();
+    m_sample_count = std::min(m_sample_count + 1, m_samples.size());
+
+    Stats stats;
+    stats.last = ms;
+    stats.samples = m_sample_count;
+    stats.minimum = stats.maximum = ms;
+    float sum = 0.f;
+    for (size_t i = 0; i < m_sample_count; ++i) {
+        float value = m_samples[i];
+        sum += value;
+        stats.minimum = std::min(stats.minimum, value);
+        stats.maximum = std::max(stats.maximum, value);
+    }
+    stats.average = sum / (float) m_sample_count;
+    m_stats = stats;
+}
+
+#if defined(NANOGUI_USE_METAL)
+bool GPUTimer::supported() {
+    return true;
+}
+
+void GPUTimer::poll_all() { }
+#endif
+
+NAMESPACE_END(nanogui)
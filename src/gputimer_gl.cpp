@@ -0,0 +1,157 @@
+#include <nanogui/gputimer.h>
+#include <nanogui/opengl.h>
+#include "opengl_check.h"
+#include "opengl_ext.h"
+
+#if !defined(GL_TIMESTAMP)
+#  define GL_TIMESTAMP 0x8E28
+#endif
+#if !defined(GL_QUERY_RESULT)
+#  define GL_QUERY_RESULT 0x8866
+#endif
+#if !defined(GL_QUERY_RESULT_AVAILABLE)
+#  define GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
+
+NAMESPACE_BEGIN(nanogui)
+
+bool GPUTimer::supported() {
+    // Timers query this whenever they start, avoid repeating the glGet calls
+    static GLFWwindow *cached_context = nullptr;
+    static bool cached_result = false;
+    GLFWwindow *context = glfwGetCurrentContext();
+    if (context && context == cached_context)
+        return cached_result;
+
+#if defined(NANOGUI_USE_GLES)
+    bool result = gl_disjoint_timer_query() != nullptr;
+#else
+    GLint major = 0, minor = 0;
+    CHK(glGetIntegerv(GL_MAJOR_VERSION, &major));
+    CHK(glGetIntegerv(GL_MINOR_VERSION, &minor));
+    bool result = major > 3 || (major == 3 && minor >= 3) ||
+                  glfwExtensionSupported("GL_ARB_timer_query");
+#endif
+
+    cached_context = context;
+    cached_result = result;
+    return result;
+}
+
+void GPUTimer::poll_all() {
+    void *context = glfwGetCurrentContext();
+    bool disjoint = false, queried = false;
+
+    for (GPUTimer *timer : timers()) {
+        if (!timer->m_queries[0] || timer->m_context != context)
+            continue;
+        // The disjoint flag is reset when read, share it between all timers
+        if (!queried) {
+            disjoint = query_disjoint();
+            queried = true;
+        }
+        timer->poll(disjoint);
+    }
+}
+
+bool GPUTimer::query_disjoint() {
+#if defined(NANOGUI_USE_GLES)
+    GLint disjoint = 0;
+    CHK(glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint));
+    return disjoint != 0;
+#else
+    return false;
+#endif
+}
+
+void GPUTimer::begin() {
+    if (m_active)
+        throw std::runtime_error("GPUTimer::begin(): a measurement is already in progress!");
+
+    if (!m_queries[0]) {
+        if (!supported())
+            return;
+#if defined(NANOGUI_USE_GLES)
+        CHK(gl_disjoint_timer_query()->gen_queries((GLsizei) (2 * QueryCount), m_queries));
+#else
+        CHK(glGenQueries((GLsizei) (2 * QueryCount), m_queries));
+#endif
+        m_context = glfwGetCurrentContext();
+    }
+
+    /* Results are normally collected once per frame by poll_all(), only
+       poll here if the next query pair is still in flight */
+    if (m_pending[m_head])
+        poll(query_disjoint());
+
+    // Skip this measurement rather than waiting for one that is in flight
+    if (m_pending[m_head])
+        return;
+
+#if defined(NANOGUI_USE_GLES)
+    CHK(gl_disjoint_timer_query()->query_counter(m_queries[2 * m_head], GL_TIMESTAMP));
+#else
+    CHK(glQueryCounter(m_queries[2 * m_head], GL_TIMESTAMP));
+#endif
+    m_active = true;
+}
+
+void GPUTimer::end() {
+    if (!m_active)
+        return;
+
+#if defined(NANOGUI_USE_GLES)
+    CHK(gl_disjoint_timer_query()->query_counter(m_queries[2 * m_head + 1], GL_TIMESTAMP));
+#else
+    CHK(glQueryCounter(m_queries[2 * m_head + 1], GL_TIMESTAMP));
+#endif
+    m_pending[m_head] = true;
+    m_head = (m_head + 1) % QueryCount;
+    m_active = false;
+}
+
+void GPUTimer::poll(bool disjoint) {
+    // Results that overlap a disjoint event are invalid
+#if defined(NANOGUI_USE_GLES)
+    const GLDisjointTimerQuery *ext = gl_disjoint_timer_query();
+#endif
+    while (m_pending[m_tail]) {
+        GLuint available = 0;
+        uint64_t start = 0, end = 0;
+#if defined(NANOGUI_USE_GLES)
+        CHK(ext->get_query_objectuiv(m_queries[2 * m_tail + 1], GL_QUERY_RESULT_AVAILABLE,
+                                     &available));
+        if (!available)
+            break;
+        CHK(ext->get_query_objectui64v(m_queries[2 * m_tail], GL_QUERY_RESULT, &start));
+        CHK(ext->get_query_objectui64v(m_queries[2 * m_tail + 1], GL_QUERY_RESULT, &end));
+#else
+        CHK(glGetQueryObjectuiv(m_queries[2 * m_tail + 1], GL_QUERY_RESULT_AVAILABLE,
+                                &available));
+        if (!available)
+            break;
+        CHK(glGetQueryObjectui64v(m_queries[2 * m_tail], GL_QUERY_RESULT, &start));
+        CHK(glGetQueryObjectui64v(m_queries[2 * m_tail + 1], GL_QUERY_RESULT, &end));
+#endif
+        m_pending[m_tail] = false;
+        m_tail = (m_tail + 1) % QueryCount;
+
+        if (!disjoint && end >= start)
+            add_sample((float) ((end - start) * 1e-6));
+    }
+}
+
+void GPUTimer::release_queries() {
+    if (!m_queries[0])
+        return;
+#if defined(NANOGUI_USE_GLES)
+    CHK(gl_disjoint_timer_query()->delete_queries((GLsizei) (2 * QueryCount), m_queries));
+#else
+    CHK(glDeleteQueries((GLsizei) (2 * QueryCount), m_queries));
+#endif
+    for (size_t i = 0; i < 2 * QueryCount; ++i)
+        m_queries[i] = 0;
+    m_context = nullptr;
+}
+
+NAMESPACE_END(nanogui)
@@ -70,7 +70,17 @@ void ImagePanel::draw(NVGcontext* ctx) {
             Vector2i((int) i % grid.x(), (int) i / grid.x()) * (m_thumb_size + m_spacing);
         int imgw, imgh;
 
-        nvgImageSize(ctx, m_images[i].first, &imgw, &imgh);
+        if (m_atlas) {
+            // The atlas may have evicted this image to make room for others
+            if (!m_atlas->contains(m_images[i].first))
+                continue;
+
+            Vector2i region_size = m_atlas->region_size(m_images[i].first);
+            imgw = region_size.x();
+            imgh = region_size.y();
+        } else {
+            nvgImageSize(ctx, m_images[i].first, &imgw, &imgh);
+        }
         float iw, ih, ix, iy;
         if (imgw < imgh) {
             iw = m_thumb_size;
@@ -84,9 +94,20 @@ void ImagePanel::draw(NVGcontext* ctx) {
             iy = 0;
         }
 
-        NVGpaint img_paint = nvgImagePattern(
-            ctx, p.x() + ix, p.y()+ iy, iw, ih, 0, m_images[i].first,
-            m_mouse_index == (int)i ? 1.0 : 0.7);
+        NVGpaint img_paint;
+        float alpha = m_mouse_index == (int) i ? 1.0f : 0.7f;
+        if (m_atlas) {
+            /* Stretch the whole atlas so that the region covers the
+               thumbnail, which lets all thumbnails share one texture */
+            Vector4f uv = m_atlas->uv(m_images[i].first);
+            float sx = iw / (uv[2] - uv[0]), sy = ih / (uv[3] - uv[1]);
+            img_paint = nvgImagePattern(
+                ctx, p.x() + ix - uv[0] * sx, p.y() + iy - uv[1] * sy, sx, sy, 0,
+                m_atlas->nvg_image(ctx), alpha);
+        } else {
+            img_paint = nvgImagePattern(
+                ctx, p.x() + ix, p.y()+ iy, iw, ih, 0, m_images[i].first, alpha);
+        }
 
         nvgBeginPath(ctx);
         nvgRoundedRect(ctx, p.x(), p.y(), m_thumb_size, m_thumb_size, 5);
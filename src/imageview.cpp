@@ -19,25 +19,26 @@
 
 NAMESPACE_BEGIN(nanogui)
 
+static const float quad_positions[] = {
+    0.f, 0.f, 1.f, 0.f, 0.f, 1.f,
+    1.f, 0.f, 1.f, 1.f, 0.f, 1.f
+};
+
 ImageView::ImageView(Widget *parent) : Canvas(parent, 1, false, false, false) {
     render_pass()->set_clear_color(0, Color(0.3f, 0.3f, 0.32f, 1.f));
 
+    /* Compile in the background while the rest of the application is set
+       up. The widget shows its background color until the shader is ready. */
     m_image_shader = new Shader(
         render_pass(),
         /* An identifying name */
         "a_simple_shader",
         NANOGUI_SHADER(imageview_vertex),
         NANOGUI_SHADER(imageview_fragment),
-        Shader::BlendMode::AlphaBlend
+        Shader::BlendMode::AlphaBlend,
+        true
     );
 
-    const float positions[] = {
-        0.f, 0.f, 1.f, 0.f, 0.f, 1.f,
-        1.f, 0.f, 1.f, 1.f, 0.f, 1.f
-    };
-
-    m_image_shader->set_buffer("position", VariableType::Float32, { 6, 2 },
-                               positions);
     m_render_pass->set_cull_mode(RenderPass::CullMode::Disabled);
 
     m_image_border_color = m_theme->m_border_dark;
@@ -49,8 +50,52 @@ void ImageView::set_image(Texture *image) {
     if (image->mag_interpolation_mode() != Texture::InterpolationMode::Nearest)
         throw std::runtime_error(
             "ImageView::set_image(): interpolation mode must be set to 'Nearest'!");
-    m_image_shader->set_texture("image", image);
+    if (m_image_shader_ready)
+        m_image_shader->set_texture("image", image);
     m_image = image;
+    m_tiled_image = nullptr;
+}
+
+void ImageView::set_tiled_image(TiledImage *image) {
+    if (!m_tiled_shader) {
+        m_tiled_shader = new Shader(
+            render_pass(),
+            "imageview_tiled",
+            NANOGUI_SHADER(imageview_vertex),
+            NANOGUI_SHADER(imageview_tiled_fragment),
+            Shader::BlendMode::AlphaBlend
+        );
+
+        m_tiled_shader->set_buffer("position", VariableType::Float32, { 6, 2 },
+                                   quad_positions);
+    }
+
+    m_tiled_shader->set_texture("image", image->cache_texture());
+    m_tiled_shader->set_texture("indirection", image->indirection_texture());
+    m_tiled_image = image;
+    m_image = nullptr;
+}
+
+bool ImageView::prepare_image_shader() {
+    if (m_image_shader_ready)
+        return true;
+    if (!m_image_shader->ready())
+        return false;
+
+    m_image_shader->set_buffer("position", VariableType::Float32, { 6, 2 },
+                               quad_positions);
+    if (m_image)
+        m_image_shader->set_texture("image", m_image);
+    m_image_shader_ready = true;
+    return true;
+}
+
+Vector2i ImageView::image_size() const {
+    if (m_tiled_image)
+        return m_tiled_image->size();
+    else if (m_image)
+        return m_image->size();
+    return Vector2i(0);
 }
 
 float ImageView::scale() const {
@@ -62,9 +107,9 @@ void ImageView::set_scale(float scale) {
 }
 
 void ImageView::center() {
-    if (!m_image)
+    if (!m_image && !m_tiled_image)
         return;
-    m_offset = Vector2i(.5f * (Vector2f(m_size) * screen()->pixel_ratio() - Vector2f(m_image->size()) * scale()));
+    m_offset = Vector2i(.5f * (Vector2f(m_size) * screen()->pixel_ratio() - Vector2f(image_size()) * scale()));
 }
 
 void ImageView::reset() {
@@ -87,7 +132,7 @@ Vector2f ImageView::pixel_to_pos(const Vector2f &p) const {
 }
 
 bool ImageView::keyboard_event(int key, int /* scancode */, int action, int /* modifiers */) {
-    if (!m_enabled || !m_image)
+    if (!m_enabled || (!m_image && !m_tiled_image))
         return false;
 
     if (action == GLFW_PRESS) {
@@ -101,7 +146,7 @@ bool ImageView::keyboard_event(int key, int /* scancode */, int action, int /* m
 
 bool ImageView::mouse_drag_event(const Vector2i & /* p */, const Vector2i &rel,
                                  int /* button */, int /* modifiers */) {
-    if (!m_enabled || !m_image)
+    if (!m_enabled || (!m_image && !m_tiled_image))
         return false;
 
     m_offset += rel * screen()->pixel_ratio();
@@ -110,7 +155,7 @@ bool ImageView::mouse_drag_event(const Vector2i & /* p */, const Vector2i &rel,
 }
 
 bool ImageView::scroll_event(const Vector2i &p, const Vector2f &rel) {
-    if (!m_enabled || !m_image)
+    if (!m_enabled || (!m_image && !m_tiled_image))
         return false;
 
     Vector2f p1 = pos_to_pixel(p - m_pos);
@@ -118,8 +163,8 @@ bool ImageView::scroll_event(const Vector2i &p, const Vector2f &rel) {
 
     // Restrict scaling to a reasonable range
     m_scale = std::max(
-        m_scale, std::min(0.f, std::log2(40.f / std::max(m_image->size().x(),
-                                                         m_image->size().y())) * 5.f));
+        m_scale, std::min(0.f, std::log2(40.f / std::max(image_size().x(),
+                                                         image_size().y())) * 5.f));
     m_scale = std::min(m_scale, 45.f);
 
     Vector2f p2 = pos_to_pixel(p - m_pos);
@@ -128,13 +173,13 @@ bool ImageView::scroll_event(const Vector2i &p, const Vector2f &rel) {
 }
 
 void ImageView::draw(NVGcontext *ctx) {
-    if (!m_enabled || !m_image)
+    if (!m_enabled || (!m_image && !m_tiled_image))
         return;
 
     Canvas::draw(ctx);
 
     Vector2i top_left = Vector2i(pixel_to_pos(Vector2f(0.f, 0.f))),
-             size     = Vector2i(pixel_to_pos(Vector2f(m_image->size())) - Vector2f(top_left));
+             size     = Vector2i(pixel_to_pos(Vector2f(image_size())) - Vector2f(top_left));
 
     if (m_draw_image_border) {
         nvgBeginPath(ctx);
@@ -157,7 +202,7 @@ void ImageView::draw(NVGcontext *ctx) {
         nvgTextAlign(ctx, NVG_ALIGN_CENTER | NVG_ALIGN_MIDDLE);
 
         Vector2i start = max(Vector2i(0), Vector2i(pos_to_pixel(Vector2f(0.f, 0.f))) - 1),
-                 end   = min(Vector2i(pos_to_pixel(Vector2f(m_size))) + 1, m_image->size() - 1);
+                 end   = min(Vector2i(pos_to_pixel(Vector2f(m_size))) + 1, image_size() - 1);
 
         char text_buf[80],
             *text[4] = { text_buf, text_buf + 20, text_buf + 40, text_buf + 60 };
@@ -192,15 +237,23 @@ void ImageView::draw(NVGcontext *ctx) {
 }
 
 void ImageView::draw_contents() {
-    if (!m_image)
+    if (!m_image && !m_tiled_image)
         return;
 
+    if (!m_tiled_image && !prepare_image_shader()) {
+        // Check again during the next frame
+        screen()->redraw();
+        return;
+    }
+
+    Vector2i image_size = this->image_size();
+
     /* Ensure that 'offset' is a multiple of the pixel ratio */
     float pixel_ratio = screen()->pixel_ratio();
     m_offset = (Vector2f(Vector2i(m_offset / pixel_ratio)) * pixel_ratio);
 
     Vector2f bound1 = Vector2f(m_size) * pixel_ratio,
-             bound2 = -Vector2f(m_image->size()) * scale();
+             bound2 = -Vector2f(image_size) * scale();
 
     if ((m_offset.x() >= bound1.x()) != (m_offset.x() < bound2.x()))
         m_offset.x() = std::max(std::min(m_offset.x(), bound1.x()), bound2.x());
@@ -212,22 +265,36 @@ void ImageView::draw_contents() {
     float scale = std::pow(2.f, m_scale / 5.f);
 
     Matrix4f matrix_background =
-        Matrix4f::scale(Vector3f(m_image->size().x() * scale / 20.f,
-                                 m_image->size().y() * scale / 20.f, 1.f));
+        Matrix4f::scale(Vector3f(image_size.x() * scale / 20.f,
+                                 image_size.y() * scale / 20.f, 1.f));
 
     Matrix4f matrix_image =
         Matrix4f::ortho(0.f, viewport_size.x(), viewport_size.y(), 0.f, -1.f, 1.f) *
         Matrix4f::translate(Vector3f(m_offset.x(), (int) m_offset.y(), 0.f)) *
-        Matrix4f::scale(Vector3f(m_image->size().x() * scale,
-                                 m_image->size().y() * scale, 1.f));
+        Matrix4f::scale(Vector3f(image_size.x() * scale,
+                                 image_size.y() * scale, 1.f));
+
+    Shader *shader = m_image_shader;
+    if (m_tiled_image) {
+        /* Page in the tiles of the visible region. Finished tiles trigger a
+           redraw, and coarser levels stand in for the missing ones */
+        m_tiled_image->update(pos_to_pixel(Vector2f(0.f)), pos_to_pixel(Vector2f(m_size)),
+                              scale);
+
+        shader = m_tiled_shader;
+        shader->set_uniform("image_size", Vector2f(image_size));
+        shader->set_uniform("indirection_size", Vector2f(m_tiled_image->tile_count(0)));
+        shader->set_uniform("cache_size", Vector2f(m_tiled_image->cache_texture()->size()));
+        shader->set_uniform("tile_size", (float) m_tiled_image->tile_size());
+    }
 
-    m_image_shader->set_uniform("matrix_image",      Matrix4f(matrix_image));
-    m_image_shader->set_uniform("matrix_background", Matrix4f(matrix_background));
-    m_image_shader->set_uniform("background_color",  m_image_background_color);
+    shader->set_uniform("matrix_image",      Matrix4f(matrix_image));
+    shader->set_uniform("matrix_background", Matrix4f(matrix_background));
+    shader->set_uniform("background_color",  m_image_background_color);
 
-    m_image_shader->begin();
-    m_image_shader->draw_array(Shader::PrimitiveType::Triangle, 0, 6, false);
-    m_image_shader->end();
+    shader->begin();
+    shader->draw_array(Shader::PrimitiveType::Triangle, 0, 6, false);
+    shader->end();
 }
 
 NAMESPACE_END(nanogui)
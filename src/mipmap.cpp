@@ -0,0 +1,540 @@
+/*
+    src/mipmap.cpp -- CPU implementation of mip map filters
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/mipmap.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX__)
+#  include <immintrin.h>
+#  define NANOGUI_MIPMAP_AVX
+#endif
+#if defined(__F16C__)
+#  include <immintrin.h>
+#  define NANOGUI_MIPMAP_F16C
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define NANOGUI_MIPMAP_SSE
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#  define NANOGUI_MIPMAP_NEON
+#  if defined(__aarch64__)
+#    define NANOGUI_MIPMAP_NEON_FP16
+#  endif
+#endif
+
+NAMESPACE_BEGIN(nanogui)
+
+uint32_t mipmap_level_count(const Vector2i &size) {
+    uint32_t count = 1;
+    for (int extent = std::max(size.x(), size.y()); extent > 1; extent >>= 1)
+        count++;
+    return count;
+}
+
+Vector2i mipmap_level_size(const Vector2i &size, uint32_t level) {
+    return Vector2i(std::max(1, size.x() >> level), std::max(1, size.y() >> level));
+}
+
+static float srgb_to_linear(float value) {
+    return value <= 0.04045f ? value * (1.f / 12.92f)
+                             : std::pow((value + 0.055f) * (1.f / 1.055f), 2.4f);
+}
+
+static float linear_to_srgb(float value) {
+    return value <= 0.0031308f ? value * 12.92f
+                               : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f;
+}
+
+static float half_to_float(uint16_t value) {
+    uint32_t sign = (uint32_t) (value & 0x8000) << 16,
+             exponent = (value >> 10) & 0x1F,
+             mantissa = value & 0x3FF, bits;
+
+    if (exponent == 0x1F) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    } else if (exponent != 0) {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else if (mantissa != 0) {
+        // Denormal: renormalize the mantissa
+        exponent = 113;
+        while (!(mantissa & 0x400)) {
+            mantissa <<= 1;
+            exponent--;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+    } else {
+        bits = sign;
+    }
+
+    float result;
+    memcpy(&result, &bits, sizeof(float));
+    return result;
+}
+
+static uint16_t float_to_half(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(float));
+
+    uint16_t sign = (uint16_t) ((bits >> 16) & 0x8000);
+    int32_t exponent = (int32_t) ((bits >> 23) & 0xFF) - 112;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    if (((bits >> 23) & 0xFF) == 0xFF) // Inf/NaN
+        return (uint16_t) (sign | 0x7C00 | (mantissa ? 0x200 : 0));
+    if (exponent >= 0x1F) // Overflow
+        return (uint16_t) (sign | 0x7C00);
+    if (exponent <= 0) { // Denormal or zero
+        if (exponent < -10)
+            return sign;
+        mantissa |= 0x800000;
+        uint32_t shift = (uint32_t) (14 - exponent);
+        uint32_t rounded = (mantissa + (1u << (shift - 1))) >> shift;
+        return (uint16_t) (sign | rounded);
+    }
+
+    uint32_t rounded = (((uint32_t) exponent << 10) | (mantissa >> 13)) +
+                       ((mantissa >> 12) & 1);
+    return (uint16_t) (sign | std::min(rounded, (uint32_t) 0x7C00));
+}
+
+/// Lookup tables for 8 bit sRGB data
+struct SRGBTables {
+    float to_linear[256];
+    uint8_t from_linear[4096];
+
+    SRGBTables() {
+        for (int i = 0; i < 256; ++i)
+            to_linear[i] = srgb_to_linear(i / 255.f);
+        for (int i = 0; i < 4096; ++i)
+            from_linear[i] = (uint8_t) std::lround(linear_to_srgb(i / 4095.f) * 255.f);
+    }
+};
+
+static const SRGBTables &srgb_tables() {
+    static SRGBTables tables;
+    return tables;
+}
+
+/// Does channel 'c' hold color (as opposed to alpha) data?
+static bool is_color_channel(size_t c, size_t channels) {
+    return !((channels == 2 || channels == 4) && c == channels - 1);
+}
+
+/// Convert 'count' pixels into linear floating point values
+static void load_row(const uint8_t *src, float *out, size_t count, size_t channels,
+                     VariableType type, bool srgb) {
+    size_t n = count * channels, i = 0;
+
+    if (srgb && type == VariableType::UInt8) {
+        const float *to_linear = srgb_tables().to_linear;
+        for (; i < n; i += channels) {
+            for (size_t c = 0; c < channels; ++c)
+                out[i + c] = is_color_channel(c, channels) ? to_linear[src[i + c]]
+                                                           : src[i + c] * (1.f / 255.f);
+        }
+        return;
+    }
+
+    switch (type) {
+        case VariableType::UInt8: {
+#if defined(NANOGUI_MIPMAP_SSE)
+            const __m128i zero = _mm_setzero_si128();
+            const __m128 scale = _mm_set1_ps(1.f / 255.f);
+            for (; i + 16 <= n; i += 16) {
+                __m128i value = _mm_loadu_si128((const __m128i *) (src + i)),
+                        lo = _mm_unpacklo_epi8(value, zero),
+                        hi = _mm_unpackhi_epi8(value, zero);
+                _mm_storeu_ps(out + i,      _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+                _mm_storeu_ps(out + i + 4,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+                _mm_storeu_ps(out + i + 8,  _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+                _mm_storeu_ps(out + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+            }
+#elif defined(NANOGUI_MIPMAP_NEON)
+            for (; i + 16 <= n; i += 16) {
+                uint8x16_t value = vld1q_u8(src + i);
+                uint16x8_t lo = vmovl_u8(vget_low_u8(value)),
+                           hi = vmovl_u8(vget_high_u8(value));
+                vst1q_f32(out + i,      vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(lo))), 1.f / 255.f));
+                vst1q_f32(out + i + 4,  vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(lo))), 1.f / 255.f));
+                vst1q_f32(out + i + 8,  vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(hi))), 1.f / 255.f));
+                vst1q_f32(out + i + 12, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(hi))), 1.f / 255.f));
+            }
+#endif
+            for (; i < n; ++i)
+                out[i] = src[i] * (1.f / 255.f);
+            break;
+        }
+
+        case VariableType::UInt16: {
+            const uint16_t *src16 = (const uint16_t *) src;
+#if defined(NANOGUI_MIPMAP_SSE)
+            const __m128i zero = _mm_setzero_si128();
+            const __m128 scale = _mm_set1_ps(1.f / 65535.f);
+            for (; i + 8 <= n; i += 8) {
+                __m128i value = _mm_loadu_si128((const __m128i *) (src16 + i));
+                _mm_storeu_ps(out + i,     _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(value, zero)), scale));
+                _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(value, zero)), scale));
+            }
+#elif defined(NANOGUI_MIPMAP_NEON)
+            for (; i + 8 <= n; i += 8) {
+                uint16x8_t value = vld1q_u16(src16 + i);
+                vst1q_f32(out + i,     vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(value))), 1.f / 65535.f));
+                vst1q_f32(out + i + 4, vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(value))), 1.f / 65535.f));
+            }
+#endif
+            for (; i < n; ++i)
+                out[i] = src16[i] * (1.f / 65535.f);
+            break;
+        }
+
+        case VariableType::Float16: {
+            const uint16_t *src16 = (const uint16_t *) src;
+#if defined(NANOGUI_MIPMAP_F16C)
+            for (; i + 4 <= n; i += 4)
+                _mm_storeu_ps(out + i, _mm_cvtph_ps(_mm_loadl_epi64((const __m128i *) (src16 + i))));
+#elif defined(NANOGUI_MIPMAP_NEON_FP16)
+            for (; i + 4 <= n; i += 4)
+                vst1q_f32(out + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src16 + i))));
+#endif
+            for (; i < n; ++i)
+                out[i] = half_to_float(src16[i]);
+            break;
+        }
+
+        default:
+            memcpy(out, src, n * sizeof(float));
+            break;
+    }
+
+    if (srgb) {
+        for (i = 0; i < n; i += channels) {
+            for (size_t c = 0; c < channels; ++c) {
+                if (is_color_channel(c, channels))
+                    out[i + c] = srgb_to_linear(out[i + c]);
+            }
+        }
+    }
+}
+
+/// Convert 'count' pixels back from linear floating point values
+static void store_row(const float *in, uint8_t *dst, size_t count, size_t channels,
+                      VariableType type, bool srgb) {
+    size_t n = count * channels, i = 0;
+
+    /* sRGB encoding involves a lookup table or std::pow() per color channel,
+       hence only the linear conversions further below are vectorized */
+    if (srgb) {
+        const uint8_t *from_linear = srgb_tables().from_linear;
+        for (; i < n; ++i) {
+            bool color = is_color_channel(i % channels, channels);
+            float value = in[i];
+            switch (type) {
+                case VariableType::UInt8:
+                    value = std::min(std::max(value, 0.f), 1.f);
+                    if (color)
+                        dst[i] = from_linear[(int) (value * 4095.f + 0.5f)];
+                    else
+                        dst[i] = (uint8_t) (value * 255.f + 0.5f);
+                    break;
+
+                case VariableType::UInt16:
+                    value = std::min(std::max(value, 0.f), 1.f);
+                    if (color)
+                        value = linear_to_srgb(value);
+                    ((uint16_t *) dst)[i] = (uint16_t) (value * 65535.f + 0.5f);
+                    break;
+
+                case VariableType::Float16:
+                    ((uint16_t *) dst)[i] = float_to_half(color ? linear_to_srgb(value) : value);
+                    break;
+
+                default:
+                    ((float *) dst)[i] = color ? linear_to_srgb(value) : value;
+                    break;
+            }
+        }
+        return;
+    }
+
+    switch (type) {
+        case VariableType::UInt8: {
+#if defined(NANOGUI_MIPMAP_SSE)
+            const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.f),
+                         scale = _mm_set1_ps(255.f), half = _mm_set1_ps(.5f);
+            for (; i + 16 <= n; i += 16) {
+                __m128i value[4];
+                for (size_t k = 0; k < 4; ++k) {
+                    __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i + 4 * k), zero), one);
+                    value[k] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, scale), half));
+                }
+                _mm_storeu_si128((__m128i *) (dst + i),
+                                 _mm_packus_epi16(_mm_packs_epi32(value[0], value[1]),
+                                                  _mm_packs_epi32(value[2], value[3])));
+            }
+#elif defined(NANOGUI_MIPMAP_NEON)
+            const float32x4_t zero = vdupq_n_f32(0.f), one = vdupq_n_f32(1.f),
+                              half = vdupq_n_f32(.5f);
+            for (; i + 8 <= n; i += 8) {
+                float32x4_t lo = vminq_f32(vmaxq_f32(vld1q_f32(in + i), zero), one),
+                            hi = vminq_f32(vmaxq_f32(vld1q_f32(in + i + 4), zero), one);
+                uint16x4_t lo16 = vmovn_u32(vcvtq_u32_f32(vmlaq_n_f32(half, lo, 255.f))),
+                           hi16 = vmovn_u32(vcvtq_u32_f32(vmlaq_n_f32(half, hi, 255.f)));
+                vst1_u8(dst + i, vmovn_u16(vcombine_u16(lo16, hi16)));
+            }
+#endif
+            for (; i < n; ++i)
+                dst[i] = (uint8_t) (std::min(std::max(in[i], 0.f), 1.f) * 255.f + 0.5f);
+            break;
+        }
+
+        case VariableType::UInt16: {
+            uint16_t *dst16 = (uint16_t *) dst;
+#if defined(NANOGUI_MIPMAP_SSE)
+            /* SSE2 lacks an unsigned 32->16 bit pack, hence the values are
+               biased into the signed range and back */
+            const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.f),
+                         scale = _mm_set1_ps(65535.f), half = _mm_set1_ps(.5f);
+            const __m128i bias32 = _mm_set1_epi32(32768),
+                          bias16 = _mm_set1_epi16((short) 0x8000);
+            for (; i + 8 <= n; i += 8) {
+                __m128i value[2];
+                for (size_t k = 0; k < 2; ++k) {
+                    __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i + 4 * k), zero), one);
+                    value[k] = _mm_sub_epi32(
+                        _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, scale), half)), bias32);
+                }
+                _mm_storeu_si128((__m128i *) (dst16 + i),
+                                 _mm_xor_si128(_mm_packs_epi32(value[0], value[1]), bias16));
+            }
+#elif defined(NANOGUI_MIPMAP_NEON)
+            const float32x4_t zero = vdupq_n_f32(0.f), one = vdupq_n_f32(1.f),
+                              half = vdupq_n_f32(.5f);
+            for (; i + 8 <= n; i += 8) {
+                float32x4_t lo = vminq_f32(vmaxq_f32(vld1q_f32(in + i), zero), one),
+                            hi = vminq_f32(vmaxq_f32(vld1q_f32(in + i + 4), zero), one);
+                vst1q_u16(dst16 + i,
+                          vcombine_u16(vmovn_u32(vcvtq_u32_f32(vmlaq_n_f32(half, lo, 65535.f))),
+                                       vmovn_u32(vcvtq_u32_f32(vmlaq_n_f32(half, hi, 65535.f)))));
+            }
+#endif
+            for (; i < n; ++i)
+                dst16[i] = (uint16_t) (std::min(std::max(in[i], 0.f), 1.f) * 65535.f + 0.5f);
+            break;
+        }
+
+        case VariableType::Float16: {
+            uint16_t *dst16 = (uint16_t *) dst;
+#if defined(NANOGUI_MIPMAP_F16C)
+            for (; i + 4 <= n; i += 4)
+                _mm_storel_epi64((__m128i *) (dst16 + i),
+                                 _mm_cvtps_ph(_mm_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT));
+#elif defined(NANOGUI_MIPMAP_NEON_FP16)
+            for (; i + 4 <= n; i += 4)
+                vst1_u16(dst16 + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(in + i))));
+#endif
+            for (; i < n; ++i)
+                dst16[i] = float_to_half(in[i]);
+            break;
+        }
+
+        default:
+            memcpy(dst, in, n * sizeof(float));
+            break;
+    }
+}
+
+/// out[i] = sum_k weights[k] * rows[k][i]
+static void filter_rows(float *out, const float *const *rows, const float *weights,
+                        size_t taps, size_t n) {
+    size_t i = 0;
+#if defined(NANOGUI_MIPMAP_AVX)
+    for (; i + 8 <= n; i += 8) {
+        __m256 acc = _mm256_mul_ps(_mm256_loadu_ps(rows[0] + i), _mm256_set1_ps(weights[0]));
+        for (size_t k = 1; k < taps; ++k)
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(rows[k] + i),
+                                                   _mm256_set1_ps(weights[k])));
+        _mm256_storeu_ps(out + i, acc);
+    }
+#endif
+#if defined(NANOGUI_MIPMAP_SSE)
+    for (; i + 4 <= n; i += 4) {
+        __m128 acc = _mm_mul_ps(_mm_loadu_ps(rows[0] + i), _mm_set1_ps(weights[0]));
+        for (size_t k = 1; k < taps; ++k)
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(rows[k] + i),
+                                             _mm_set1_ps(weights[k])));
+        _mm_storeu_ps(out + i, acc);
+    }
+#elif defined(NANOGUI_MIPMAP_NEON)
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t acc = vmulq_n_f32(vld1q_f32(rows[0] + i), weights[0]);
+        for (size_t k = 1; k < taps; ++k)
+            acc = vmlaq_n_f32(acc, vld1q_f32(rows[k] + i), weights[k]);
+        vst1q_f32(out + i, acc);
+    }
+#endif
+    for (; i < n; ++i) {
+        float acc = rows[0][i] * weights[0];
+        for (size_t k = 1; k < taps; ++k)
+            acc += rows[k][i] * weights[k];
+        out[i] = acc;
+    }
+}
+
+/// Horizontal pass: out[x] = sum_k weights[k] * in[index[x * taps + k]]
+static void filter_columns(float *out, const float *in, const int32_t *index,
+                           const float *weights, size_t taps, size_t count,
+                           size_t channels) {
+#if defined(NANOGUI_MIPMAP_SSE) || defined(NANOGUI_MIPMAP_NEON)
+    if (channels == 4) {
+        for (size_t x = 0; x < count; ++x) {
+            const int32_t *idx = index + x * taps;
+#  if defined(NANOGUI_MIPMAP_SSE)
+            __m128 acc = _mm_mul_ps(_mm_loadu_ps(in + idx[0] * 4), _mm_set1_ps(weights[0]));
+            for (size_t k = 1; k < taps; ++k)
+                acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(in + idx[k] * 4),
+                                                 _mm_set1_ps(weights[k])));
+            _mm_storeu_ps(out + x * 4, acc);
+#  else
+            float32x4_t acc = vmulq_n_f32(vld1q_f32(in + idx[0] * 4), weights[0]);
+            for (size_t k = 1; k < taps; ++k)
+                acc = vmlaq_n_f32(acc, vld1q_f32(in + idx[k] * 4), weights[k]);
+            vst1q_f32(out + x * 4, acc);
+#  endif
+        }
+        return;
+    }
+#endif
+
+    for (size_t x = 0; x < count; ++x) {
+        const int32_t *idx = index + x * taps;
+        for (size_t c = 0; c < channels; ++c) {
+            float acc = 0.f;
+            for (size_t k = 0; k < taps; ++k)
+                acc += in[idx[k] * channels + c] * weights[k];
+            out[x * channels + c] = acc;
+        }
+    }
+}
+
+static double bessel_i0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+/// Source offsets (relative to 2*i) and weights of a 2:1 downsampling filter
+static size_t mipmap_filter_taps(Texture::MipmapFilter filter, int32_t *offsets, float *weights) {
+    if (filter == Texture::MipmapFilter::Box) {
+        offsets[0] = 0; offsets[1] = 1;
+        weights[0] = weights[1] = 0.5f;
+        return 2;
+    }
+
+    /* Kaiser-windowed sinc with a cutoff at half the source sampling rate.
+       The output pixel center lies at 2*i+1 in source coordinates, hence
+       the source pixel 2*i+k is at distance k-0.5 */
+    const double alpha = 4.0, radius = 3.0, pi = 3.14159265358979323846;
+    double sum = 0.0, w[6];
+    for (int k = -2; k <= 3; ++k) {
+        double d = k - 0.5, t = d / radius,
+               sinc = std::sin(pi * d * 0.5) / (pi * d * 0.5),
+               window = bessel_i0(alpha * std::sqrt(std::max(0.0, 1.0 - t * t))) /
+                        bessel_i0(alpha);
+        w[k + 2] = sinc * window;
+        sum += w[k + 2];
+    }
+    for (int k = 0; k < 6; ++k) {
+        offsets[k] = k - 2;
+        weights[k] = (float) (w[k] / sum);
+    }
+    return 6;
+}
+
+void mipmap_downsample(const void *src_, const Vector2i &src_size, void *dst_,
+                       const Vector2i &dst_origin, const Vector2i &dst_size,
+                       size_t channels, VariableType type, Texture::MipmapFilter filter,
+                       bool srgb) {
+    if (type != VariableType::UInt8 && type != VariableType::UInt16 &&
+        type != VariableType::Float16 && type != VariableType::Float32)
+        throw std::runtime_error("mipmap_downsample(): unsupported component type!");
+    if (filter != Texture::MipmapFilter::Box && filter != Texture::MipmapFilter::Kaiser)
+        throw std::runtime_error("mipmap_downsample(): unsupported filter!");
+
+    Vector2i level_size = mipmap_level_size(src_size, 1);
+    if (dst_size.x() <= 0 || dst_size.y() <= 0)
+        return;
+    if (dst_origin.x() < 0 || dst_origin.y() < 0 ||
+        dst_origin.x() + dst_size.x() > level_size.x() ||
+        dst_origin.y() + dst_size.y() > level_size.y())
+        throw std::runtime_error("mipmap_downsample(): region is out of bounds!");
+
+    const uint8_t *src = (const uint8_t *) src_;
+    uint8_t *dst = (uint8_t *) dst_;
+    size_t bpp = type_size(type) * channels;
+
+    int32_t offsets[6];
+    float weights[6];
+    size_t taps = mipmap_filter_taps(filter, offsets, weights);
+
+    // Range of source columns that contribute to the destination region
+    int32_t x0 = std::max(0, 2 * dst_origin.x() + offsets[0]),
+            x1 = std::min(src_size.x() - 1,
+                          2 * (dst_origin.x() + dst_size.x() - 1) + offsets[taps - 1]);
+    size_t src_count = (size_t) (x1 - x0 + 1);
+
+    // Source column indices (relative to 'x0') of each tap
+    std::vector<int32_t> index((size_t) dst_size.x() * taps);
+    for (int32_t x = 0; x < dst_size.x(); ++x)
+        for (size_t k = 0; k < taps; ++k)
+            index[x * taps + k] =
+                std::min(std::max(2 * (dst_origin.x() + x) + offsets[k], 0),
+                         src_size.x() - 1) - x0;
+
+    /* Linearized source rows, cached by row index since neighboring output
+       rows share most of their taps */
+    std::vector<float> cache(src_count * channels * 8);
+    int32_t cache_row[8];
+    std::fill(cache_row, cache_row + 8, -1);
+
+    std::vector<float> vertical(src_count * channels),
+                       horizontal((size_t) dst_size.x() * channels);
+    const float *rows[6];
+
+    for (int32_t y = dst_origin.y(); y < dst_origin.y() + dst_size.y(); ++y) {
+        for (size_t k = 0; k < taps; ++k) {
+            int32_t sy = std::min(std::max(2 * y + offsets[k], 0), src_size.y() - 1),
+                    slot = sy & 7;
+            float *row = cache.data() + slot * src_count * channels;
+            if (cache_row[slot] != sy) {
+                load_row(src + ((size_t) sy * src_size.x() + x0) * bpp, row, src_count,
+                         channels, type, srgb);
+                cache_row[slot] = sy;
+            }
+            rows[k] = row;
+        }
+
+        filter_rows(vertical.data(), rows, weights, taps, src_count * channels);
+        filter_columns(horizontal.data(), vertical.data(), index.data(), weights, taps,
+                       (size_t) dst_size.x(), channels);
+        store_row(horizontal.data(),
+                  dst + ((size_t) y * level_size.x() + dst_origin.x()) * bpp,
+                  (size_t) dst_size.x(), channels, type, srgb);
+    }
+}
+
+NAMESPACE_END(nanogui)
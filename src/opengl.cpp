@@ -1,4 +1,5 @@
 #include <nanogui/opengl.h>
+#include "opengl_ext.h"
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -56,4 +57,52 @@ bool nanogui_check_glerror(const char *cmd) {
     return true;
 }
 
+#if defined(NANOGUI_USE_GLES)
+const GLMultisampledRenderToTexture *gl_multisampled_render_to_texture() {
+    static GLMultisampledRenderToTexture ext;
+    static bool loaded = false, supported = false;
+
+    if (!loaded) {
+        loaded = true;
+        if (glfwExtensionSupported("GL_EXT_multisampled_render_to_texture")) {
+            ext.renderbuffer_storage_multisample =
+                (decltype(ext.renderbuffer_storage_multisample))
+                glfwGetProcAddress("glRenderbufferStorageMultisampleEXT");
+            ext.framebuffer_texture_2d_multisample =
+                (decltype(ext.framebuffer_texture_2d_multisample))
+                glfwGetProcAddress("glFramebufferTexture2DMultisampleEXT");
+            supported = ext.renderbuffer_storage_multisample &&
+                        ext.framebuffer_texture_2d_multisample;
+        }
+    }
+
+    return supported ? &ext : nullptr;
+}
+
+const GLDisjointTimerQuery *gl_disjoint_timer_query() {
+    static GLDisjointTimerQuery ext;
+    static bool loaded = false, supported = false;
+
+    if (!loaded) {
+        loaded = true;
+        if (glfwExtensionSupported("GL_EXT_disjoint_timer_query")) {
+            ext.gen_queries = (decltype(ext.gen_queries))
+                glfwGetProcAddress("glGenQueriesEXT");
+            ext.delete_queries = (decltype(ext.delete_queries))
+                glfwGetProcAddress("glDeleteQueriesEXT");
+            ext.query_counter = (decltype(ext.query_counter))
+                glfwGetProcAddress("glQueryCounterEXT");
+            ext.get_query_objectuiv = (decltype(ext.get_query_objectuiv))
+                glfwGetProcAddress("glGetQueryObjectuivEXT");
+            ext.get_query_objectui64v = (decltype(ext.get_query_objectui64v))
+                glfwGetProcAddress("glGetQueryObjectui64vEXT");
+            supported = ext.gen_queries && ext.delete_queries && ext.query_counter &&
+                        ext.get_query_objectuiv && ext.get_query_objectui64v;
+        }
+    }
+
+    return supported ? &ext : nullptr;
+}
+#endif
+
 NAMESPACE_END(nanogui)
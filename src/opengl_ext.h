@@ -0,0 +1,36 @@
+#pragma once
+
+#include <nanogui/opengl.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+#if defined(NANOGUI_USE_GLES)
+/// Entry points of EXT_multisampled_render_to_texture, which GLES 3 headers don't declare
+struct GLMultisampledRenderToTexture {
+    void (GL_APIENTRY *renderbuffer_storage_multisample)(GLenum, GLsizei, GLenum,
+                                                         GLsizei, GLsizei) = nullptr;
+    void (GL_APIENTRY *framebuffer_texture_2d_multisample)(GLenum, GLenum, GLenum,
+                                                           GLuint, GLint, GLsizei) = nullptr;
+};
+
+/// Return the entry points, or \c nullptr if the extension is unavailable
+extern const GLMultisampledRenderToTexture *gl_multisampled_render_to_texture();
+
+#  if !defined(GL_GPU_DISJOINT_EXT)
+#    define GL_GPU_DISJOINT_EXT 0x8FBB
+#  endif
+
+/// Entry points of EXT_disjoint_timer_query, which GLES headers don't declare
+struct GLDisjointTimerQuery {
+    void (GL_APIENTRY *gen_queries)(GLsizei, GLuint *) = nullptr;
+    void (GL_APIENTRY *delete_queries)(GLsizei, const GLuint *) = nullptr;
+    void (GL_APIENTRY *query_counter)(GLuint, GLenum) = nullptr;
+    void (GL_APIENTRY *get_query_objectuiv)(GLuint, GLenum, GLuint *) = nullptr;
+    void (GL_APIENTRY *get_query_objectui64v)(GLuint, GLenum, uint64_t *) = nullptr;
+};
+
+/// Return the entry points, or \c nullptr if the extension is unavailable
+extern const GLDisjointTimerQuery *gl_disjoint_timer_query();
+#endif
+
+NAMESPACE_END(nanogui)
@@ -23,23 +23,36 @@ public:
 
 void register_canvas(nb::module_ &m) {
     nb::class_<Canvas, Widget, PyCanvas>(m, "Canvas", D(Canvas))
-        .def(nb::init<Widget *, uint8_t, bool, bool, bool>(),
+        .def(nb::init<Widget *, uint8_t, bool, bool, bool, bool>(),
              "parent"_a, "samples"_a = 4, "has_depth_buffer"_a = true,
-             "has_stencil_buffer"_a = false,
-             "clear"_a = true, D(Canvas, Canvas))
+             "has_stencil_buffer"_a = false, "clear"_a = true,
+             "implicit_resolve"_a = true, D(Canvas, Canvas))
         .def("render_pass", &Canvas::render_pass, D(Canvas, render_pass))
+        .def("implicit_resolve", &Canvas::implicit_resolve, D(Canvas, implicit_resolve))
         .def("draw_border", &Canvas::draw_border, D(Canvas, draw_border))
         .def("set_draw_border", &Canvas::set_draw_border, D(Canvas, set_draw_border))
         .def("border_color", &Canvas::border_color, D(Canvas, border_color))
         .def("set_border_color", &Canvas::set_border_color, D(Canvas, set_border_color))
         .def("background_color", &Canvas::background_color, D(Canvas, background_color))
         .def("set_background_color", &Canvas::set_background_color, D(Canvas, set_background_color))
+        .def("set_deferred", &Canvas::set_deferred, D(Canvas, set_deferred))
+        .def("deferred", &Canvas::deferred, D(Canvas, deferred))
+        .def("add_dependency", &Canvas::add_dependency, D(Canvas, add_dependency))
+        .def("texture", &Canvas::texture, D(Canvas, texture))
+        .def("set_cached", &Canvas::set_cached, D(Canvas, set_cached))
+        .def("cached", &Canvas::cached, D(Canvas, cached))
+        .def("mark_dirty", &Canvas::mark_dirty, D(Canvas, mark_dirty))
+        .def("dirty", &Canvas::dirty, D(Canvas, dirty))
         .def("draw_contents", &Canvas::draw_contents, D(Canvas, draw_contents));
 
     nb::class_<ImageView, Canvas, PyImageView>(m, "ImageView", D(ImageView))
         .def(nb::init<Widget *>(), D(ImageView, ImageView))
         .def("image", nb::overload_cast<>(&ImageView::image, nb::const_), D(ImageView, image))
         .def("set_image", &ImageView::set_image, D(ImageView, set_image))
+        .def("tiled_image", nb::overload_cast<>(&ImageView::tiled_image, nb::const_),
+             D(ImageView, tiled_image))
+        .def("set_tiled_image", &ImageView::set_tiled_image, D(ImageView, set_tiled_image))
+        .def("image_size", &ImageView::image_size, D(ImageView, image_size))
         .def("reset", &ImageView::reset, D(ImageView, reset))
         .def("center", &ImageView::center, D(ImageView, center))
         .def("offset", &ImageView::offset, D(ImageView, offset))
@@ -115,7 +115,14 @@ NB_MODULE(nanogui_ext, m_) {
         m.def("chdir_to_bundle_parent", &nanogui::chdir_to_bundle_parent);
     #endif
     m.def("utf8", [](int c) { return std::string(utf8(c).data()); }, D(utf8));
-    m.def("load_image_directory", &nanogui::load_image_directory, D(load_image_directory));
+    m.def("load_image_directory",
+          (std::vector<std::pair<int, std::string>>(*)(NVGcontext *, const std::string &)) &
+              nanogui::load_image_directory,
+          D(load_image_directory));
+    m.def("load_image_directory",
+          (std::vector<std::pair<int, std::string>>(*)(TextureAtlas *, const std::string &)) &
+              nanogui::load_image_directory,
+          D(load_image_directory, 2));
 
     nb::enum_<Cursor>(m, "Cursor", D(Cursor))
         .value("Arrow", Cursor::Arrow)
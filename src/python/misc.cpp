@@ -51,6 +51,8 @@ void register_misc(nb::module_ &m) {
         .def(nb::init<Widget *>(), "parent"_a, D(ImagePanel, ImagePanel))
         .def("images", &ImagePanel::images, D(ImagePanel, images))
         .def("set_images", &ImagePanel::set_images, D(ImagePanel, set_images))
+        .def("atlas", nb::overload_cast<>(&ImagePanel::atlas), D(ImagePanel, atlas))
+        .def("set_atlas", &ImagePanel::set_atlas, D(ImagePanel, set_atlas))
         .def("callback", &ImagePanel::callback, D(ImagePanel, callback))
         .def("set_callback", &ImagePanel::set_callback, D(ImagePanel, set_callback));
 }
@@ -398,7 +398,10 @@ Parameter ``parent``:
     The parent widget
 
 Parameter ``samples``:
-    The number of pixel samples (MSAA)
+    The number of pixel samples (MSAA). Pass 1 to render straight into
+    the screen using a scissored viewport instead of an offscreen
+    texture, provided that the screen has the requested depth/stencil
+    buffers.
 
 Parameter ``has_depth_buffer``:
     Should the widget allocate a depth buffer for the underlying
@@ -409,36 +412,93 @@ Parameter ``has_stencil_buffer``:
     render pass?
 
 Parameter ``clear``:
-    Should the widget clear its color/depth/stencil buffer?)doc";
+    Should the widget clear its color/depth/stencil buffer?
+
+Parameter ``implicit_resolve``:
+    On GLES, should multisampled contents be resolved in tile memory
+    using EXT_multisampled_render_to_texture when it is available?
+    Otherwise, GLES 3 resolves them using a blit, and GLES 2 falls back
+    to a single sample. Ignored by the other backends.)doc";
+
+static const char *__doc_nanogui_Canvas_add_dependency =
+R"doc(Render another canvas before this one (e.g. because this canvas samples
+its texture) when both are deferred)doc";
 
 static const char *__doc_nanogui_Canvas_background_color = R"doc(Return whether the widget border is drawn)doc";
 
 static const char *__doc_nanogui_Canvas_border_color = R"doc(Return whether the widget border is drawn)doc";
 
+static const char *__doc_nanogui_Canvas_cached = R"doc(Does the canvas keep its rendered texture until marked dirty?)doc";
+
+static const char *__doc_nanogui_Canvas_deferred = R"doc(Does the canvas render through the screen's RenderGraph?)doc";
+
+static const char *__doc_nanogui_Canvas_dirty =
+R"doc(Will the contents of a cached canvas be re-rendered when it is drawn
+next?)doc";
+
 static const char *__doc_nanogui_Canvas_draw = R"doc(Draw the widget)doc";
 
 static const char *__doc_nanogui_Canvas_draw_border = R"doc(Return whether the widget border will be drawn)doc";
 
 static const char *__doc_nanogui_Canvas_draw_contents = R"doc(Draw the widget contents. Override this method.)doc";
 
+static const char *__doc_nanogui_Canvas_implicit_resolve =
+R"doc(Are multisampled contents resolved implicitly (see
+Texture::ImplicitResolve)?)doc";
+
+static const char *__doc_nanogui_Canvas_m_cached = R"doc()doc";
+
+static const char *__doc_nanogui_Canvas_m_cached_size = R"doc(Size of the texture when the cached contents were rendered)doc";
+
 static const char *__doc_nanogui_Canvas_m_border_color = R"doc()doc";
 
 static const char *__doc_nanogui_Canvas_m_draw_border = R"doc()doc";
 
+static const char *__doc_nanogui_Canvas_m_implicit_resolve = R"doc()doc";
+
 static const char *__doc_nanogui_Canvas_m_render_pass = R"doc()doc";
 
 static const char *__doc_nanogui_Canvas_m_render_pass_resolved = R"doc()doc";
 
 static const char *__doc_nanogui_Canvas_m_render_to_texture = R"doc()doc";
 
+static const char *__doc_nanogui_Canvas_mark_dirty = R"doc(Re-render the contents of a cached canvas when it is drawn next)doc";
+
+static const char *__doc_nanogui_Canvas_needs_render = R"doc(Must draw_contents() run to fill a texture of the given size?)doc";
+
 static const char *__doc_nanogui_Canvas_render_pass = R"doc(Return the render pass associated with the canvas object)doc";
 
 static const char *__doc_nanogui_Canvas_set_background_color = R"doc(Specify the widget background color)doc";
 
 static const char *__doc_nanogui_Canvas_set_border_color = R"doc(Specify the widget border color)doc";
 
+static const char *__doc_nanogui_Canvas_set_cached =
+R"doc(Keep the rendered texture and only invoke draw_contents() again once
+the canvas is marked dirty?
+
+Until then, the cached texture is composited, which makes static
+contents (e.g. a 3D preview) almost free. Resizing the canvas marks it
+dirty, changes to the contents of canvases that it depends on (see
+add_dependency()) don't. Only canvases that render to a texture (see
+texture()) can be cached.)doc";
+
+static const char *__doc_nanogui_Canvas_set_deferred =
+R"doc(Render through the screen's RenderGraph (the default)?
+
+Canvases that render to a texture (e.g. due to multisampling) are then
+drawn before the rest of the user interface and composited using
+NanoVG, which avoids flushing NanoVG and switching framebuffers in the
+middle of the frame. Other canvases always render directly.)doc";
+
 static const char *__doc_nanogui_Canvas_set_draw_border = R"doc(Specify whether to draw the widget border)doc";
 
+static const char *__doc_nanogui_Canvas_texture =
+R"doc(Return the texture that holds the rendered contents, or nullptr if
+the canvas renders directly into the screen
+
+On OpenGL and GLES, multisampled canvases that are not deferred
+resolve straight into the screen and leave this texture untouched.)doc";
+
 static const char *__doc_nanogui_CheckBox =
 R"doc(\class CheckBox checkbox.h nanogui/checkbox.h
 
@@ -1012,6 +1072,110 @@ static const char *__doc_nanogui_GLFramebuffer = R"doc()doc";
 
 static const char *__doc_nanogui_GLShader = R"doc()doc";
 
+static const char *__doc_nanogui_GLState =
+R"doc(Per-context shadow copy of the OpenGL state touched by Shader and
+RenderPass.
+
+State changes issued through it are skipped when the shadow copy shows
+that they would have no effect. Code that modifies the tracked state
+using direct OpenGL calls must call invalidate() afterwards.)doc";
+
+static const char *__doc_nanogui_GLState_Category = R"doc(Groups of state entries (see invalidate()))doc";
+
+static const char *__doc_nanogui_GLState_Category_NanoVG = R"doc(Entries that the NanoVG renderer changes while flushing)doc";
+
+static const char *__doc_nanogui_GLState_Stats = R"doc(Number of state changes that were issued and skipped)doc";
+
+static const char *__doc_nanogui_GLState_Stats_elided = R"doc()doc";
+
+static const char *__doc_nanogui_GLState_Stats_issued = R"doc()doc";
+
+static const char *__doc_nanogui_GLState_current = R"doc(Return the tracker of the OpenGL context that is current on this thread)doc";
+
+static const char *__doc_nanogui_GLState_invalidate = R"doc(Mark the given categories of entries as unknown)doc";
+
+static const char *__doc_nanogui_GLState_last_frame_stats = R"doc(Return the number of issued and skipped state changes of the previous frame)doc";
+
+static const char *__doc_nanogui_GLState_stats = R"doc(Return the number of issued and skipped state changes of the current frame)doc";
+
+static const char *__doc_nanogui_GPUTimer =
+R"doc(Measures the GPU time spent between two points of the command stream
+and keeps rolling statistics over the most recent samples.
+
+Attach a timer to a render pass using RenderPass::set_gpu_timer() to
+measure the commands issued between RenderPass::begin() and
+RenderPass::end(), e.g. those of Canvas::draw_contents().
+
+Results never stall the CPU: they are collected a few frames later,
+once the GPU has reached the measured commands.
+
+- On OpenGL, a pair of ``GL_TIMESTAMP`` queries (OpenGL 3.3 or
+  ARB_timer_query) brackets the measured commands. Pairs that are
+  still in flight are polled once per frame (see poll_all()) using
+  ``GL_QUERY_RESULT_AVAILABLE``. Timestamps (rather than ``GL_TIME_ELAPSED``) allow measurements to
+  nest.
+- On GLES, the same is done using EXT_disjoint_timer_query. Results of
+  intervals that the driver reports as disjoint (e.g. due to a change
+  of the GPU clock) are dropped.
+- On Metal, the GPU start and end times of the render pass's command
+  buffer are recorded by its completion handler (macOS 10.15+).
+
+Timers register themselves in a global list (see timers()), which the
+overlay of Screen::set_gpu_timer_overlay() displays.)doc";
+
+static const char *__doc_nanogui_GPUTimer_GPUTimer =
+R"doc(Create a timer
+
+Parameter ``name``:
+    Label shown by the overlay of Screen
+
+Parameter ``window``:
+    Number of recent samples that the statistics are computed over)doc";
+
+static const char *__doc_nanogui_GPUTimer_Stats = R"doc(Rolling statistics in milliseconds)doc";
+
+static const char *__doc_nanogui_GPUTimer_Stats_average = R"doc()doc";
+
+static const char *__doc_nanogui_GPUTimer_Stats_last = R"doc(Most recent sample)doc";
+
+static const char *__doc_nanogui_GPUTimer_Stats_maximum = R"doc()doc";
+
+static const char *__doc_nanogui_GPUTimer_Stats_minimum = R"doc()doc";
+
+static const char *__doc_nanogui_GPUTimer_Stats_samples = R"doc(Number of samples that the statistics are based on)doc";
+
+static const char *__doc_nanogui_GPUTimer_add_sample = R"doc(Add a sample in milliseconds (thread-safe on Metal))doc";
+
+static const char *__doc_nanogui_GPUTimer_begin =
+R"doc(Start a measurement
+
+The measurement is skipped if all query pairs are still in flight
+after collecting the available results.)doc";
+
+static const char *__doc_nanogui_GPUTimer_end = R"doc(Finish the measurement started by begin())doc";
+
+static const char *__doc_nanogui_GPUTimer_name = R"doc(Return the label of the timer)doc";
+
+static const char *__doc_nanogui_GPUTimer_poll_all =
+R"doc(Collect the finished measurements of all timers that belong to the
+current context, without waiting
+
+Screen calls this once per frame. Applications that drive timers
+without a Screen should call it once per frame as well. Does nothing
+on Metal, where results arrive via completion handlers.)doc";
+
+static const char *__doc_nanogui_GPUTimer_reset = R"doc(Discard all samples)doc";
+
+static const char *__doc_nanogui_GPUTimer_set_name = R"doc(Set the label of the timer)doc";
+
+static const char *__doc_nanogui_GPUTimer_stats = R"doc(Return the rolling statistics)doc";
+
+static const char *__doc_nanogui_GPUTimer_supported = R"doc(Can GPU times be measured on the current context? (cached per context))doc";
+
+static const char *__doc_nanogui_GPUTimer_timers = R"doc(Return all timers that currently exist)doc";
+
+static const char *__doc_nanogui_GPUTimer_window = R"doc(Return the number of samples that the statistics are computed over)doc";
+
 static const char *__doc_nanogui_Graph =
 R"doc(\class Graph graph.h nanogui/graph.h
 
@@ -1234,6 +1398,8 @@ Image panel widget which shows a number of square-shaped icons.)doc";
 
 static const char *__doc_nanogui_ImagePanel_ImagePanel = R"doc()doc";
 
+static const char *__doc_nanogui_ImagePanel_atlas = R"doc()doc";
+
 static const char *__doc_nanogui_ImagePanel_callback = R"doc()doc";
 
 static const char *__doc_nanogui_ImagePanel_draw = R"doc()doc";
@@ -1244,6 +1410,8 @@ static const char *__doc_nanogui_ImagePanel_images = R"doc()doc";
 
 static const char *__doc_nanogui_ImagePanel_index_for_position = R"doc()doc";
 
+static const char *__doc_nanogui_ImagePanel_m_atlas = R"doc()doc";
+
 static const char *__doc_nanogui_ImagePanel_m_callback = R"doc()doc";
 
 static const char *__doc_nanogui_ImagePanel_m_images = R"doc()doc";
@@ -1262,6 +1430,8 @@ static const char *__doc_nanogui_ImagePanel_mouse_motion_event = R"doc()doc";
 
 static const char *__doc_nanogui_ImagePanel_preferred_size = R"doc()doc";
 
+static const char *__doc_nanogui_ImagePanel_set_atlas = R"doc(Draw the images from regions of an atlas (see load_image_directory()))doc";
+
 static const char *__doc_nanogui_ImagePanel_set_callback = R"doc()doc";
 
 static const char *__doc_nanogui_ImagePanel_set_images = R"doc()doc";
@@ -1286,6 +1456,8 @@ static const char *__doc_nanogui_ImageView_image = R"doc(Return the currently ac
 
 static const char *__doc_nanogui_ImageView_image_2 = R"doc(Return the currently active image (const version))doc";
 
+static const char *__doc_nanogui_ImageView_image_size = R"doc(Return the size of the active image or tiled image)doc";
+
 static const char *__doc_nanogui_ImageView_keyboard_event = R"doc()doc";
 
 static const char *__doc_nanogui_ImageView_m_draw_image_border = R"doc()doc";
@@ -1304,6 +1476,10 @@ static const char *__doc_nanogui_ImageView_m_pixel_callback = R"doc()doc";
 
 static const char *__doc_nanogui_ImageView_m_scale = R"doc()doc";
 
+static const char *__doc_nanogui_ImageView_m_tiled_image = R"doc()doc";
+
+static const char *__doc_nanogui_ImageView_m_tiled_shader = R"doc()doc";
+
 static const char *__doc_nanogui_ImageView_mouse_drag_event = R"doc()doc";
 
 static const char *__doc_nanogui_ImageView_offset = R"doc(Return the pixel offset of the zoomed image rectangle)doc";
@@ -1332,6 +1508,12 @@ components)doc";
 
 static const char *__doc_nanogui_ImageView_set_scale = R"doc(Set the current magnification of the image)doc";
 
+static const char *__doc_nanogui_ImageView_set_tiled_image = R"doc(Set the currently active tiled image (replaces the image))doc";
+
+static const char *__doc_nanogui_ImageView_tiled_image = R"doc(Return the currently active tiled image)doc";
+
+static const char *__doc_nanogui_ImageView_tiled_image_2 = R"doc(Return the currently active tiled image (const version))doc";
+
 static const char *__doc_nanogui_IntBox =
 R"doc(\class IntBox textbox.h nanogui/textbox.h
 
@@ -1640,6 +1822,53 @@ static const char *__doc_nanogui_ProgressBar_set_value = R"doc()doc";
 
 static const char *__doc_nanogui_ProgressBar_value = R"doc()doc";
 
+static const char *__doc_nanogui_RenderGraph =
+R"doc(Collects the offscreen render passes of a frame and executes them in
+dependency order before the user interface is drawn.
+
+Screen owns one graph. Before NanoVG starts drawing a frame, every
+visible Canvas that renders to a texture adds its pass, and the screen
+calls execute(). The canvases then composite their textures as part of
+the regular NanoVG traversal. Compared to rendering each canvas in the
+middle of the traversal, this avoids flushing NanoVG and switching
+framebuffers once per canvas.
+
+Callbacks that are added for the same render pass are merged into a
+single RenderPass::begin() / RenderPass::end() pair. Passes without
+dependencies between them run in the order in which they were added.
+The graph is cleared after every execution.)doc";
+
+static const char *__doc_nanogui_RenderGraph_RenderGraph = R"doc(Create an empty graph)doc";
+
+static const char *__doc_nanogui_RenderGraph_Stats = R"doc(Statistics of the most recent execute() call)doc";
+
+static const char *__doc_nanogui_RenderGraph_Stats_merged = R"doc(Number of callbacks that shared a render pass with an earlier one)doc";
+
+static const char *__doc_nanogui_RenderGraph_Stats_passes = R"doc(Number of executed render passes)doc";
+
+static const char *__doc_nanogui_RenderGraph_add_dependency =
+R"doc(Require ``dependency`` to be executed before ``pass`` (e.g. because
+``pass`` samples a texture that ``dependency`` renders)
+
+Dependencies on passes that are not part of the graph are ignored.)doc";
+
+static const char *__doc_nanogui_RenderGraph_add_pass =
+R"doc(Schedule drawing code that renders into the given pass
+
+The callback is invoked between RenderPass::begin() and
+RenderPass::end() during the next execute().)doc";
+
+static const char *__doc_nanogui_RenderGraph_clear = R"doc(Discard all scheduled passes)doc";
+
+static const char *__doc_nanogui_RenderGraph_execute =
+R"doc(Execute all scheduled passes and clear the graph
+
+Throws an exception if the dependencies contain a cycle.)doc";
+
+static const char *__doc_nanogui_RenderGraph_last_stats = R"doc(Return the statistics of the most recent execute() call)doc";
+
+static const char *__doc_nanogui_RenderGraph_size = R"doc(Return the number of scheduled render passes)doc";
+
 static const char *__doc_nanogui_RenderPass = R"doc()doc";
 
 static const char *__doc_nanogui_RenderPass_2 = R"doc()doc";
@@ -1670,6 +1899,14 @@ static const char *__doc_nanogui_RenderPass_DepthTest_Never = R"doc()doc";
 
 static const char *__doc_nanogui_RenderPass_DepthTest_NotEqual = R"doc()doc";
 
+static const char *__doc_nanogui_RenderPass_LoadAction = R"doc(Action applied to an attachment when the render pass begins)doc";
+
+static const char *__doc_nanogui_RenderPass_LoadAction_Clear = R"doc(Clear to the clear color, depth, or stencil value)doc";
+
+static const char *__doc_nanogui_RenderPass_LoadAction_DontCare = R"doc(The previous contents are not needed and become undefined)doc";
+
+static const char *__doc_nanogui_RenderPass_LoadAction_Load = R"doc(Preserve the previous contents)doc";
+
 static const char *__doc_nanogui_RenderPass_RenderPass =
 R"doc(Create a new render pass for rendering to a specific set of targets
 
@@ -1696,7 +1933,19 @@ Parameter ``blit_target``:
     for display.
 
 Parameter ``clear``:
-    Should enter() begin by clearing all buffers?)doc";
+    Should enter() begin by clearing all buffers? This sets the initial
+    load action of all attachments to LoadAction::Clear or
+    LoadAction::Load.)doc";
+
+static const char *__doc_nanogui_RenderPass_StoreAction = R"doc(Action applied to an attachment when the render pass ends)doc";
+
+static const char *__doc_nanogui_RenderPass_StoreAction_Discard =
+R"doc(The contents are not needed after the render pass (e.g. a depth
+buffer), which lets tile-based GPUs skip writing them to memory)doc";
+
+static const char *__doc_nanogui_RenderPass_StoreAction_Store = R"doc(Preserve the rendered contents)doc";
+
+static const char *__doc_nanogui_RenderPass_active = R"doc(Is the render pass between begin() and end()?)doc";
 
 static const char *__doc_nanogui_RenderPass_begin =
 R"doc(Begin the render pass
@@ -1714,6 +1963,8 @@ static const char *__doc_nanogui_RenderPass_blit_to =
 R"doc(Blit the framebuffer to another target (which can either be another
 RenderPass instance or a Screen instance).)doc";
 
+static const char *__doc_nanogui_RenderPass_blit_target = R"doc(Return the target that the render pass blits to when it ends (if any))doc";
+
 static const char *__doc_nanogui_RenderPass_clear_color = R"doc(Return the clear color for a given color attachment)doc";
 
 static const char *__doc_nanogui_RenderPass_clear_depth = R"doc(Return the clear depth for the depth attachment)doc";
@@ -1730,12 +1981,23 @@ static const char *__doc_nanogui_RenderPass_depth_test = R"doc(Return the depth
 
 static const char *__doc_nanogui_RenderPass_end = R"doc(Finish the render pass)doc";
 
+static const char *__doc_nanogui_RenderPass_gpu_timer = R"doc(Return the timer that measures this render pass (if any))doc";
+
+static const char *__doc_nanogui_RenderPass_invalidate_attachments =
+R"doc(Invalidate the attachments that are loaded using LoadAction::DontCare
+(``begin=true``) or stored using StoreAction::Discard (``begin=false``))doc";
+
+static const char *__doc_nanogui_RenderPass_load_action =
+R"doc(Return the action applied to an attachment when the render pass
+begins
+
+Attachments are indexed as in targets(): 0 refers to the depth target,
+1 to the stencil target, and 2 onwards to the color targets.)doc";
+
 static const char *__doc_nanogui_RenderPass_m_active = R"doc()doc";
 
 static const char *__doc_nanogui_RenderPass_m_blit_target = R"doc()doc";
 
-static const char *__doc_nanogui_RenderPass_m_clear = R"doc()doc";
-
 static const char *__doc_nanogui_RenderPass_m_clear_color = R"doc()doc";
 
 static const char *__doc_nanogui_RenderPass_m_clear_depth = R"doc()doc";
@@ -1756,8 +2018,12 @@ static const char *__doc_nanogui_RenderPass_m_depth_write = R"doc()doc";
 
 static const char *__doc_nanogui_RenderPass_m_framebuffer_size = R"doc()doc";
 
+static const char *__doc_nanogui_RenderPass_m_load_action = R"doc()doc";
+
 static const char *__doc_nanogui_RenderPass_m_pass_descriptor = R"doc()doc";
 
+static const char *__doc_nanogui_RenderPass_m_store_action = R"doc()doc";
+
 static const char *__doc_nanogui_RenderPass_m_targets = R"doc()doc";
 
 static const char *__doc_nanogui_RenderPass_m_viewport_offset = R"doc()doc";
@@ -1772,12 +2038,31 @@ static const char *__doc_nanogui_RenderPass_set_clear_depth = R"doc(Set the clea
 
 static const char *__doc_nanogui_RenderPass_set_clear_stencil = R"doc(Set the clear stencil for the stencil attachment)doc";
 
+static const char *__doc_nanogui_RenderPass_set_blit_target =
+R"doc(Change the target that the render pass blits to when it ends (see
+RenderPass()))doc";
+
 static const char *__doc_nanogui_RenderPass_set_cull_mode = R"doc(Specify the culling mode associated with the render pass)doc";
 
 static const char *__doc_nanogui_RenderPass_set_depth_test = R"doc(Specify the depth test and depth write mask of this render pass)doc";
 
+static const char *__doc_nanogui_RenderPass_set_gpu_timer =
+R"doc(Measure the GPU time spent between begin() and end() using the given
+timer (or stop measuring if ``nullptr``))doc";
+
+static const char *__doc_nanogui_RenderPass_set_load_action = R"doc(Set the action applied to an attachment when the render pass begins)doc";
+
+static const char *__doc_nanogui_RenderPass_set_store_action = R"doc(Set the action applied to an attachment when the render pass ends)doc";
+
 static const char *__doc_nanogui_RenderPass_set_viewport = R"doc(Set the pixel offset and size of the viewport region)doc";
 
+static const char *__doc_nanogui_RenderPass_store_action =
+R"doc(Return the action applied to an attachment when the render pass ends
+
+Discarded attachments are invalidated using glInvalidateFramebuffer()
+(OpenGL 4.3 and GLES 3) or stored using MTLStoreActionDontCare
+(Metal). They are also skipped by blit_to().)doc";
+
 static const char *__doc_nanogui_RenderPass_targets =
 R"doc(Return the set of all render targets (including depth + stencil)
 associated with this render pass)doc";
@@ -1916,6 +2201,8 @@ DPI screens))doc";
 
 static const char *__doc_nanogui_Screen_glfw_window = R"doc(Return a pointer to the underlying GLFW window data structure)doc";
 
+static const char *__doc_nanogui_Screen_gpu_timer_overlay = R"doc(Are the statistics of all GPUTimer instances shown?)doc";
+
 static const char *__doc_nanogui_Screen_has_depth_buffer = R"doc(Does the framebuffer have a depth buffer)doc";
 
 static const char *__doc_nanogui_Screen_has_float_buffer = R"doc(Does the framebuffer use a floating point representation)doc";
@@ -2008,6 +2295,10 @@ static const char *__doc_nanogui_Screen_redraw =
 R"doc(Send an event that will cause the screen to be redrawn at the next
 event loop iteration)doc";
 
+static const char *__doc_nanogui_Screen_render_graph =
+R"doc(Return the graph that executes the render passes of deferred canvases
+(see Canvas::set_deferred()) before the widgets are drawn)doc";
+
 static const char *__doc_nanogui_Screen_resize_callback = R"doc(Set the resize callback)doc";
 
 static const char *__doc_nanogui_Screen_resize_callback_event = R"doc()doc";
@@ -2020,6 +2311,12 @@ static const char *__doc_nanogui_Screen_set_background = R"doc(Set the screen's
 
 static const char *__doc_nanogui_Screen_set_caption = R"doc(Set the window title bar caption)doc";
 
+static const char *__doc_nanogui_Screen_set_gpu_timer_overlay =
+R"doc(Show the statistics of all GPUTimer instances in the top left corner
+of the screen
+
+The overlay is updated whenever the screen is redrawn.)doc";
+
 static const char *__doc_nanogui_Screen_set_resize_callback = R"doc()doc";
 
 static const char *__doc_nanogui_Screen_set_shutdown_glfw = R"doc(Shut down GLFW when the window is closed?)doc";
@@ -2048,6 +2345,14 @@ static const char *__doc_nanogui_Shader_BlendMode_None = R"doc()doc";
 
 static const char *__doc_nanogui_Shader_Buffer = R"doc()doc";
 
+static const char *__doc_nanogui_Shader_BufferUsage = R"doc(Expected update frequency of a vertex or index buffer)doc";
+
+static const char *__doc_nanogui_Shader_BufferUsage_Dynamic = R"doc()doc";
+
+static const char *__doc_nanogui_Shader_BufferUsage_Static = R"doc()doc";
+
+static const char *__doc_nanogui_Shader_BufferUsage_Stream = R"doc()doc";
+
 static const char *__doc_nanogui_Shader_BufferType = R"doc()doc";
 
 static const char *__doc_nanogui_Shader_BufferType_FragmentBuffer = R"doc()doc";
@@ -2058,6 +2363,8 @@ static const char *__doc_nanogui_Shader_BufferType_FragmentTexture = R"doc()doc"
 
 static const char *__doc_nanogui_Shader_BufferType_IndexBuffer = R"doc()doc";
 
+static const char *__doc_nanogui_Shader_BufferType_UniformBlockBuffer = R"doc()doc";
+
 static const char *__doc_nanogui_Shader_BufferType_UniformBuffer = R"doc()doc";
 
 static const char *__doc_nanogui_Shader_BufferType_Unknown = R"doc()doc";
@@ -2070,22 +2377,54 @@ static const char *__doc_nanogui_Shader_BufferType_VertexTexture = R"doc()doc";
 
 static const char *__doc_nanogui_Shader_Buffer_buffer = R"doc()doc";
 
+static const char *__doc_nanogui_Shader_Buffer_capacity = R"doc(Size of the allocated storage (vertex and index buffers only))doc";
+
 static const char *__doc_nanogui_Shader_Buffer_dirty = R"doc()doc";
 
+static const char *__doc_nanogui_Shader_Buffer_divisor = R"doc(Instance divisor of a vertex attribute)doc";
+
 static const char *__doc_nanogui_Shader_Buffer_dtype = R"doc()doc";
 
 static const char *__doc_nanogui_Shader_Buffer_index = R"doc()doc";
 
 static const char *__doc_nanogui_Shader_Buffer_ndim = R"doc()doc";
 
+static const char *__doc_nanogui_Shader_Buffer_normalized = R"doc(Map integer vertex data to normalized floating point values?)doc";
+
+static const char *__doc_nanogui_Shader_Buffer_offset = R"doc(Byte offset of the data within the buffer)doc";
+
 static const char *__doc_nanogui_Shader_Buffer_shape = R"doc()doc";
 
 static const char *__doc_nanogui_Shader_Buffer_size = R"doc()doc";
 
+static const char *__doc_nanogui_Shader_Buffer_source = R"doc(Object that owns the buffer, if it is not owned by the shader)doc";
+
+static const char *__doc_nanogui_Shader_Buffer_stride = R"doc(Distance between consecutive vertices in bytes (0: tightly packed))doc";
+
 static const char *__doc_nanogui_Shader_Buffer_to_string = R"doc()doc";
 
 static const char *__doc_nanogui_Shader_Buffer_type = R"doc()doc";
 
+static const char *__doc_nanogui_Shader_Buffer_usage = R"doc()doc";
+
+static const char *__doc_nanogui_Shader_Parameter =
+R"doc(Lightweight handle to a named shader parameter
+
+Refers directly to the parameter's entry in the shader, hence using it
+involves no string operations. Obtained via Shader::parameter().)doc";
+
+static const char *__doc_nanogui_Shader_Parameter_Parameter = R"doc(Create an invalid handle)doc";
+
+static const char *__doc_nanogui_Shader_Parameter_m_entry = R"doc()doc";
+
+static const char *__doc_nanogui_Shader_Parameter_m_sampler = R"doc(Sampler state that accompanies a texture parameter (if any))doc";
+
+static const char *__doc_nanogui_Shader_Parameter_m_shader = R"doc()doc";
+
+static const char *__doc_nanogui_Shader_Parameter_name = R"doc(Return the name of the referenced shader parameter)doc";
+
+static const char *__doc_nanogui_Shader_Parameter_valid = R"doc(Does this handle refer to a shader parameter?)doc";
+
 static const char *__doc_nanogui_Shader_PrimitiveType = R"doc(The type of geometry that should be rendered)doc";
 
 static const char *__doc_nanogui_Shader_PrimitiveType_Line = R"doc()doc";
@@ -2112,7 +2451,42 @@ Parameter ``vertex_shader``:
     The source of the vertex shader as a string.
 
 Parameter ``fragment_shader``:
-    The source of the fragment shader as a string.)doc";
+    The source of the fragment shader as a string.
+
+Parameter ``blend_mode``:
+    The blending mode used when drawing with this shader.
+
+Parameter ``asynchronous``:
+    Return once compilation has been submitted instead of waiting for
+    the result (OpenGL/GLES only). Drivers that implement
+    KHR_parallel_shader_compile then compile in the background, and
+    ready() reports when the shader can be used without blocking. The
+    first call that needs the parameters of the shader (e.g.
+    set_buffer() or begin()) waits for the compilation, and
+    compilation errors are reported at this point.)doc";
+
+static const char *__doc_nanogui_Shader_VertexAttribute = R"doc(Description of an attribute within an interleaved vertex buffer)doc";
+
+static const char *__doc_nanogui_Shader_VertexAttribute_VertexAttribute = R"doc()doc";
+
+static const char *__doc_nanogui_Shader_VertexAttribute_VertexAttribute_2 = R"doc()doc";
+
+static const char *__doc_nanogui_Shader_VertexAttribute_components = R"doc(Number of components (must match the declaration in the shader))doc";
+
+static const char *__doc_nanogui_Shader_VertexAttribute_member =
+R"doc(Describe a member of a vertex struct, e.g.
+``VertexAttribute::member("position", &Vertex::position)``
+
+The member must be a scalar or a nanogui array (e.g. Vector3f), and
+the struct must be default-constructible.)doc";
+
+static const char *__doc_nanogui_Shader_VertexAttribute_name = R"doc(Name of the vertex attribute in the shader)doc";
+
+static const char *__doc_nanogui_Shader_VertexAttribute_normalized = R"doc(Map integer components to [0, 1] (unsigned) or [-1, 1] (signed)?)doc";
+
+static const char *__doc_nanogui_Shader_VertexAttribute_offset = R"doc(Byte offset of the attribute within a vertex)doc";
+
+static const char *__doc_nanogui_Shader_VertexAttribute_type = R"doc(Type of the attribute's components)doc";
 
 static const char *__doc_nanogui_Shader_begin =
 R"doc(Begin drawing using this shader
@@ -2124,6 +2498,8 @@ The Python bindings also include extra ``__enter__`` and ``__exit__``
 aliases so that the shader can be activated via Pythons 'with'
 statement.)doc";
 
+static const char *__doc_nanogui_Shader_binary_cache_directory = R"doc(Return the directory used to cache linked programs (empty if disabled))doc";
+
 static const char *__doc_nanogui_Shader_blend_mode = R"doc(Return the blending mode of this shader)doc";
 
 static const char *__doc_nanogui_Shader_draw_array =
@@ -2144,8 +2520,21 @@ Parameter ``indexed``:
     Render indexed geometry? In this case, an ``uint32_t`` valued
     buffer with name ``indices`` must have been uploaded using set().)doc";
 
+static const char *__doc_nanogui_Shader_draw_array_instanced =
+R"doc(Render several instances of geometry arrays, either directly or using
+an index array.
+
+Takes the same parameters as draw_array(). Vertex attributes with a
+nonzero divisor (see set_buffer_divisor()) advance per instance.
+Requires OpenGL 3.3, OpenGL ES 3, or Metal.
+
+Parameter ``instances``:
+    Number of instances to render)doc";
+
 static const char *__doc_nanogui_Shader_end = R"doc(End drawing using this shader)doc";
 
+static const char *__doc_nanogui_Shader_loaded_from_cache = R"doc(Was the program of this shader loaded from the binary cache?)doc";
+
 static const char *__doc_nanogui_Shader_m_blend_mode = R"doc()doc";
 
 static const char *__doc_nanogui_Shader_m_buffers = R"doc()doc";
@@ -2158,10 +2547,35 @@ static const char *__doc_nanogui_Shader_m_render_pass = R"doc()doc";
 
 static const char *__doc_nanogui_Shader_name = R"doc(Return the name of this shader)doc";
 
+static const char *__doc_nanogui_Shader_parameter =
+R"doc(Resolve a named shader parameter into a handle
+
+The handle can be passed to set_buffer(), set_uniform() and
+set_texture() in place of the name, which avoids hashing and comparing
+the name on every call. It remains valid for the lifetime of the
+shader.)doc";
+
+static const char *__doc_nanogui_Shader_ready =
+R"doc(Can the shader be used without waiting for its compilation?
+
+Always True unless the shader was created asynchronously and the
+driver is still compiling it in the background.)doc";
+
 static const char *__doc_nanogui_Shader_pipeline_state = R"doc()doc";
 
 static const char *__doc_nanogui_Shader_render_pass = R"doc(Return the render pass associated with this shader)doc";
 
+static const char *__doc_nanogui_Shader_set_binary_cache_directory =
+R"doc(Cache linked programs in the given directory (which must exist)
+
+Shaders created afterwards first try to load a program binary
+(glProgramBinary()) that matches their source code and the OpenGL
+vendor, renderer, and version strings. When no binary is found or the
+driver rejects it, the shader is compiled from source and the resulting
+binary is written to the cache. An empty path (the default) disables
+the cache. Program binaries require OpenGL 4.1 or OpenGL ES 3, the
+setting has no effect otherwise.)doc";
+
 static const char *__doc_nanogui_Shader_set_buffer =
 R"doc(Upload a buffer (e.g. vertex positions) that will be associated with a
 named shader parameter.
@@ -2175,15 +2589,163 @@ The buffer will be replaced if it is already present.)doc";
 
 static const char *__doc_nanogui_Shader_set_buffer_2 = R"doc()doc";
 
+static const char *__doc_nanogui_Shader_set_buffer_3 = R"doc(Upload a buffer associated with a previously resolved shader parameter)doc";
+
+static const char *__doc_nanogui_Shader_set_buffer_4 = R"doc()doc";
+
+static const char *__doc_nanogui_Shader_set_buffer_divisor =
+R"doc(Set the instance divisor of a vertex attribute
+
+With a divisor of zero (the default), the attribute advances once per
+vertex. Otherwise, it advances once per ``divisor`` instances drawn by
+draw_array_instanced(). Not supported on OpenGL ES 2 and Metal (Metal
+shaders should index per-instance data using ``[[instance_id]]``
+instead).)doc";
+
+static const char *__doc_nanogui_Shader_set_buffer_divisor_2 = R"doc(Set the instance divisor of a vertex attribute associated with a previously resolved parameter)doc";
+
+static const char *__doc_nanogui_Shader_set_buffer_usage =
+R"doc(Specify how often a vertex or index buffer will be updated
+
+The hint is passed to the graphics API when storage is allocated for
+the buffer (the default is BufferUsage::Dynamic). Setting it causes the
+next set_buffer() call to reallocate the storage.)doc";
+
+static const char *__doc_nanogui_Shader_set_buffer_usage_2 = R"doc(Specify how often a buffer associated with a previously resolved parameter will be updated)doc";
+
+static const char *__doc_nanogui_Shader_set_interleaved_buffer =
+R"doc(Upload a buffer that provides several vertex attributes in an
+interleaved (array of structs) layout
+
+In Python, the buffer is given as a structured NumPy array whose field
+names match the vertex attributes. Integer fields listed in
+``normalized`` are mapped to [0, 1] (unsigned) or [-1, 1] (signed).
+
+Parameter ``layout``:
+    Location and type of each attribute within a vertex
+
+Parameter ``stride``:
+    Size of a vertex in bytes
+
+Parameter ``count``:
+    Number of vertices
+
+All attributes of the layout are sourced from a single buffer.
+Uploading again with the same attributes reuses its storage.)doc";
+
+static const char *__doc_nanogui_Shader_set_interleaved_buffer_2 = R"doc(Upload an array of vertex structs (see VertexAttribute::member()))doc";
+
+static const char *__doc_nanogui_Shader_set_stream_buffer =
+R"doc(Source a vertex attribute from a range of a StreamBuffer
+
+Parameter ``offset``:
+    Offset of the data within the stream buffer in bytes (as returned
+    by StreamBuffer::write())
+
+The remaining parameters describe the data as in set_buffer(). Calling
+set_buffer() afterwards switches the attribute back to storage owned by
+the shader.)doc";
+
+static const char *__doc_nanogui_Shader_set_stream_buffer_2 = R"doc(Source a vertex attribute associated with a previously resolved parameter from a StreamBuffer)doc";
+
 static const char *__doc_nanogui_Shader_set_texture =
 R"doc(Associate a texture with a named shader parameter
 
 The association will be replaced if it is already present.)doc";
 
+static const char *__doc_nanogui_Shader_set_texture_2 = R"doc(Associate a texture with a previously resolved shader parameter)doc";
+
 static const char *__doc_nanogui_Shader_set_uniform =
 R"doc(Upload a uniform variable (e.g. a vector or matrix) that will be
 associated with a named shader parameter.)doc";
 
+static const char *__doc_nanogui_Shader_set_uniform_2 = R"doc(Upload a uniform variable associated with a previously resolved shader parameter)doc";
+
+static const char *__doc_nanogui_Shader_set_uniform_block =
+R"doc(Associate a UniformBlock with a uniform block declared by the shader
+
+The same block may be shared by many shaders. Its contents are uploaded
+(if modified) when any of them is activated via begin().)doc";
+
+static const char *__doc_nanogui_Shader_set_uniform_block_2 = R"doc(Associate a UniformBlock with a previously resolved shader parameter)doc";
+
+static const char *__doc_nanogui_Shader_update_buffer =
+R"doc(Overwrite a range of entries of a vertex or index buffer that was
+previously uploaded using set_buffer().
+
+``offset`` and ``shape[0]`` specify the range of entries (e.g.
+vertices) along the first dimension; the remaining dimensions and the
+type must match the existing buffer. Only the given range is
+transferred, and the GPU storage is not reallocated. The exception is
+Metal while the render pass is active: draw calls encoded before the
+update then keep reading the previous contents from the old storage.)doc";
+
+static const char *__doc_nanogui_Shader_update_buffer_2 = R"doc(Overwrite a range of entries of a buffer associated with a previously resolved parameter)doc";
+
+static const char *__doc_nanogui_ShaderLibrary =
+R"doc(Set of shader variants that are generated from a single vertex and
+fragment shader source containing ``#ifdef`` feature switches.
+
+Each feature name is assigned a bit according to its position in the
+list passed to the constructor. A variant is identified by a bit mask
+of the enabled features and compiled on first use, which prepends
+``#define NAME 1`` lines for the enabled features to both sources
+(following the ``#version`` directive, if present). The shader
+compiler hence strips the code paths of disabled features. Compiled
+variants are cached by their bit mask.
+
+Variants inherit the disk cache of
+Shader::set_binary_cache_directory(), since the defines are part of
+the hashed source code.
+
+Use NANOGUI_SHADER_SOURCE to pass shaders embedded by bin2c. On Metal,
+this refers to the shader source code rather than to the precompiled
+library, which cannot be specialized.)doc";
+
+static const char *__doc_nanogui_ShaderLibrary_ShaderLibrary =
+R"doc(Initialize the library (no shaders are compiled yet)
+
+Parameter ``render_pass``:
+    Render pass that the shader variants are used with
+
+Parameter ``name``:
+    Name of the library, which also prefixes the variant names
+
+Parameter ``vertex_shader``:
+    Source of the vertex shader
+
+Parameter ``fragment_shader``:
+    Source of the fragment shader
+
+Parameter ``features``:
+    Names of the preprocessor switches (at most 32)
+
+Parameter ``blend_mode``:
+    Blend mode of all variants
+
+Parameter ``asynchronous``:
+    Compile variants asynchronously (see Shader::Shader()))doc";
+
+static const char *__doc_nanogui_ShaderLibrary_clear = R"doc(Release all compiled variants)doc";
+
+static const char *__doc_nanogui_ShaderLibrary_feature = R"doc(Return the bit associated with a feature switch)doc";
+
+static const char *__doc_nanogui_ShaderLibrary_features = R"doc(Return the names of the feature switches)doc";
+
+static const char *__doc_nanogui_ShaderLibrary_has_shader = R"doc(Has the variant with the given set of enabled features been compiled?)doc";
+
+static const char *__doc_nanogui_ShaderLibrary_name = R"doc(Return the name of the library)doc";
+
+static const char *__doc_nanogui_ShaderLibrary_shader =
+R"doc(Return the variant with the given set of enabled features, compiling
+it if needed
+
+The returned shader remains owned by the library.)doc";
+
+static const char *__doc_nanogui_ShaderLibrary_shader_count = R"doc(Return the number of compiled variants)doc";
+
+static const char *__doc_nanogui_ShaderLibrary_specialize = R"doc(Return the source code of a variant's shader stage)doc";
+
 static const char *__doc_nanogui_Slider = R"doc()doc";
 
 static const char *__doc_nanogui_Slider_2 =
@@ -2237,6 +2799,64 @@ static const char *__doc_nanogui_Slider_set_value = R"doc()doc";
 
 static const char *__doc_nanogui_Slider_value = R"doc()doc";
 
+static const char *__doc_nanogui_StreamBuffer =
+R"doc(Vertex buffer for data that is regenerated every frame (e.g.
+immediate-mode overlays), which avoids reallocating GPU storage and
+waiting for the GPU on every upload.
+
+The buffer is split into three equally sized segments that are used for
+consecutive frames in round-robin fashion. next_frame() places a fence
+after the commands of the current frame and, before a segment is
+reused, waits for the fence that protects it, which normally has long
+been signaled. Data is written to one of the following:
+
+- A persistently and coherently mapped buffer (``glBufferStorage``,
+  OpenGL 4.4 and newer).
+- Otherwise, a range mapped using ``glMapBufferRange()`` with
+  ``GL_MAP_UNSYNCHRONIZED_BIT`` (OpenGL 3 and OpenGL ES 3).
+- On OpenGL ES 2, a CPU staging area that is copied using
+  ``glBufferSubData()``.
+
+Use Shader::set_stream_buffer() to source a vertex attribute from an
+offset inside the buffer.)doc";
+
+static const char *__doc_nanogui_StreamBuffer_SegmentCount = R"doc()doc";
+
+static const char *__doc_nanogui_StreamBuffer_StreamBuffer =
+R"doc(Allocate a stream buffer
+
+Parameter ``frame_size``:
+    Number of bytes that can be written per frame (the buffer allocates
+    three times as much))doc";
+
+static const char *__doc_nanogui_StreamBuffer_buffer_handle = R"doc(Return the OpenGL handle of the underlying buffer)doc";
+
+static const char *__doc_nanogui_StreamBuffer_frame_size = R"doc(Return the number of bytes that can be written per frame)doc";
+
+static const char *__doc_nanogui_StreamBuffer_map =
+R"doc(Reserve space in the current frame's segment and return a pointer that
+the caller fills with ``size`` bytes
+
+The write must be completed using unmap() before drawing. The offset of
+the reserved range within the buffer (aligned to ``alignment`` bytes) is
+stored in ``offset``.)doc";
+
+static const char *__doc_nanogui_StreamBuffer_next_frame =
+R"doc(Finish the current frame and move on to the next segment
+
+Must be called once per frame after the draw calls that read from the
+buffer have been issued.)doc";
+
+static const char *__doc_nanogui_StreamBuffer_persistent = R"doc(Does the buffer use a persistent mapping?)doc";
+
+static const char *__doc_nanogui_StreamBuffer_unmap = R"doc(Finish a write started using map())doc";
+
+static const char *__doc_nanogui_StreamBuffer_used = R"doc(Return the number of bytes written during the current frame)doc";
+
+static const char *__doc_nanogui_StreamBuffer_wait_segment = R"doc(Wait until the GPU has finished reading from the given segment)doc";
+
+static const char *__doc_nanogui_StreamBuffer_write = R"doc(Copy data into the current frame's segment and return its offset within the buffer)doc";
+
 static const char *__doc_nanogui_TabWidget = R"doc()doc";
 
 static const char *__doc_nanogui_TabWidget_2 =
@@ -2681,6 +3301,148 @@ static const char *__doc_nanogui_TextBox_value = R"doc()doc";
 
 static const char *__doc_nanogui_Texture = R"doc()doc";
 
+static const char *__doc_nanogui_TextureAtlas =
+R"doc(Packs many small images into the regions of a single texture, so that
+drawing them does not require switching between textures.
+
+Regions are placed using a skyline bottom-left packer and surrounded by
+a border that replicates their edge pixels, which prevents neighboring
+regions from bleeding into each other under bilinear interpolation.
+Removing a region does not immediately make its space reusable;
+defragment() repacks the remaining regions (which happens automatically
+when add() runs out of space). When eviction is enabled, add()
+additionally drops the least recently used regions to make room.
+
+The atlas keeps a CPU copy of its contents, which it uses to repack
+regions without reading back the texture.)doc";
+
+static const char *__doc_nanogui_TextureAtlas_TextureAtlas =
+R"doc(Allocate an empty atlas
+
+Parameter ``size``:
+    Size of the underlying texture
+
+Parameter ``padding``:
+    Width of the border around each region)doc";
+
+static const char *__doc_nanogui_TextureAtlas_add =
+R"doc(Copy an image into a free region of the atlas
+
+The image uses the atlas's pixel and component format. When
+``row_pitch`` is zero, rows are assumed to be densely packed.
+
+Returns:
+    An identifier of the region, or -1 if the image does not fit (even
+    after defragmentation and eviction))doc";
+
+static const char *__doc_nanogui_TextureAtlas_contains = R"doc(Does the atlas contain the given region?)doc";
+
+static const char *__doc_nanogui_TextureAtlas_defragment =
+R"doc(Repack the regions to reclaim the space of removed ones
+
+Returns:
+    ``False`` (leaving the layout unchanged) if the regions could not
+    be repacked)doc";
+
+static const char *__doc_nanogui_TextureAtlas_eviction = R"doc(Evict least recently used regions when add() runs out of space?)doc";
+
+static const char *__doc_nanogui_TextureAtlas_evictions = R"doc(Return the number of regions dropped to make room for new ones)doc";
+
+static const char *__doc_nanogui_TextureAtlas_nvg_image =
+R"doc(Return a NanoVG image that refers to the underlying texture
+
+To draw a region, pass its position and the atlas size (scaled to the
+destination) to ``nvgImagePattern()``. The image is created once per
+NanoVG context and deleted along with the atlas.)doc";
+
+static const char *__doc_nanogui_TextureAtlas_occupancy = R"doc(Return the fraction of the texture covered by regions (including padding))doc";
+
+static const char *__doc_nanogui_TextureAtlas_position = R"doc(Return the position of a region within the texture (in pixels))doc";
+
+static const char *__doc_nanogui_TextureAtlas_region_count = R"doc(Return the number of regions currently held by the atlas)doc";
+
+static const char *__doc_nanogui_TextureAtlas_region_size = R"doc(Return the size of a region (in pixels))doc";
+
+static const char *__doc_nanogui_TextureAtlas_remove = R"doc(Release a region)doc";
+
+static const char *__doc_nanogui_TextureAtlas_set_eviction = R"doc(Evict least recently used regions when add() runs out of space?)doc";
+
+static const char *__doc_nanogui_TextureAtlas_size = R"doc(Return the size of the underlying texture)doc";
+
+static const char *__doc_nanogui_TextureAtlas_texture = R"doc(Return the underlying texture)doc";
+
+static const char *__doc_nanogui_TextureAtlas_update = R"doc(Replace the contents of an existing region (the size must match))doc";
+
+static const char *__doc_nanogui_TextureAtlas_uv =
+R"doc(Return the texture coordinates of a region as ``(u0, v0, u1, v1)``
+and mark it as recently used
+
+Regions move when the atlas is defragmented, hence the coordinates
+should be queried again before drawing.)doc";
+
+static const char *__doc_nanogui_TextureCache =
+R"doc(Process-wide cache that hands out shared instances of textures loaded
+from files, as well as NanoVG images created from memory.
+
+Textures are keyed by their path, modification time, sampler settings,
+and the OpenGL context that was current when they were requested, so
+that editing a file on disk causes it to be loaded again. When the
+resident entries exceed the budget, the least recently requested
+textures are dropped from the cache. Dropped textures remain valid for
+as long as other references to them exist.
+
+NanoVG images count towards the budget but are never evicted, since
+widgets keep their integer handles (e.g. via nvgImageIcon()). They are
+only deleted along with their NanoVG context (see release()).)doc";
+
+static const char *__doc_nanogui_TextureCache_Stats = R"doc(Cache statistics)doc";
+
+static const char *__doc_nanogui_TextureCache_Stats_bytes = R"doc(Estimated GPU memory (in bytes) consumed by the entries)doc";
+
+static const char *__doc_nanogui_TextureCache_Stats_entries = R"doc(Number of entries currently held by the cache)doc";
+
+static const char *__doc_nanogui_TextureCache_Stats_evictions = R"doc(Number of entries dropped to stay within the budget)doc";
+
+static const char *__doc_nanogui_TextureCache_Stats_hits = R"doc(Number of requests served from the cache)doc";
+
+static const char *__doc_nanogui_TextureCache_Stats_misses = R"doc(Number of requests that had to load the image)doc";
+
+static const char *__doc_nanogui_TextureCache_budget = R"doc(Return the amount of GPU memory that cache entries may consume)doc";
+
+static const char *__doc_nanogui_TextureCache_clear = R"doc(Drop all textures (NanoVG images are kept, see release()))doc";
+
+static const char *__doc_nanogui_TextureCache_nvg_image = R"doc(Return a shared NanoVG image created from an in-memory image file)doc";
+
+static const char *__doc_nanogui_TextureCache_release = R"doc(Drop the entries belonging to a window and its NanoVG context)doc";
+
+static const char *__doc_nanogui_TextureCache_set_budget = R"doc(Set the amount of GPU memory (in bytes) that cache entries may consume)doc";
+
+static const char *__doc_nanogui_TextureCache_stats = R"doc(Return the cache statistics)doc";
+
+static const char *__doc_nanogui_TextureCache_texture = R"doc(Return a shared texture for the given image file (see Texture::Texture()))doc";
+
+static const char *__doc_nanogui_TextureReadback =
+R"doc(Handle to a pending asynchronous texture readback
+
+Instances are created by Texture::download_async(). The GPU copies the
+texture contents into a staging buffer in the background; ready() can
+be polled each frame, and read() retrieves the data once it is
+available.)doc";
+
+static const char *__doc_nanogui_TextureReadback_bytes_per_pixel = R"doc(Return the number of bytes per pixel of the data written by read())doc";
+
+static const char *__doc_nanogui_TextureReadback_channels = R"doc(Return the number of channels of the data written by read())doc";
+
+static const char *__doc_nanogui_TextureReadback_read =
+R"doc(Copy the packed pixel data into ``data``
+
+Blocks if the readback has not finished yet. The output has the same
+layout as the one produced by Texture::download().)doc";
+
+static const char *__doc_nanogui_TextureReadback_ready = R"doc(Has the GPU finished copying the texture contents? (never blocks))doc";
+
+static const char *__doc_nanogui_TextureReadback_size = R"doc(Return the size of the texture region that was read back)doc";
+
 static const char *__doc_nanogui_Texture_2 = R"doc()doc";
 
 static const char *__doc_nanogui_Texture_3 = R"doc()doc";
@@ -2711,16 +3473,36 @@ static const char *__doc_nanogui_Texture_InterpolationMode_Nearest = R"doc(Neare
 
 static const char *__doc_nanogui_Texture_InterpolationMode_Trilinear = R"doc(Trilinear interpolation (using MIP mapping))doc";
 
+static const char *__doc_nanogui_Texture_MipmapFilter = R"doc(How are the levels of the mip map computed? (see set_mipmap_filter()))doc";
+
+static const char *__doc_nanogui_Texture_MipmapFilter_Box = R"doc(2x2 box filter evaluated on the CPU)doc";
+
+static const char *__doc_nanogui_Texture_MipmapFilter_GPU = R"doc(Via generate_mipmap() on the GPU (implementation-defined filter))doc";
+
+static const char *__doc_nanogui_Texture_MipmapFilter_Kaiser = R"doc(Kaiser-windowed sinc filter (6 taps per dimension) evaluated on the CPU)doc";
+
 static const char *__doc_nanogui_Texture_PixelFormat = R"doc(Overall format of the texture (e.g. luminance-only or RGBA))doc";
 
+static const char *__doc_nanogui_Texture_PixelFormat_ASTC_4x4_RGBA = R"doc(ASTC block-compressed RGB bitmap + alpha channel (4x4 blocks of 16 bytes))doc";
+
 static const char *__doc_nanogui_Texture_PixelFormat_BGR = R"doc(BGR bitmap)doc";
 
 static const char *__doc_nanogui_Texture_PixelFormat_BGRA = R"doc(BGR bitmap + alpha channel)doc";
 
+static const char *__doc_nanogui_Texture_PixelFormat_BC1_RGBA = R"doc(BC1 (DXT1) block-compressed RGB bitmap + 1 bit alpha (4x4 blocks of 8 bytes))doc";
+
+static const char *__doc_nanogui_Texture_PixelFormat_BC3_RGBA = R"doc(BC3 (DXT5) block-compressed RGB bitmap + alpha channel (4x4 blocks of 16 bytes))doc";
+
+static const char *__doc_nanogui_Texture_PixelFormat_BC7_RGBA = R"doc(BC7 block-compressed RGB bitmap + alpha channel (4x4 blocks of 16 bytes))doc";
+
 static const char *__doc_nanogui_Texture_PixelFormat_Depth = R"doc(Depth map)doc";
 
 static const char *__doc_nanogui_Texture_PixelFormat_DepthStencil = R"doc(Combined depth + stencil map)doc";
 
+static const char *__doc_nanogui_Texture_PixelFormat_ETC2_RGB = R"doc(ETC2 block-compressed RGB bitmap (4x4 blocks of 8 bytes))doc";
+
+static const char *__doc_nanogui_Texture_PixelFormat_ETC2_RGBA = R"doc(ETC2/EAC block-compressed RGB bitmap + alpha channel (4x4 blocks of 16 bytes))doc";
+
 static const char *__doc_nanogui_Texture_PixelFormat_R = R"doc(Single-channel bitmap)doc";
 
 static const char *__doc_nanogui_Texture_PixelFormat_RA = R"doc(Two-channel bitmap)doc";
@@ -2729,6 +3511,18 @@ static const char *__doc_nanogui_Texture_PixelFormat_RGB = R"doc(RGB bitmap)doc"
 
 static const char *__doc_nanogui_Texture_PixelFormat_RGBA = R"doc(RGB bitmap + alpha channel)doc";
 
+static const char *__doc_nanogui_Texture_PoolStats = R"doc(Counters describing the pool of recycled GPU texture storage)doc";
+
+static const char *__doc_nanogui_Texture_PoolStats_bytes = R"doc(Memory (in bytes) consumed by the idle entries)doc";
+
+static const char *__doc_nanogui_Texture_PoolStats_entries = R"doc(Number of idle entries currently held by the pool)doc";
+
+static const char *__doc_nanogui_Texture_PoolStats_evictions = R"doc(Number of idle entries freed to stay within the pool limit)doc";
+
+static const char *__doc_nanogui_Texture_PoolStats_hits = R"doc(Number of allocations served from previously released storage)doc";
+
+static const char *__doc_nanogui_Texture_PoolStats_misses = R"doc(Number of allocations that required new storage)doc";
+
 static const char *__doc_nanogui_Texture_Texture =
 R"doc(Allocate memory for a texture with the given configuration
 
@@ -2739,10 +3533,22 @@ pixel_format() and component_format(). Some caution must be exercised
 in this case, since upload() will need to provide the data in a
 different storage format.)doc";
 
-static const char *__doc_nanogui_Texture_Texture_2 = R"doc(Load an image from the given file using stb-image)doc";
+static const char *__doc_nanogui_Texture_Texture_2 =
+R"doc(Load an image from the given file
+
+KTX and KTX2 containers are recognized by their file signature and may
+hold block-compressed data as well as a pre-built mip chain. Other
+files are decoded using stb-image.)doc";
 
 static const char *__doc_nanogui_Texture_TextureFlags = R"doc(How will the texture be used? (Must specify at least one))doc";
 
+static const char *__doc_nanogui_Texture_TextureFlags_ImplicitResolve =
+R"doc(Multisampled render target whose samples only exist in the tile memory
+of the GPU and are resolved implicitly when the render pass ends (GLES
+with EXT_multisampled_render_to_texture, see
+implicit_resolve_supported()). The texture itself stores a single
+sample per pixel, hence it can be combined with ShaderRead.)doc";
+
 static const char *__doc_nanogui_Texture_TextureFlags_RenderTarget = R"doc(Target framebuffer for rendering)doc";
 
 static const char *__doc_nanogui_Texture_TextureFlags_ShaderRead = R"doc(Texture to be read in shaders)doc";
@@ -2755,18 +3561,59 @@ static const char *__doc_nanogui_Texture_WrapMode_MirrorRepeat = R"doc(Repeat, b
 
 static const char *__doc_nanogui_Texture_WrapMode_Repeat = R"doc(Repeat the texture)doc";
 
+static const char *__doc_nanogui_Texture_block_size = R"doc(Return the size of the pixel blocks (1x1 for uncompressed formats))doc";
+
 static const char *__doc_nanogui_Texture_bytes_per_pixel = R"doc(Return the number of bytes consumed per pixel of this texture)doc";
 
 static const char *__doc_nanogui_Texture_channels = R"doc(Return the number of channels of this texture)doc";
 
+static const char *__doc_nanogui_Texture_clear_pool = R"doc(Free all idle pooled storage belonging to the current OpenGL context)doc";
+
+static const char *__doc_nanogui_Texture_compressed = R"doc(Return whether the pixel format is block-compressed)doc";
+
 static const char *__doc_nanogui_Texture_component_format = R"doc(Return the component format)doc";
 
-static const char *__doc_nanogui_Texture_download = R"doc(Download packed pixel data from the GPU to the CPU)doc";
+static const char *__doc_nanogui_Texture_data_size = R"doc(Return the number of bytes needed to store an image of the given size)doc";
+
+static const char *__doc_nanogui_Texture_download =
+R"doc(Download packed pixel data from the GPU to the CPU
+
+This is equivalent to ``download_async()->read(data)`` and blocks
+until the GPU has finished all pending work on the texture. Use
+download_async() to overlap the transfer with rendering.)doc";
+
+static const char *__doc_nanogui_Texture_download_async =
+R"doc(Begin an asynchronous download of the texture contents
+
+On OpenGL and GLES 3, the texture is attached to a temporary
+framebuffer and read via ``glReadPixels`` into a pixel pack buffer,
+which does not stall the rendering pipeline. Rows of render targets
+are flipped while copying the result out of the buffer. Not supported
+on GLES 2.
+
+GLES 3 only reads back RGB/RGBA color textures whose component
+format is ``UInt8``, ``Float32``, or the type reported by
+``GL_IMPLEMENTATION_COLOR_READ_TYPE``; other textures raise an
+exception.)doc";
 
 static const char *__doc_nanogui_Texture_flags = R"doc(Return a combination of flags (from Texture::TextureFlags))doc";
 
 static const char *__doc_nanogui_Texture_init = R"doc(Initialize the texture handle)doc";
 
+static const char *__doc_nanogui_Texture_load_async =
+R"doc(Load an image from the given file on a background thread
+
+Returns a 1x1 transparent RGBA texture that can be used as a
+placeholder right away. The file is decoded by a pool of worker
+threads, and the pixel data is then uploaded from the main loop via
+async(), at which point the texture takes on the format and size of
+the image and ``callback`` is invoked with an empty error message. If
+the file cannot be loaded, the placeholder remains and ``callback``
+receives a description of the problem. Decoding stalls while the
+decoded images awaiting upload exceed set_load_limit().)doc";
+
+static const char *__doc_nanogui_Texture_load_limit = R"doc(Return the amount of decoded image data that may await upload)doc";
+
 static const char *__doc_nanogui_Texture_m_component_format = R"doc()doc";
 
 static const char *__doc_nanogui_Texture_m_flags = R"doc()doc";
@@ -2789,26 +3636,97 @@ static const char *__doc_nanogui_Texture_m_wrap_mode = R"doc()doc";
 
 static const char *__doc_nanogui_Texture_mag_interpolation_mode = R"doc(Return the interpolation mode for minimization)doc";
 
+static const char *__doc_nanogui_Texture_mipmap_filter = R"doc(Return the filter used to compute the mip map)doc";
+
 static const char *__doc_nanogui_Texture_min_interpolation_mode = R"doc(Return the interpolation mode for minimization)doc";
 
 static const char *__doc_nanogui_Texture_pixel_format = R"doc(Return the pixel format)doc";
 
+static const char *__doc_nanogui_Texture_pool_limit = R"doc(Return the amount of memory that may be held by idle pooled storage)doc";
+
+static const char *__doc_nanogui_Texture_pool_stats = R"doc(Return counters describing the texture pool)doc";
+
 static const char *__doc_nanogui_Texture_resize = R"doc(Resize the texture (discards the current contents))doc";
 
 static const char *__doc_nanogui_Texture_sampler_state_handle = R"doc()doc";
 
 static const char *__doc_nanogui_Texture_samples = R"doc(Return the number of samples (MSAA))doc";
 
+static const char *__doc_nanogui_Texture_set_load_limit = R"doc(Set the amount of decoded image data (in bytes) that may await upload)doc";
+
+static const char *__doc_nanogui_Texture_set_mipmap_filter =
+R"doc(Compute the mip map on the CPU using the given filter
+
+Applies to subsequent uploads of textures that use trilinear
+interpolation without manual mip mapping. The texture then keeps a CPU
+copy of all levels, so that upload_sub_region() only recomputes and
+uploads the affected region of each level. Until the first full upload,
+region updates use generate_mipmap() instead. When ``srgb`` is set,
+color channels are filtered in linear space. Supports UInt8, UInt16,
+Float16, and Float32 components.)doc";
+
+static const char *__doc_nanogui_Texture_set_pool_limit =
+R"doc(Set the amount of memory (in bytes) that may be held by idle texture
+storage awaiting reuse
+
+Textures created while a Screen's context is current return their
+storage to a pool upon destruction instead of freeing it, and new
+textures with a matching format, size, sample count, and flags pick it
+up again. Render buffers (i.e. textures with only the RenderTarget
+flag) are allocated with their size rounded up to a coarse
+granularity (except on GLES 2, which requires equally sized
+attachments), which also allows resize() to skip the reallocation when
+the new size falls into the same bucket. Resizing other render targets
+swaps their storage for pooled storage of the new size. The least
+recently released entries are freed once the limit is exceeded. A
+limit of zero disables pooling.
+
+The pool is not synchronized. Like the OpenGL contexts that it belongs
+to, it must only be used by the thread that renders.)doc";
+
 static const char *__doc_nanogui_Texture_size = R"doc(Return the size of this texture)doc";
 
 static const char *__doc_nanogui_Texture_texture_handle = R"doc()doc";
 
-static const char *__doc_nanogui_Texture_upload = R"doc(Upload packed pixel data from the CPU to the GPU)doc";
+static const char *__doc_nanogui_Texture_upload =
+R"doc(Upload packed pixel data from the CPU to the GPU
+
+Block-compressed data is passed as is. Since mip maps cannot be
+generated for compressed formats, only level 0 will be sampled unless
+the remaining levels are provided via upload_mip_level().)doc";
+
+static const char *__doc_nanogui_Texture_upload_async =
+R"doc(Upload packed pixel data from the CPU to the GPU without waiting for
+the transfer to complete
+
+The data is copied into one of several pixel unpack buffers (PBOs)
+that are cycled through in a ring, and the texture is subsequently
+updated from that buffer on the GPU timeline. The caller may reuse or
+release ``data`` as soon as this function returns. Use
+upload_finished() to check whether the GPU has consumed the uploaded
+data.
+
+Falls back to upload() on backends without pixel buffer objects (GLES
+2).)doc";
+
+static const char *__doc_nanogui_Texture_upload_finished =
+R"doc(Check whether all uploads issued via upload_async() and
+upload_sub_region_async() have completed
+
+This function never blocks.)doc";
+
+static const char *__doc_nanogui_Texture_upload_mip_level =
+R"doc(Upload one level of a manually specified mip chain
+
+upload() provides level 0, and the remaining levels must follow in
+increasing order. The size of level ``i`` is ``max(1, size >> i)``.)doc";
 
 static const char *__doc_nanogui_Texture_upload_origin = R"doc(Upload packed pixel data to a rectangular sub-region of the texture from the CPU to the GPU)doc";
 
 static const char *__doc_nanogui_Texture_generate_mipmap = R"doc(Generates the mipmap. Done automatically upon upload if manual mipmapping is disabled)doc";
 
+static const char *__doc_nanogui_Texture_implicit_resolve_supported = R"doc(Can the current context create textures with the ImplicitResolve flag?)doc";
+
 static const char *__doc_nanogui_Texture_wrap_mode = R"doc(Return the wrap mode)doc";
 
 static const char *__doc_nanogui_Theme = R"doc()doc";
@@ -3017,6 +3935,94 @@ static const char *__doc_nanogui_Theme_m_window_title_unfocused =
 R"doc(The title color for a Window that is not in focus (default:
 intensity=``220``, alpha=``160``; see nanogui::Color::Color(int,int)).)doc";
 
+static const char *__doc_nanogui_TiledImage =
+R"doc(Image of arbitrary size that is displayed from a pyramid of square
+tiles (a "virtual texture"), for use with ImageView.
+
+Level 0 of the pyramid holds the image at full resolution, and every
+further level halves the resolution until the whole image fits into a
+single tile. A user-provided loader produces tiles on a background
+thread. Only the tiles needed for the visible part of the image at the
+current magnification are requested; they are stored in a fixed-size
+cache texture, and least recently used tiles are replaced as the view
+changes.
+
+An indirection texture with one texel per level 0 tile records which
+cache slot (and pyramid level) provides the pixels of that tile.
+Missing tiles resolve to the finest coarser tile that is resident, so
+the image gradually sharpens while tiles are still loading.)doc";
+
+static const char *__doc_nanogui_TiledImage_LoaderState = R"doc(State shared with the loader thread)doc";
+
+static const char *__doc_nanogui_TiledImage_Slot = R"doc()doc";
+
+static const char *__doc_nanogui_TiledImage_TiledImage =
+R"doc(Create a tiled image
+
+The loader is called with a pyramid level and tile index and returns an
+array holding ``tile_size x tile_size`` densely packed pixels (or
+``None`` if the tile could not be produced). It runs on a background
+thread.
+
+Parameter ``size``:
+    Size of the image (level 0) in pixels
+
+Parameter ``loader``:
+    Callback that produces the tiles
+
+Parameter ``tile_size``:
+    Size of the square tiles in pixels
+
+Parameter ``cache_size``:
+    Number of tiles along each axis of the GPU tile cache)doc";
+
+static const char *__doc_nanogui_TiledImage_cache_texture = R"doc(Return the texture holding the cached tiles)doc";
+
+static const char *__doc_nanogui_TiledImage_indirection_texture = R"doc(Return the texture mapping level 0 tiles to cache slots)doc";
+
+static const char *__doc_nanogui_TiledImage_insert_tile = R"doc(Upload a loaded tile into a free or least recently used slot)doc";
+
+static const char *__doc_nanogui_TiledImage_level_count = R"doc(Return the number of pyramid levels)doc";
+
+static const char *__doc_nanogui_TiledImage_level_size = R"doc(Return the size of a pyramid level in pixels)doc";
+
+static const char *__doc_nanogui_TiledImage_loader_thread = R"doc(Body of the threads that run the tile loader)doc";
+
+static const char *__doc_nanogui_TiledImage_pending_tiles = R"doc(Return the number of requested tiles that have not been loaded yet)doc";
+
+static const char *__doc_nanogui_TiledImage_resident_tiles = R"doc(Return the number of tiles currently held by the cache)doc";
+
+static const char *__doc_nanogui_TiledImage_size = R"doc(Return the size of the image (level 0) in pixels)doc";
+
+static const char *__doc_nanogui_TiledImage_tile_bytes = R"doc(Return the number of bytes that the loader writes per tile)doc";
+
+static const char *__doc_nanogui_TiledImage_tile_count = R"doc(Return the number of tiles along each axis of a pyramid level)doc";
+
+static const char *__doc_nanogui_TiledImage_tile_key = R"doc()doc";
+
+static const char *__doc_nanogui_TiledImage_tile_size = R"doc(Return the size of the square tiles in pixels)doc";
+
+static const char *__doc_nanogui_TiledImage_update =
+R"doc(Page in the tiles covering a region of the image
+
+Uploads tiles that finished loading, requests the missing tiles of the
+region (coarse levels first), and refreshes the indirection texture.
+Called by ImageView before drawing.
+
+Parameter ``min``:
+    Upper left corner of the visible region (in level 0 pixels)
+
+Parameter ``max``:
+    Lower right corner of the visible region (in level 0 pixels)
+
+Parameter ``scale``:
+    Number of screen pixels per level 0 pixel
+
+Returns:
+    ``True`` when all tiles of the region are resident)doc";
+
+static const char *__doc_nanogui_TiledImage_update_indirection = R"doc(Recompute and upload the indirection texture for the given target level)doc";
+
 static const char *__doc_nanogui_ToolButton = R"doc()doc";
 
 static const char *__doc_nanogui_ToolButton_2 =
@@ -3026,6 +4032,61 @@ Simple radio+toggle button with an icon.)doc";
 
 static const char *__doc_nanogui_ToolButton_ToolButton = R"doc()doc";
 
+static const char *__doc_nanogui_UniformBlock =
+R"doc(CPU mirror of a GLSL uniform block that is stored in a uniform buffer
+object and can be shared by any number of shaders.
+
+The layout (member offsets and strides) is queried from a shader that
+declares the block. Blocks should be declared with
+``layout(std140)``, which guarantees an identical layout in every
+shader that uses the same declaration. Member updates only modify the
+CPU copy; the modified byte range is uploaded using a single
+``glBufferSubData()`` call by upload(), which Shader::begin() invokes
+automatically.
+
+Each block owns a dedicated uniform buffer binding point, hence the
+buffer stays bound while switching between shaders. Uniform blocks
+require OpenGL 3.1 or OpenGL ES 3.)doc";
+
+static const char *__doc_nanogui_UniformBlock_Member = R"doc()doc";
+
+static const char *__doc_nanogui_UniformBlock_UniformBlock =
+R"doc(Allocate a uniform buffer matching a block declared by a shader
+
+Parameter ``shader``:
+    A shader that declares the block
+
+Parameter ``name``:
+    The name of the block (not of its instance))doc";
+
+static const char *__doc_nanogui_UniformBlock_bind =
+R"doc(Bind the uniform buffer to its binding point
+
+This happens automatically when the block is created or uploaded, and
+only needs to be repeated when other code changed the binding.)doc";
+
+static const char *__doc_nanogui_UniformBlock_binding = R"doc(Return the uniform buffer binding point used by this block)doc";
+
+static const char *__doc_nanogui_UniformBlock_buffer_handle = R"doc(Return the OpenGL handle of the uniform buffer)doc";
+
+static const char *__doc_nanogui_UniformBlock_data = R"doc(Return the CPU copy of the block)doc";
+
+static const char *__doc_nanogui_UniformBlock_has_member = R"doc(Does the block have a member with the given name?)doc";
+
+static const char *__doc_nanogui_UniformBlock_name = R"doc(Return the name of the block)doc";
+
+static const char *__doc_nanogui_UniformBlock_set_member =
+R"doc(Write a member of the block (into the CPU copy)
+
+Matrices should be specified in column-major order. Arrays of scalars
+and vectors are indexed by the first dimension of ``shape``.)doc";
+
+static const char *__doc_nanogui_UniformBlock_set_uniform = R"doc(Write a scalar, vector, or matrix member of the block (into the CPU copy))doc";
+
+static const char *__doc_nanogui_UniformBlock_size = R"doc(Return the size of the block in bytes)doc";
+
+static const char *__doc_nanogui_UniformBlock_upload = R"doc(Upload the modified part of the block (if any) to the uniform buffer)doc";
+
 static const char *__doc_nanogui_VScrollPanel = R"doc()doc";
 
 static const char *__doc_nanogui_VScrollPanel_2 =
@@ -3555,6 +4616,13 @@ static const char *__doc_nanogui_load_image_directory =
 R"doc(Load a directory of PNG images and upload them to the GPU (suitable
 for use with ImagePanel))doc";
 
+static const char *__doc_nanogui_load_image_directory_2 =
+R"doc(Load a directory of PNG images into the regions of an RGBA atlas
+
+Returns pairs of region identifiers and file names (without
+extension), which are suitable for use with an ImagePanel that draws
+from the atlas.)doc";
+
 static const char *__doc_nanogui_mainloop =
 R"doc(Enter the application main loop
 
@@ -3,6 +3,7 @@
 #include <nanobind/ndarray.h>
 
 #include "python.h"
+#include <algorithm>
 
 static VariableType interpret_dlpack_dtype(nb::dlpack::dtype dtype) {
     switch ((nb::dlpack::dtype_code) dtype.code) {
@@ -42,8 +43,8 @@ static VariableType interpret_dlpack_dtype(nb::dlpack::dtype dtype) {
     return VariableType::Invalid;
 }
 
-static void
-shader_set_buffer(Shader &shader, const std::string &name,
+template <typename Key> static void
+shader_set_buffer(Shader &shader, const Key &key,
                   nb::ndarray<nb::device::cpu, nb::c_contig> array) {
     if (array.ndim() > 3)
         throw nb::type_error("Shader::set_buffer(): number of array dimensions must be < 3!");
@@ -59,28 +60,142 @@ shader_set_buffer(Shader &shader, const std::string &name,
         array.ndim() > 2 ? (size_t) array.shape(2) : 1
     };
 
-    shader.set_buffer(name, dtype, array.ndim(), dim, array.data());
+    shader.set_buffer(key, dtype, array.ndim(), dim, array.data());
 }
 
-static nb::ndarray<nb::numpy> texture_download(Texture &texture) {
+template <typename Key> static void
+shader_update_buffer(Shader &shader, const Key &key, size_t offset,
+                     nb::ndarray<nb::device::cpu, nb::c_contig> array) {
+    if (array.ndim() > 3)
+        throw nb::type_error("Shader::update_buffer(): number of array dimensions must be < 3!");
+
+    VariableType dtype = interpret_dlpack_dtype(array.dtype());
+
+    if (dtype == VariableType::Invalid)
+        throw nb::type_error("Shader::update_buffer(): unsupported array dtype!");
+
+    size_t dim[3] {
+        array.ndim() > 0 ? (size_t) array.shape(0) : 1,
+        array.ndim() > 1 ? (size_t) array.shape(1) : 1,
+        array.ndim() > 2 ? (size_t) array.shape(2) : 1
+    };
+
+    shader.update_buffer(key, offset, dtype, array.ndim(), dim, array.data());
+}
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+template <typename Key> static void
+shader_set_stream_buffer(Shader &shader, const Key &key, StreamBuffer *stream, size_t offset,
+                         nb::ndarray<nb::device::cpu, nb::c_contig> array) {
+    if (array.ndim() > 3)
+        throw nb::type_error("Shader::set_stream_buffer(): number of array dimensions must be < 3!");
+
+    VariableType dtype = interpret_dlpack_dtype(array.dtype());
+
+    if (dtype == VariableType::Invalid)
+        throw nb::type_error("Shader::set_stream_buffer(): unsupported array dtype!");
+
+    size_t dim[3] {
+        array.ndim() > 0 ? (size_t) array.shape(0) : 1,
+        array.ndim() > 1 ? (size_t) array.shape(1) : 1,
+        array.ndim() > 2 ? (size_t) array.shape(2) : 1
+    };
+
+    shader.set_stream_buffer(key, stream, offset, dtype, array.ndim(), dim);
+}
+
+static size_t stream_buffer_write(StreamBuffer &stream,
+                                  nb::ndarray<nb::device::cpu, nb::c_contig> array,
+                                  size_t alignment) {
+    return stream.write(array.data(), array.nbytes(), alignment);
+}
+
+static void
+uniform_block_set_member(UniformBlock &block, const std::string &name,
+                         nb::ndarray<nb::device::cpu, nb::c_contig> array) {
+    if (array.ndim() > 3)
+        throw nb::type_error("UniformBlock::set_member(): number of array dimensions must be < 3!");
+
+    VariableType dtype = interpret_dlpack_dtype(array.dtype());
+
+    if (dtype == VariableType::Invalid)
+        throw nb::type_error("UniformBlock::set_member(): unsupported array dtype!");
+
+    size_t dim[3] {
+        array.ndim() > 0 ? (size_t) array.shape(0) : 1,
+        array.ndim() > 1 ? (size_t) array.shape(1) : 1,
+        array.ndim() > 2 ? (size_t) array.shape(2) : 1
+    };
+
+    block.set_member(name, dtype, array.ndim(), dim, array.data());
+}
+#endif
+
+static void
+shader_set_interleaved_buffer(Shader &shader, nb::handle array,
+                              const std::vector<std::string> &normalized) {
+    nb::object dtype = array.attr("dtype"),
+               fields = dtype.attr("fields");
+    if (fields.is_none())
+        throw nb::type_error("Shader::set_interleaved_buffer(): expected a structured "
+                             "NumPy array!");
+    if (!nb::cast<bool>(array.attr("flags")["C_CONTIGUOUS"]))
+        throw nb::type_error("Shader::set_interleaved_buffer(): the array must be contiguous!");
+
+    std::vector<Shader::VertexAttribute> layout;
+    for (auto [name, field] : nb::cast<nb::dict>(fields)) {
+        nb::object sub = field[0], base = sub.attr("base");
+        std::string kind = nb::cast<std::string>(base.attr("kind"));
+        size_t item_size = nb::cast<size_t>(base.attr("itemsize")),
+               components = 1;
+        for (nb::handle n : sub.attr("shape"))
+            components *= nb::cast<size_t>(n);
+
+        VariableType type = VariableType::Invalid;
+        if (kind == "f")
+            type = item_size == 2 ? VariableType::Float16 : item_size == 4 ? VariableType::Float32 : type;
+        else if (kind == "i")
+            type = item_size == 1 ? VariableType::Int8 : item_size == 2 ? VariableType::Int16 :
+                   item_size == 4 ? VariableType::Int32 : type;
+        else if (kind == "u")
+            type = item_size == 1 ? VariableType::UInt8 : item_size == 2 ? VariableType::UInt16 :
+                   item_size == 4 ? VariableType::UInt32 : type;
+
+        std::string field_name = nb::cast<std::string>(name);
+        if (type == VariableType::Invalid)
+            throw nb::type_error(("Shader::set_interleaved_buffer(): field \"" + field_name +
+                                  "\" has an unsupported dtype!").c_str());
+
+        bool norm = std::find(normalized.begin(), normalized.end(), field_name) != normalized.end();
+        layout.emplace_back(field_name, nb::cast<size_t>(field[1]), type, components, norm);
+    }
+
+    uintptr_t data = nb::cast<uintptr_t>(array.attr("__array_interface__")["data"][0]);
+    shader.set_interleaved_buffer(layout, nb::cast<size_t>(dtype.attr("itemsize")),
+                                  nb::cast<size_t>(array.attr("size")), (const void *) data);
+}
+
+static nb::ndarray<nb::numpy>
+download_impl(const Vector2i &size, size_t channels, VariableType dtype,
+              const std::function<void(uint8_t *)> &download) {
     nb::dlpack::dtype dt;
 
-    switch (texture.component_format()) {
-        case Texture::ComponentFormat::Int8:    dt = nb::dtype<int8_t>(); break;
-        case Texture::ComponentFormat::UInt8:   dt = nb::dtype<uint8_t>(); break;
-        case Texture::ComponentFormat::Int16:   dt = nb::dtype<int16_t>(); break;
-        case Texture::ComponentFormat::UInt16:  dt = nb::dtype<uint16_t>(); break;
-        case Texture::ComponentFormat::Int32:   dt = nb::dtype<int32_t>(); break;
-        case Texture::ComponentFormat::UInt32:  dt = nb::dtype<uint32_t>(); break;
-        case Texture::ComponentFormat::Float16: dt = nb::dtype<float>(); dt.bits = 16; break;
-        case Texture::ComponentFormat::Float32: dt = nb::dtype<float>(); break;
+    switch (dtype) {
+        case VariableType::Int8:    dt = nb::dtype<int8_t>(); break;
+        case VariableType::UInt8:   dt = nb::dtype<uint8_t>(); break;
+        case VariableType::Int16:   dt = nb::dtype<int16_t>(); break;
+        case VariableType::UInt16:  dt = nb::dtype<uint16_t>(); break;
+        case VariableType::Int32:   dt = nb::dtype<int32_t>(); break;
+        case VariableType::UInt32:  dt = nb::dtype<uint32_t>(); break;
+        case VariableType::Float16: dt = nb::dtype<float>(); dt.bits = 16; break;
+        case VariableType::Float32: dt = nb::dtype<float>(); break;
         default: throw std::runtime_error("Invalid component format");
     }
 
     // Dynamically allocate 'data'
-    size_t shape[3] = { (size_t) texture.size().y(),
-                        (size_t) texture.size().x(),
-                        (size_t) texture.channels() };
+    size_t shape[3] = { (size_t) size.y(),
+                        (size_t) size.x(),
+                        channels };
     uint8_t *ptr = new uint8_t[shape[0] * shape[1] * shape[2] * dt.bits / 8];
 
     // Delete 'data' when the 'owner' capsule expires
@@ -88,13 +203,41 @@ static nb::ndarray<nb::numpy> texture_download(Texture &texture) {
        delete[] (uint8_t *) p;
     });
 
-    texture.download(ptr);
+    download(ptr);
 
     return nb::ndarray<nb::numpy>(ptr, 3, shape, owner, nullptr, dt);
 }
 
+static nb::ndarray<nb::numpy> texture_download(Texture &texture) {
+    return download_impl(texture.size(), texture.channels(),
+                         (VariableType) texture.component_format(),
+                         [&](uint8_t *ptr) { texture.download(ptr); });
+}
+
+static nb::ndarray<nb::numpy> texture_readback_read(TextureReadback &readback) {
+    return download_impl(readback.size(), readback.channels(), readback.dtype(),
+                         [&](uint8_t *ptr) { readback.read(ptr); });
+}
+
 static void texture_upload(Texture &texture,
-                           nb::ndarray<nb::device::cpu, nb::c_contig> array) {
+                           nb::ndarray<nb::device::cpu, nb::c_contig> array,
+                           bool async = false) {
+    if (texture.compressed()) {
+        /* Block-compressed data is passed through as a flat byte array */
+        if (array.dtype() != nb::dtype<uint8_t>() ||
+            array.nbytes() != texture.data_size(texture.size()))
+            throw std::runtime_error(
+                "Texture::upload(): expected a uint8 array with " +
+                std::to_string(texture.data_size(texture.size())) +
+                " bytes of block-compressed data!");
+
+        if (async)
+            texture.upload_async((const uint8_t *) array.data());
+        else
+            texture.upload((const uint8_t *) array.data());
+        return;
+    }
+
     size_t n_channels          = array.ndim() == 3 ? array.shape(2) : 1;
     VariableType dtype         = interpret_dlpack_dtype(array.dtype()),
                  dtype_texture = (VariableType) texture.component_format();
@@ -115,12 +258,49 @@ static void texture_upload(Texture &texture,
             type_name(dtype) + ") does not match the texture (" +
             type_name(dtype_texture) + ")!");
 
-    texture.upload((const uint8_t *) array.data());
+    if (async)
+        texture.upload_async((const uint8_t *) array.data());
+    else
+        texture.upload((const uint8_t *) array.data());
+}
+
+static void texture_upload_mip_level(Texture &texture, uint32_t level,
+                                     nb::ndarray<nb::device::cpu, nb::c_contig> array) {
+    Vector2i size(std::max(1, texture.size().x() >> level),
+                  std::max(1, texture.size().y() >> level));
+
+    if (interpret_dlpack_dtype(array.dtype()) != (VariableType) texture.component_format() ||
+        array.nbytes() != texture.data_size(size))
+        throw std::runtime_error(
+            "Texture::upload_mip_level(): expected an array with " +
+            std::to_string(texture.data_size(size)) + " bytes matching the component "
+            "format of the texture!");
+
+    texture.upload_mip_level(level, (const uint8_t *) array.data());
+}
+
+/// Check that an array holds an image in the format of an atlas and return its size
+static Vector2i texture_atlas_image_size(TextureAtlas &atlas,
+                                         nb::ndarray<nb::device::cpu, nb::c_contig> &array) {
+    const Texture *texture = atlas.texture();
+    size_t n_channels = array.ndim() == 3 ? array.shape(2) : 1;
+
+    if (array.ndim() != 2 && array.ndim() != 3)
+        throw std::runtime_error("TextureAtlas: expected a 2 or 3-dimensional array!");
+    else if (n_channels != texture->channels())
+        throw std::runtime_error(
+            std::string("TextureAtlas: number of color channels in array (") +
+            std::to_string(n_channels) + ") does not match the atlas (" +
+            std::to_string(texture->channels()) + ")!");
+    else if (interpret_dlpack_dtype(array.dtype()) != (VariableType) texture->component_format())
+        throw std::runtime_error("TextureAtlas: dtype of array does not match the atlas!");
+
+    return Vector2i((int32_t) array.shape(1), (int32_t) array.shape(0));
 }
 
 static void
 texture_upload_sub_region(Texture &texture,
-                          nb::ndarray<nb::device::cpu, nb::c_contig> array,
+                          nb::ndarray<nb::device::cpu> array,
                           const Vector2i &origin) {
     size_t n_channels          = array.ndim() == 3 ? array.shape(2) : 1;
     VariableType dtype         = interpret_dlpack_dtype(array.dtype()),
@@ -128,8 +308,8 @@ texture_upload_sub_region(Texture &texture,
 
     if (array.ndim() != 2 && array.ndim() != 3)
         throw std::runtime_error("Texture::upload_sub_region(): expected a 2 or 3-dimensional array!");
-    else if (array.shape(0) + (size_t) origin.x() > (size_t) texture.size().y() ||
-             array.shape(1) + (size_t) origin.y() > (size_t) texture.size().x())
+    else if (array.shape(0) + (size_t) origin.y() > (size_t) texture.size().y() ||
+             array.shape(1) + (size_t) origin.x() > (size_t) texture.size().x())
         throw std::runtime_error("Texture::upload_sub_region(): bounds exceed the size of the texture!");
     else if (n_channels != texture.channels())
         throw std::runtime_error(
@@ -142,9 +322,19 @@ texture_upload_sub_region(Texture &texture,
             type_name(dtype) + ") does not match the texture (" +
             type_name(dtype_texture) + ")!");
 
+    /* Rows may be strided (e.g. a slice of a larger image), but the pixels
+       within a row must be densely packed */
+    if ((array.ndim() == 3 && array.stride(2) != 1) ||
+        array.stride(1) != (int64_t) n_channels || array.stride(0) < 0)
+        throw std::runtime_error(
+            "Texture::upload_sub_region(): the pixels within each row of the array "
+            "must be contiguous!");
+
+    size_t row_pitch = (size_t) array.stride(0) * array.dtype().bits / 8;
+
     texture.upload_sub_region(
         (const uint8_t *) array.data(), origin,
-        { (int32_t) array.shape(0), (int32_t) array.shape(1) });
+        { (int32_t) array.shape(1), (int32_t) array.shape(0) }, row_pitch);
 }
 #endif
 
@@ -153,6 +343,7 @@ void register_render(nb::module_ &m) {
     using ComponentFormat   = Texture::ComponentFormat;
     using InterpolationMode = Texture::InterpolationMode;
     using WrapMode          = Texture::WrapMode;
+    using MipmapFilter      = Texture::MipmapFilter;
     using TextureFlags      = Texture::TextureFlags;
     using PrimitiveType     = Shader::PrimitiveType;
     using BlendMode         = Shader::BlendMode;
@@ -169,7 +360,13 @@ void register_render(nb::module_ &m) {
         .value("BGR", PixelFormat::BGR, D(Texture, PixelFormat, BGR))
         .value("BGRA", PixelFormat::BGRA, D(Texture, PixelFormat, BGRA))
         .value("Depth", PixelFormat::Depth, D(Texture, PixelFormat, Depth))
-        .value("DepthStencil", PixelFormat::DepthStencil, D(Texture, PixelFormat, DepthStencil));
+        .value("DepthStencil", PixelFormat::DepthStencil, D(Texture, PixelFormat, DepthStencil))
+        .value("ETC2_RGB", PixelFormat::ETC2_RGB, D(Texture, PixelFormat, ETC2_RGB))
+        .value("ETC2_RGBA", PixelFormat::ETC2_RGBA, D(Texture, PixelFormat, ETC2_RGBA))
+        .value("ASTC_4x4_RGBA", PixelFormat::ASTC_4x4_RGBA, D(Texture, PixelFormat, ASTC_4x4_RGBA))
+        .value("BC1_RGBA", PixelFormat::BC1_RGBA, D(Texture, PixelFormat, BC1_RGBA))
+        .value("BC3_RGBA", PixelFormat::BC3_RGBA, D(Texture, PixelFormat, BC3_RGBA))
+        .value("BC7_RGBA", PixelFormat::BC7_RGBA, D(Texture, PixelFormat, BC7_RGBA));
 
     nb::enum_<ComponentFormat>(texture, "ComponentFormat", D(Texture, ComponentFormat))
         .value("UInt8", ComponentFormat::UInt8, D(Texture, ComponentFormat, UInt8))
@@ -191,9 +388,22 @@ void register_render(nb::module_ &m) {
         .value("Repeat", WrapMode::Repeat, D(Texture, WrapMode, Repeat))
         .value("MirrorRepeat", WrapMode::MirrorRepeat, D(Texture, WrapMode, MirrorRepeat));
 
+    nb::enum_<MipmapFilter>(texture, "MipmapFilter", D(Texture, MipmapFilter))
+        .value("GPU", MipmapFilter::GPU, D(Texture, MipmapFilter, GPU))
+        .value("Box", MipmapFilter::Box, D(Texture, MipmapFilter, Box))
+        .value("Kaiser", MipmapFilter::Kaiser, D(Texture, MipmapFilter, Kaiser));
+
     nb::enum_<TextureFlags>(texture, "TextureFlags", D(Texture, TextureFlags), nb::is_arithmetic())
         .value("ShaderRead", TextureFlags::ShaderRead, D(Texture, TextureFlags, ShaderRead))
-        .value("RenderTarget", TextureFlags::RenderTarget, D(Texture, TextureFlags, RenderTarget));
+        .value("RenderTarget", TextureFlags::RenderTarget, D(Texture, TextureFlags, RenderTarget))
+        .value("ImplicitResolve", TextureFlags::ImplicitResolve, D(Texture, TextureFlags, ImplicitResolve));
+
+    nb::class_<Texture::PoolStats>(texture, "PoolStats", D(Texture, PoolStats))
+        .def_ro("hits", &Texture::PoolStats::hits, D(Texture, PoolStats, hits))
+        .def_ro("misses", &Texture::PoolStats::misses, D(Texture, PoolStats, misses))
+        .def_ro("evictions", &Texture::PoolStats::evictions, D(Texture, PoolStats, evictions))
+        .def_ro("entries", &Texture::PoolStats::entries, D(Texture, PoolStats, entries))
+        .def_ro("bytes", &Texture::PoolStats::bytes, D(Texture, PoolStats, bytes));
 
     texture
         .def(nb::init<PixelFormat, ComponentFormat, const Vector2i &,
@@ -219,11 +429,39 @@ void register_render(nb::module_ &m) {
         .def("size", &Texture::size, D(Texture, size))
         .def("bytes_per_pixel", &Texture::bytes_per_pixel, D(Texture, bytes_per_pixel))
         .def("channels", &Texture::channels, D(Texture, channels))
+        .def("compressed", &Texture::compressed, D(Texture, compressed))
+        .def("block_size", &Texture::block_size, D(Texture, block_size))
+        .def("data_size", &Texture::data_size, D(Texture, data_size))
         .def("download", &texture_download, D(Texture, download))
-        .def("upload", &texture_upload, D(Texture, upload))
+        .def("download_async", &Texture::download_async, D(Texture, download_async))
+        .def("upload", [](Texture &t, nb::ndarray<nb::device::cpu, nb::c_contig> a) {
+                 texture_upload(t, a);
+             }, D(Texture, upload))
+        .def("upload_async", [](Texture &t, nb::ndarray<nb::device::cpu, nb::c_contig> a) {
+                 texture_upload(t, a, true);
+             }, D(Texture, upload_async))
+        .def("upload_finished", &Texture::upload_finished, D(Texture, upload_finished))
+        .def("upload_mip_level", &texture_upload_mip_level, "level"_a, "data"_a,
+             D(Texture, upload_mip_level))
         .def("upload_sub_region", &texture_upload_sub_region, D(Texture, upload, origin))
         .def("generate_mipmap", &Texture::generate_mipmap, D(Texture, generate_mipmap))
+        .def("set_mipmap_filter", &Texture::set_mipmap_filter, "filter"_a, "srgb"_a = false,
+             D(Texture, set_mipmap_filter))
+        .def("mipmap_filter", &Texture::mipmap_filter, D(Texture, mipmap_filter))
         .def("resize", &Texture::resize, D(Texture, resize))
+        .def_static("load_async", &Texture::load_async, "filename"_a,
+                    "callback"_a = nb::none(),
+                    "min_interpolation_mode"_a = InterpolationMode::Bilinear,
+                    "mag_interpolation_mode"_a = InterpolationMode::Bilinear,
+                    "wrap_mode"_a = WrapMode::ClampToEdge, D(Texture, load_async))
+        .def_static("set_load_limit", &Texture::set_load_limit, D(Texture, set_load_limit))
+        .def_static("load_limit", &Texture::load_limit, D(Texture, load_limit))
+        .def_static("set_pool_limit", &Texture::set_pool_limit, D(Texture, set_pool_limit))
+        .def_static("pool_limit", &Texture::pool_limit, D(Texture, pool_limit))
+        .def_static("pool_stats", &Texture::pool_stats, D(Texture, pool_stats))
+        .def_static("clear_pool", &Texture::clear_pool, D(Texture, clear_pool))
+        .def_static("implicit_resolve_supported", &Texture::implicit_resolve_supported,
+                    D(Texture, implicit_resolve_supported))
 #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
         .def("texture_handle", &Texture::texture_handle)
         .def("renderbuffer_handle", &Texture::renderbuffer_handle)
@@ -233,6 +471,109 @@ void register_render(nb::module_ &m) {
 #endif
         ;
 
+    auto texture_cache = nb::class_<TextureCache>(m, "TextureCache", D(TextureCache));
+
+    nb::class_<TextureCache::Stats>(texture_cache, "Stats", D(TextureCache, Stats))
+        .def_ro("hits", &TextureCache::Stats::hits, D(TextureCache, Stats, hits))
+        .def_ro("misses", &TextureCache::Stats::misses, D(TextureCache, Stats, misses))
+        .def_ro("evictions", &TextureCache::Stats::evictions, D(TextureCache, Stats, evictions))
+        .def_ro("entries", &TextureCache::Stats::entries, D(TextureCache, Stats, entries))
+        .def_ro("bytes", &TextureCache::Stats::bytes, D(TextureCache, Stats, bytes));
+
+    texture_cache
+        .def_static("texture", &TextureCache::texture, "filename"_a,
+                    "min_interpolation_mode"_a = InterpolationMode::Bilinear,
+                    "mag_interpolation_mode"_a = InterpolationMode::Bilinear,
+                    "wrap_mode"_a = WrapMode::ClampToEdge, D(TextureCache, texture))
+        .def_static("set_budget", &TextureCache::set_budget, D(TextureCache, set_budget))
+        .def_static("budget", &TextureCache::budget, D(TextureCache, budget))
+        .def_static("stats", &TextureCache::stats, D(TextureCache, stats))
+        .def_static("clear", &TextureCache::clear, D(TextureCache, clear));
+
+    nb::class_<TextureAtlas, Object>(m, "TextureAtlas", D(TextureAtlas))
+        .def(nb::init<const Vector2i &, PixelFormat, ComponentFormat, int,
+                      InterpolationMode, InterpolationMode>(),
+             D(TextureAtlas, TextureAtlas), "size"_a = Vector2i(1024, 1024),
+             "pixel_format"_a = PixelFormat::RGBA,
+             "component_format"_a = ComponentFormat::UInt8, "padding"_a = 1,
+             "min_interpolation_mode"_a = InterpolationMode::Bilinear,
+             "mag_interpolation_mode"_a = InterpolationMode::Bilinear)
+        .def("add", [](TextureAtlas &atlas, nb::ndarray<nb::device::cpu, nb::c_contig> array) {
+                 Vector2i size = texture_atlas_image_size(atlas, array);
+                 return atlas.add((const uint8_t *) array.data(), size);
+             }, "data"_a, D(TextureAtlas, add))
+        .def("update", [](TextureAtlas &atlas, int id,
+                          nb::ndarray<nb::device::cpu, nb::c_contig> array) {
+                 if (texture_atlas_image_size(atlas, array) != atlas.region_size(id))
+                     throw std::runtime_error("TextureAtlas::update(): size mismatch!");
+                 atlas.update(id, (const uint8_t *) array.data());
+             }, "id"_a, "data"_a, D(TextureAtlas, update))
+        .def("remove", &TextureAtlas::remove, D(TextureAtlas, remove))
+        .def("contains", &TextureAtlas::contains, D(TextureAtlas, contains))
+        .def("position", &TextureAtlas::position, D(TextureAtlas, position))
+        .def("region_size", &TextureAtlas::region_size, D(TextureAtlas, region_size))
+        .def("uv", &TextureAtlas::uv, D(TextureAtlas, uv))
+        .def("defragment", &TextureAtlas::defragment, D(TextureAtlas, defragment))
+        .def("eviction", &TextureAtlas::eviction, D(TextureAtlas, eviction))
+        .def("set_eviction", &TextureAtlas::set_eviction, D(TextureAtlas, set_eviction))
+        .def("region_count", &TextureAtlas::region_count, D(TextureAtlas, region_count))
+        .def("evictions", &TextureAtlas::evictions, D(TextureAtlas, evictions))
+        .def("occupancy", &TextureAtlas::occupancy, D(TextureAtlas, occupancy))
+        .def("size", &TextureAtlas::size, D(TextureAtlas, size))
+        .def("texture", nb::overload_cast<>(&TextureAtlas::texture), D(TextureAtlas, texture))
+        .def("nvg_image", &TextureAtlas::nvg_image, D(TextureAtlas, nvg_image));
+
+    nb::class_<TiledImage, Object>(m, "TiledImage", D(TiledImage))
+        .def("__init__",
+             [](TiledImage *t, const Vector2i &size,
+                const std::function<nb::object(uint32_t, const Vector2i &)> &loader,
+                int tile_size, const Vector2i &cache_size, PixelFormat pixel_format,
+                ComponentFormat component_format) {
+                 /* The loader returns an array holding the tile (or None),
+                    and is invoked from background threads */
+                 auto tile_bytes = std::make_shared<size_t>(0);
+                 auto wrapper = [loader, tile_bytes](uint32_t level, const Vector2i &tile,
+                                                     uint8_t *data) {
+                     nb::gil_scoped_acquire guard;
+                     nb::object result = loader(level, tile);
+                     if (result.is_none())
+                         return false;
+                     auto array = nb::cast<nb::ndarray<nb::device::cpu, nb::c_contig>>(result);
+                     if (array.nbytes() != *tile_bytes)
+                         throw std::runtime_error(
+                             "TiledImage: expected the loader to return " +
+                             std::to_string(*tile_bytes) + " bytes per tile!");
+                     memcpy(data, array.data(), array.nbytes());
+                     return true;
+                 };
+                 new (t) TiledImage(size, wrapper, tile_size, cache_size, pixel_format,
+                                    component_format);
+                 *tile_bytes = t->tile_bytes();
+             },
+             "size"_a, "loader"_a, "tile_size"_a = 256,
+             "cache_size"_a = Vector2i(16, 16), "pixel_format"_a = PixelFormat::RGBA,
+             "component_format"_a = ComponentFormat::UInt8, D(TiledImage, TiledImage))
+        .def("size", &TiledImage::size, D(TiledImage, size))
+        .def("tile_size", &TiledImage::tile_size, D(TiledImage, tile_size))
+        .def("tile_bytes", &TiledImage::tile_bytes, D(TiledImage, tile_bytes))
+        .def("level_count", &TiledImage::level_count, D(TiledImage, level_count))
+        .def("level_size", &TiledImage::level_size, D(TiledImage, level_size))
+        .def("tile_count", &TiledImage::tile_count, D(TiledImage, tile_count))
+        .def("update", &TiledImage::update, "min"_a, "max"_a, "scale"_a,
+             D(TiledImage, update))
+        .def("resident_tiles", &TiledImage::resident_tiles, D(TiledImage, resident_tiles))
+        .def("pending_tiles", &TiledImage::pending_tiles, D(TiledImage, pending_tiles))
+        .def("cache_texture", &TiledImage::cache_texture, D(TiledImage, cache_texture))
+        .def("indirection_texture", &TiledImage::indirection_texture,
+             D(TiledImage, indirection_texture));
+
+    nb::class_<TextureReadback, Object>(m, "TextureReadback", D(TextureReadback))
+        .def("ready", &TextureReadback::ready, D(TextureReadback, ready))
+        .def("read", &texture_readback_read, D(TextureReadback, read))
+        .def("size", &TextureReadback::size, D(TextureReadback, size))
+        .def("channels", &TextureReadback::channels, D(TextureReadback, channels))
+        .def("bytes_per_pixel", &TextureReadback::bytes_per_pixel, D(TextureReadback, bytes_per_pixel));
+
     auto shader = nb::class_<Shader, Object>(m, "Shader", D(Shader));
 
     nb::enum_<BlendMode>(shader, "BlendMode", D(Shader, BlendMode))
@@ -241,13 +582,41 @@ void register_render(nb::module_ &m) {
 
     shader
         .def(nb::init<RenderPass *, const std::string &,
-                      const std::string &, const std::string &, Shader::BlendMode>(),
+                      const std::string &, const std::string &, Shader::BlendMode, bool>(),
              D(Shader, Shader), "render_pass"_a, "name"_a, "vertex_shader"_a,
-             "fragment_shader"_a, "blend_mode"_a = BlendMode::None)
+             "fragment_shader"_a, "blend_mode"_a = BlendMode::None,
+             "asynchronous"_a = false)
         .def("name", &Shader::name, D(Shader, name))
         .def("blend_mode", &Shader::blend_mode, D(Shader, blend_mode))
-        .def("set_buffer", &shader_set_buffer, D(Shader, set_buffer))
-        .def("set_texture", &Shader::set_texture, D(Shader, set_texture))
+        .def("ready", &Shader::ready, D(Shader, ready))
+        .def("parameter", &Shader::parameter, D(Shader, parameter))
+        .def("set_buffer", &shader_set_buffer<std::string>, D(Shader, set_buffer))
+        .def("set_buffer", &shader_set_buffer<Shader::Parameter>, D(Shader, set_buffer, 3))
+        .def("set_interleaved_buffer", &shader_set_interleaved_buffer,
+             D(Shader, set_interleaved_buffer), "array"_a,
+             "normalized"_a = std::vector<std::string>())
+        .def("update_buffer", &shader_update_buffer<std::string>, D(Shader, update_buffer),
+             "name"_a, "offset"_a, "array"_a)
+        .def("update_buffer", &shader_update_buffer<Shader::Parameter>,
+             D(Shader, update_buffer, 2), "parameter"_a, "offset"_a, "array"_a)
+        .def("set_buffer_usage",
+             nb::overload_cast<const std::string &, Shader::BufferUsage>(&Shader::set_buffer_usage),
+             D(Shader, set_buffer_usage))
+        .def("set_buffer_usage",
+             nb::overload_cast<const Shader::Parameter &, Shader::BufferUsage>(&Shader::set_buffer_usage),
+             D(Shader, set_buffer_usage, 2))
+        .def("set_buffer_divisor",
+             nb::overload_cast<const std::string &, uint32_t>(&Shader::set_buffer_divisor),
+             D(Shader, set_buffer_divisor))
+        .def("set_buffer_divisor",
+             nb::overload_cast<const Shader::Parameter &, uint32_t>(&Shader::set_buffer_divisor),
+             D(Shader, set_buffer_divisor, 2))
+        .def("set_texture",
+             nb::overload_cast<const std::string &, Texture *>(&Shader::set_texture),
+             D(Shader, set_texture))
+        .def("set_texture",
+             nb::overload_cast<const Shader::Parameter &, Texture *>(&Shader::set_texture),
+             D(Shader, set_texture, 2))
         .def("begin", &Shader::begin, D(Shader, begin))
         .def("end", &Shader::end, D(Shader, end))
         .def("__enter__", &Shader::begin)
@@ -255,8 +624,26 @@ void register_render(nb::module_ &m) {
              "type"_a.none(), "value"_a.none(), "traceback"_a.none())
         .def("draw_array", &Shader::draw_array, D(Shader, draw_array),
              "primitive_type"_a, "offset"_a, "count"_a, "indexed"_a = false)
+        .def("draw_array_instanced", &Shader::draw_array_instanced,
+             D(Shader, draw_array_instanced), "primitive_type"_a, "offset"_a, "count"_a,
+             "instances"_a, "indexed"_a = false)
 #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+        .def("set_stream_buffer", &shader_set_stream_buffer<std::string>,
+             D(Shader, set_stream_buffer), "name"_a, "buffer"_a, "offset"_a, "array"_a)
+        .def("set_stream_buffer", &shader_set_stream_buffer<Shader::Parameter>,
+             D(Shader, set_stream_buffer, 2), "parameter"_a, "buffer"_a, "offset"_a, "array"_a)
+        .def("set_uniform_block",
+             nb::overload_cast<const std::string &, UniformBlock *>(&Shader::set_uniform_block),
+             D(Shader, set_uniform_block))
+        .def("set_uniform_block",
+             nb::overload_cast<const Shader::Parameter &, UniformBlock *>(&Shader::set_uniform_block),
+             D(Shader, set_uniform_block, 2))
         .def("shader_handle", &Shader::shader_handle)
+        .def("loaded_from_cache", &Shader::loaded_from_cache, D(Shader, loaded_from_cache))
+        .def_static("set_binary_cache_directory", &Shader::set_binary_cache_directory,
+                    D(Shader, set_binary_cache_directory))
+        .def_static("binary_cache_directory", &Shader::binary_cache_directory,
+                    D(Shader, binary_cache_directory))
 #elif defined(NANOGUI_USE_METAL)
         .def("pipeline_state", &Shader::pipeline_state)
 #endif
@@ -265,6 +652,16 @@ void register_render(nb::module_ &m) {
 #endif
         ;
 
+    nb::class_<Shader::Parameter>(shader, "Parameter", D(Shader, Parameter))
+        .def(nb::init<>(), D(Shader, Parameter, Parameter))
+        .def("valid", &Shader::Parameter::valid, D(Shader, Parameter, valid))
+        .def("name", &Shader::Parameter::name, D(Shader, Parameter, name));
+
+    nb::enum_<Shader::BufferUsage>(shader, "BufferUsage", D(Shader, BufferUsage))
+        .value("Static", Shader::BufferUsage::Static, D(Shader, BufferUsage, Static))
+        .value("Dynamic", Shader::BufferUsage::Dynamic, D(Shader, BufferUsage, Dynamic))
+        .value("Stream", Shader::BufferUsage::Stream, D(Shader, BufferUsage, Stream));
+
     nb::enum_<PrimitiveType>(shader, "PrimitiveType", D(Shader, PrimitiveType))
         .value("Point", PrimitiveType::Point, D(Shader, PrimitiveType, Point))
         .value("Line", PrimitiveType::Line, D(Shader, PrimitiveType, Line))
@@ -272,6 +669,100 @@ void register_render(nb::module_ &m) {
         .value("Triangle", PrimitiveType::Triangle, D(Shader, PrimitiveType, Triangle))
         .value("TriangleStrip", PrimitiveType::TriangleStrip, D(Shader, PrimitiveType, TriangleStrip));
 
+    nb::class_<ShaderLibrary, Object>(m, "ShaderLibrary", D(ShaderLibrary))
+        .def(nb::init<RenderPass *, const std::string &, const std::string &,
+                      const std::string &, const std::vector<std::string> &,
+                      Shader::BlendMode, bool>(),
+             D(ShaderLibrary, ShaderLibrary), "render_pass"_a, "name"_a,
+             "vertex_shader"_a, "fragment_shader"_a, "features"_a,
+             "blend_mode"_a = BlendMode::None, "asynchronous"_a = false)
+        .def("name", &ShaderLibrary::name, D(ShaderLibrary, name))
+        .def("features", &ShaderLibrary::features, D(ShaderLibrary, features))
+        .def("feature", &ShaderLibrary::feature, D(ShaderLibrary, feature))
+        .def("shader", &ShaderLibrary::shader, D(ShaderLibrary, shader),
+             "features"_a = 0)
+        .def("has_shader", &ShaderLibrary::has_shader, D(ShaderLibrary, has_shader))
+        .def("shader_count", &ShaderLibrary::shader_count, D(ShaderLibrary, shader_count))
+        .def("clear", &ShaderLibrary::clear, D(ShaderLibrary, clear))
+        .def("specialize", &ShaderLibrary::specialize, D(ShaderLibrary, specialize));
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    nb::class_<StreamBuffer, Object>(m, "StreamBuffer", D(StreamBuffer))
+        .def(nb::init<size_t>(), D(StreamBuffer, StreamBuffer),
+             "frame_size"_a = 4 * 1024 * 1024)
+        .def("frame_size", &StreamBuffer::frame_size, D(StreamBuffer, frame_size))
+        .def("used", &StreamBuffer::used, D(StreamBuffer, used))
+        .def("persistent", &StreamBuffer::persistent, D(StreamBuffer, persistent))
+        .def("buffer_handle", &StreamBuffer::buffer_handle, D(StreamBuffer, buffer_handle))
+        .def("write", &stream_buffer_write, D(StreamBuffer, write),
+             "array"_a, "alignment"_a = 16)
+        .def("next_frame", &StreamBuffer::next_frame, D(StreamBuffer, next_frame));
+
+    nb::class_<UniformBlock, Object>(m, "UniformBlock", D(UniformBlock))
+        .def(nb::init<Shader *, const std::string &>(), D(UniformBlock, UniformBlock),
+             "shader"_a, "name"_a)
+        .def("name", &UniformBlock::name, D(UniformBlock, name))
+        .def("size", &UniformBlock::size, D(UniformBlock, size))
+        .def("binding", &UniformBlock::binding, D(UniformBlock, binding))
+        .def("buffer_handle", &UniformBlock::buffer_handle, D(UniformBlock, buffer_handle))
+        .def("has_member", &UniformBlock::has_member, D(UniformBlock, has_member))
+        .def("set_member", &uniform_block_set_member, D(UniformBlock, set_member))
+        .def("upload", &UniformBlock::upload, D(UniformBlock, upload))
+        .def("bind", &UniformBlock::bind, D(UniformBlock, bind));
+
+    auto gl_state = nb::class_<GLState>(m, "GLState", D(GLState))
+        .def_static("current", &GLState::current, nb::rv_policy::reference,
+                    D(GLState, current))
+        .def("invalidate", &GLState::invalidate, D(GLState, invalidate),
+             "categories"_a = (uint32_t) GLState::All)
+        .def("stats", &GLState::stats, D(GLState, stats))
+        .def("last_frame_stats", &GLState::last_frame_stats, D(GLState, last_frame_stats));
+
+    nb::enum_<GLState::Category>(gl_state, "Category", D(GLState, Category), nb::is_arithmetic())
+        .value("Program", GLState::Program)
+        .value("VertexArray", GLState::VertexArray)
+        .value("Textures", GLState::Textures)
+        .value("Framebuffer", GLState::Framebuffer)
+        .value("Capabilities", GLState::Capabilities)
+        .value("Blend", GLState::Blend)
+        .value("Depth", GLState::Depth)
+        .value("Cull", GLState::Cull)
+        .value("Viewport", GLState::Viewport)
+        .value("Scissor", GLState::Scissor)
+        .value("All", GLState::All)
+        .value("NanoVG", GLState::NanoVG, D(GLState, Category, NanoVG));
+
+    nb::class_<GLState::Stats>(gl_state, "Stats", D(GLState, Stats))
+        .def_ro("issued", &GLState::Stats::issued, D(GLState, Stats, issued))
+        .def_ro("elided", &GLState::Stats::elided, D(GLState, Stats, elided));
+#endif
+
+    auto gpu_timer = nb::class_<GPUTimer, Object>(m, "GPUTimer", D(GPUTimer))
+        .def(nb::init<const std::string &, size_t>(), D(GPUTimer, GPUTimer),
+             "name"_a = "", "window"_a = 60)
+        .def("name", &GPUTimer::name, D(GPUTimer, name))
+        .def("set_name", &GPUTimer::set_name, D(GPUTimer, set_name))
+        .def("window", &GPUTimer::window, D(GPUTimer, window))
+        .def("stats", &GPUTimer::stats, D(GPUTimer, stats))
+        .def("reset", &GPUTimer::reset, D(GPUTimer, reset))
+        .def("add_sample", &GPUTimer::add_sample, D(GPUTimer, add_sample))
+        .def_static("supported", &GPUTimer::supported, D(GPUTimer, supported))
+        .def_static("poll_all", &GPUTimer::poll_all, D(GPUTimer, poll_all))
+        .def_static("timers", &GPUTimer::timers, D(GPUTimer, timers),
+                    nb::rv_policy::reference)
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+        .def("begin", &GPUTimer::begin, D(GPUTimer, begin))
+        .def("end", &GPUTimer::end, D(GPUTimer, end))
+#endif
+        ;
+
+    nb::class_<GPUTimer::Stats>(gpu_timer, "Stats", D(GPUTimer, Stats))
+        .def_ro("last", &GPUTimer::Stats::last, D(GPUTimer, Stats, last))
+        .def_ro("average", &GPUTimer::Stats::average, D(GPUTimer, Stats, average))
+        .def_ro("minimum", &GPUTimer::Stats::minimum, D(GPUTimer, Stats, minimum))
+        .def_ro("maximum", &GPUTimer::Stats::maximum, D(GPUTimer, Stats, maximum))
+        .def_ro("samples", &GPUTimer::Stats::samples, D(GPUTimer, Stats, samples));
+
     auto renderpass = nb::class_<RenderPass, Object>(m, "RenderPass", D(RenderPass))
         .def(nb::init<std::vector<Object *>, Object *, Object *, Object *, bool>(),
              D(RenderPass, RenderPass), "color_targets"_a, "depth_target"_a = nullptr,
@@ -282,14 +773,25 @@ void register_render(nb::module_ &m) {
         .def("clear_depth", &RenderPass::clear_depth, D(RenderPass, clear_depth))
         .def("set_clear_stencil", &RenderPass::set_clear_stencil, D(RenderPass, set_clear_stencil))
         .def("clear_stencil", &RenderPass::clear_stencil, D(RenderPass, clear_stencil))
+        .def("set_load_action", &RenderPass::set_load_action, D(RenderPass, set_load_action),
+             "index"_a, "action"_a)
+        .def("load_action", &RenderPass::load_action, D(RenderPass, load_action))
+        .def("set_store_action", &RenderPass::set_store_action, D(RenderPass, set_store_action),
+             "index"_a, "action"_a)
+        .def("store_action", &RenderPass::store_action, D(RenderPass, store_action))
         .def("set_viewport", &RenderPass::set_viewport, D(RenderPass, set_viewport), "offset"_a, "size"_a)
         .def("viewport", &RenderPass::viewport, D(RenderPass, viewport))
         .def("set_depth_test", &RenderPass::set_depth_test, D(RenderPass, set_depth_test), "depth_test"_a, "depth_write"_a)
         .def("depth_test", &RenderPass::depth_test, D(RenderPass, depth_test))
         .def("set_cull_mode", &RenderPass::set_cull_mode, D(RenderPass, set_cull_mode))
         .def("cull_mode", &RenderPass::cull_mode, D(RenderPass, cull_mode))
+        .def("set_gpu_timer", &RenderPass::set_gpu_timer, D(RenderPass, set_gpu_timer))
+        .def("gpu_timer", &RenderPass::gpu_timer, D(RenderPass, gpu_timer))
+        .def("set_blit_target", &RenderPass::set_blit_target, D(RenderPass, set_blit_target))
+        .def("blit_target", &RenderPass::blit_target, D(RenderPass, blit_target))
         .def("begin", &RenderPass::begin, D(RenderPass, begin))
         .def("end", &RenderPass::end, D(RenderPass, end))
+        .def("active", &RenderPass::active, D(RenderPass, active))
         .def("resize", &RenderPass::resize, D(RenderPass, resize))
         .def("blit_to", &RenderPass::blit_to, D(RenderPass, blit_to),
              "src_offset"_a, "src_size"_a, "dst"_a, "dst_offset"_a)
@@ -317,4 +819,28 @@ void register_render(nb::module_ &m) {
         .value("NotEqual", DepthTest::NotEqual, D(RenderPass, DepthTest, NotEqual))
         .value("GreaterEqual", DepthTest::GreaterEqual, D(RenderPass, DepthTest, GreaterEqual))
         .value("Always", DepthTest::Always, D(RenderPass, DepthTest, Always));
+
+    nb::enum_<RenderPass::LoadAction>(renderpass, "LoadAction", D(RenderPass, LoadAction))
+        .value("Clear", RenderPass::LoadAction::Clear, D(RenderPass, LoadAction, Clear))
+        .value("Load", RenderPass::LoadAction::Load, D(RenderPass, LoadAction, Load))
+        .value("DontCare", RenderPass::LoadAction::DontCare, D(RenderPass, LoadAction, DontCare));
+
+    nb::enum_<RenderPass::StoreAction>(renderpass, "StoreAction", D(RenderPass, StoreAction))
+        .value("Store", RenderPass::StoreAction::Store, D(RenderPass, StoreAction, Store))
+        .value("Discard", RenderPass::StoreAction::Discard, D(RenderPass, StoreAction, Discard));
+
+    auto render_graph = nb::class_<RenderGraph, Object>(m, "RenderGraph", D(RenderGraph))
+        .def(nb::init<>(), D(RenderGraph, RenderGraph))
+        .def("add_pass", &RenderGraph::add_pass, D(RenderGraph, add_pass),
+             "pass"_a, "callback"_a)
+        .def("add_dependency", &RenderGraph::add_dependency, D(RenderGraph, add_dependency),
+             "pass"_a, "dependency"_a)
+        .def("size", &RenderGraph::size, D(RenderGraph, size))
+        .def("execute", &RenderGraph::execute, D(RenderGraph, execute))
+        .def("clear", &RenderGraph::clear, D(RenderGraph, clear))
+        .def("last_stats", &RenderGraph::last_stats, D(RenderGraph, last_stats));
+
+    nb::class_<RenderGraph::Stats>(render_graph, "Stats", D(RenderGraph, Stats))
+        .def_ro("passes", &RenderGraph::Stats::passes, D(RenderGraph, Stats, passes))
+        .def_ro("merged", &RenderGraph::Stats::merged, D(RenderGraph, Stats, merged));
 }
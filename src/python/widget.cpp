@@ -233,6 +233,10 @@ void register_widget(nb::module_ &m) {
         .def("pixel_format", &Screen::pixel_format, D(Screen, pixel_format))
         .def("component_format", &Screen::component_format, D(Screen, component_format))
         .def("nvg_flush", &Screen::nvg_flush, D(Screen, nvg_flush))
+        .def("set_gpu_timer_overlay", &Screen::set_gpu_timer_overlay,
+             D(Screen, set_gpu_timer_overlay))
+        .def("gpu_timer_overlay", &Screen::gpu_timer_overlay, D(Screen, gpu_timer_overlay))
+        .def("render_graph", &Screen::render_graph, D(Screen, render_graph))
 #if defined(NANOGUI_USE_METAL)
         .def("metal_layer", &Screen::metal_layer)
         .def("metal_texture", &Screen::metal_texture)
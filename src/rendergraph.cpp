@@ -0,0 +1,83 @@
+#include <nanogui/rendergraph.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+size_t RenderGraph::node(RenderPass *pass) {
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        if (m_nodes[i].pass.get() == pass)
+            return i;
+    }
+    m_nodes.push_back(Node{ pass, { }, { } });
+    return m_nodes.size() - 1;
+}
+
+void RenderGraph::add_pass(RenderPass *pass, const std::function<void()> &callback) {
+    if (!pass)
+        throw std::runtime_error("RenderGraph::add_pass(): the render pass must be specified!");
+
+    Node &n = m_nodes[node(pass)];
+    if (!n.callbacks.empty())
+        m_merged++;
+    n.callbacks.push_back(callback);
+}
+
+void RenderGraph::add_dependency(RenderPass *pass, RenderPass *dependency) {
+    if (!pass || !dependency || pass == dependency)
+        throw std::runtime_error("RenderGraph::add_dependency(): invalid arguments!");
+    m_nodes[node(pass)].dependencies.push_back(dependency);
+}
+
+void RenderGraph::execute() {
+    // Clear the graph up front, so that an exception leaves it empty
+    std::vector<Node> nodes;
+    nodes.swap(m_nodes);
+    Stats stats;
+    stats.merged = m_merged;
+    m_merged = 0;
+
+    std::vector<bool> done(nodes.size(), false);
+    size_t remaining = nodes.size();
+
+    while (remaining > 0) {
+        /* Run the earliest added pass whose dependencies have run. Graphs
+           are small (one node per visible canvas), hence the quadratic
+           search is not a concern */
+        size_t next = nodes.size();
+        for (size_t i = 0; i < nodes.size() && next == nodes.size(); ++i) {
+            if (done[i])
+                continue;
+            bool ready = true;
+            for (RenderPass *dependency : nodes[i].dependencies) {
+                for (size_t j = 0; j < nodes.size(); ++j) {
+                    if (nodes[j].pass.get() == dependency && !done[j])
+                        ready = false;
+                }
+            }
+            if (ready)
+                next = i;
+        }
+
+        if (next == nodes.size())
+            throw std::runtime_error("RenderGraph::execute(): the dependencies contain a cycle!");
+
+        Node &n = nodes[next];
+        if (!n.callbacks.empty()) {
+            n.pass->begin();
+            for (const auto &callback : n.callbacks)
+                callback();
+            n.pass->end();
+            stats.passes++;
+        }
+        done[next] = true;
+        remaining--;
+    }
+
+    m_last_stats = stats;
+}
+
+void RenderGraph::clear() {
+    m_nodes.clear();
+    m_merged = 0;
+}
+
+NAMESPACE_END(nanogui)
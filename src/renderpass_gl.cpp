@@ -2,16 +2,64 @@
 #include <nanogui/screen.h>
 #include <nanogui/opengl.h>
 #include <nanogui/texture.h>
+#include <nanogui/glstate.h>
 #include "opengl_check.h"
+#include "opengl_ext.h"
 
 NAMESPACE_BEGIN(nanogui)
 
+#if (defined(NANOGUI_USE_OPENGL) && (defined(NANOGUI_GLAD) || defined(GL_VERSION_4_3))) || \
+    (defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 3)
+#  define NANOGUI_INVALIDATE_FRAMEBUFFER
+
+/// Is glInvalidateFramebuffer() (OpenGL 4.3 and GLES 3) available?
+static bool has_invalidate_framebuffer() {
+#if defined(NANOGUI_USE_GLES)
+    return true;
+#elif defined(NANOGUI_GLAD)
+    return glInvalidateFramebuffer != nullptr;
+#else
+    static int supported = -1;
+    if (supported < 0) {
+        GLint major = 0, minor = 0;
+        CHK(glGetIntegerv(GL_MAJOR_VERSION, &major));
+        CHK(glGetIntegerv(GL_MINOR_VERSION, &minor));
+        supported = major > 4 || (major == 4 && minor >= 3);
+    }
+    return supported != 0;
+#endif
+}
+#endif
+
+/// Attach a texture or render buffer to the currently bound framebuffer
+static void attach_texture(GLenum attachment_id, Texture *texture) {
+    if (texture->flags() & Texture::TextureFlags::ShaderRead) {
+#if defined(NANOGUI_USE_GLES)
+        /* The samples of the attachment are resolved into the texture when
+           the tile memory is written back */
+        if (texture->flags() & Texture::TextureFlags::ImplicitResolve) {
+            CHK(gl_multisampled_render_to_texture()->framebuffer_texture_2d_multisample(
+                GL_FRAMEBUFFER, attachment_id, GL_TEXTURE_2D,
+                texture->texture_handle(), 0, texture->samples()));
+            return;
+        }
+#endif
+        CHK(glFramebufferTexture2D(GL_FRAMEBUFFER, attachment_id, GL_TEXTURE_2D,
+                                   texture->texture_handle(), 0));
+    } else {
+        CHK(glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment_id, GL_RENDERBUFFER,
+                                      texture->renderbuffer_handle()));
+    }
+}
+
 RenderPass::RenderPass(const std::vector<Object *> &color_targets,
                        Object *depth_target, Object *stencil_target,
                        Object *blit_target, bool clear)
     : m_targets(color_targets.size() + 2),
       m_targets_ref(color_targets.size() + 2),
-      m_clear_color(color_targets.size()), m_clear(clear), m_clear_stencil(0),
+      m_clear_color(color_targets.size()),
+      m_load_action(color_targets.size() + 2, clear ? LoadAction::Clear : LoadAction::Load),
+      m_store_action(color_targets.size() + 2, StoreAction::Store), m_clear_stencil(0),
       m_clear_depth(1.f), m_viewport_offset(0), m_viewport_size(0),
       m_framebuffer_size(0), m_depth_test(DepthTest::Less), m_depth_write(true),
       m_cull_mode(CullMode::Back), m_blit_target(blit_target), m_active(false),
@@ -39,8 +87,9 @@ RenderPass::RenderPass(const std::vector<Object *> &color_targets,
         m_depth_test = DepthTest::Always;
     }
 
+    GLState &state = GLState::current();
     CHK(glGenFramebuffers(1, &m_framebuffer_handle));
-    CHK(glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer_handle));
+    state.bind_framebuffer(m_framebuffer_handle);
 
 #if defined(NANOGUI_USE_OPENGL)
     std::vector<GLenum> draw_buffers;
@@ -68,13 +117,7 @@ RenderPass::RenderPass(const std::vector<Object *> &color_targets,
 #endif
             has_screen = true;
         } else if (texture) {
-            if (texture->flags() & Texture::TextureFlags::ShaderRead) {
-                CHK(glFramebufferTexture2D(GL_FRAMEBUFFER, attachment_id, GL_TEXTURE_2D,
-                                           texture->texture_handle(), 0));
-            } else {
-                CHK(glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment_id, GL_RENDERBUFFER,
-                                              texture->renderbuffer_handle()));
-            }
+            attach_texture(attachment_id, texture);
 #if defined(NANOGUI_USE_OPENGL)
             if (i >= 2)
                 draw_buffers.push_back(attachment_id);
@@ -86,6 +129,7 @@ RenderPass::RenderPass(const std::vector<Object *> &color_targets,
     m_viewport_size = m_framebuffer_size;
 
     if (has_screen && !has_texture) {
+        state.framebuffer_deleted(m_framebuffer_handle);
         CHK(glDeleteFramebuffers(1, &m_framebuffer_handle));
         m_framebuffer_handle = 0;
     } else {
@@ -141,7 +185,7 @@ RenderPass::RenderPass(const std::vector<Object *> &color_targets,
         }
     }
 
-    CHK(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+    state.bind_framebuffer(0);
 }
 
 RenderPass::~RenderPass() {
@@ -150,7 +194,10 @@ RenderPass::~RenderPass() {
             m_targets[i]->dec_ref();
     }
 
-    CHK(glDeleteFramebuffers(1, &m_framebuffer_handle));
+    if (m_framebuffer_handle) {
+        GLState::current().framebuffer_deleted(m_framebuffer_handle);
+        CHK(glDeleteFramebuffers(1, &m_framebuffer_handle));
+    }
 }
 
 void RenderPass::begin() {
@@ -160,58 +207,65 @@ void RenderPass::begin() {
 #endif
     m_active = true;
 
-    CHK(glGetIntegerv(GL_VIEWPORT, m_viewport_backup));
-    CHK(glGetIntegerv(GL_SCISSOR_BOX, m_scissor_backup));
-    GLboolean depth_write;
-    CHK(glGetBooleanv(GL_DEPTH_WRITEMASK, &depth_write));
-    m_depth_write_backup = depth_write;
+    /* The tracker knows the state that was set up before the pass, hence
+       there is no need to query it. Unknown entries are reset to defaults
+       by end(), except for the rectangles, which have none */
+    GLState &state = GLState::current();
+    state.query_rects();
+    m_state_backup = state.state();
 
-    m_depth_test_backup = glIsEnabled(GL_DEPTH_TEST);
-    m_scissor_test_backup = glIsEnabled(GL_SCISSOR_TEST);
-    m_cull_face_backup = glIsEnabled(GL_CULL_FACE);
-    m_blend_backup = glIsEnabled(GL_BLEND);
+    if (m_gpu_timer)
+        m_gpu_timer->begin();
 
-    CHK(glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer_handle));
+    state.bind_framebuffer(m_framebuffer_handle);
     set_viewport(m_viewport_offset, m_viewport_size);
+    invalidate_attachments(true);
 
-    if (m_clear) {
-#if defined(NANOGUI_USE_OPENGL)
-        for (size_t i = 0; i < m_targets.size(); ++i) {
-            if (i == 0 && m_targets[0]) {
-                if (m_targets[0] == m_targets[1])
-                    CHK(glClearBufferfi(GL_DEPTH_STENCIL, 0, m_clear_depth, m_clear_stencil));
-                else {
-                    CHK(glClearBufferfv(GL_DEPTH, 0, &m_clear_depth));
-                }
-            }
+    bool clear_depth   = m_targets[0] && m_load_action[0] == LoadAction::Clear,
+         clear_stencil = m_targets[1] && m_load_action[1] == LoadAction::Clear;
 
-            if (i >= 2)
-                CHK(glClearBufferfv(GL_COLOR, (GLint) i - 2, m_clear_color[i - 2].v));
+    // Clearing respects the depth write mask, which a previous pass may have disabled
+    if (clear_depth)
+        state.depth_mask(true);
+
+#if defined(NANOGUI_USE_OPENGL)
+    if (clear_depth && clear_stencil && m_targets[0] == m_targets[1]) {
+        CHK(glClearBufferfi(GL_DEPTH_STENCIL, 0, m_clear_depth, m_clear_stencil));
+    } else {
+        if (clear_depth)
+            CHK(glClearBufferfv(GL_DEPTH, 0, &m_clear_depth));
+        if (clear_stencil) {
+            GLint stencil = m_clear_stencil;
+            CHK(glClearBufferiv(GL_STENCIL, 0, &stencil));
         }
+    }
+
+    for (size_t i = 2; i < m_targets.size(); ++i) {
+        if (m_targets[i] && m_load_action[i] == LoadAction::Clear)
+            CHK(glClearBufferfv(GL_COLOR, (GLint) i - 2, m_clear_color[i - 2].v));
+    }
 #else
-        GLenum what = 0;
-        if (m_targets[0]) {
-            CHK(glClearDepthf(m_clear_depth));
-            what |= GL_DEPTH_BUFFER_BIT;
-        }
-        if (m_targets[1]) {
-            CHK(glClearStencil(m_clear_stencil));
-            what |= GL_STENCIL_BUFFER_BIT;
-        }
-        if (m_targets[2]) {
-            CHK(glClearColor(m_clear_color[0].r(), m_clear_color[0].g(),
-                             m_clear_color[0].b(), m_clear_color[0].w()));
-            what |= GL_COLOR_BUFFER_BIT;
-        }
+    GLenum what = 0;
+    if (clear_depth) {
+        CHK(glClearDepthf(m_clear_depth));
+        what |= GL_DEPTH_BUFFER_BIT;
+    }
+    if (clear_stencil) {
+        CHK(glClearStencil(m_clear_stencil));
+        what |= GL_STENCIL_BUFFER_BIT;
+    }
+    if (m_targets[2] && m_load_action[2] == LoadAction::Clear) {
+        CHK(glClearColor(m_clear_color[0].r(), m_clear_color[0].g(),
+                         m_clear_color[0].b(), m_clear_color[0].w()));
+        what |= GL_COLOR_BUFFER_BIT;
+    }
+    if (what)
         CHK(glClear(what));
 #endif
-    }
 
     set_depth_test(m_depth_test, m_depth_write);
     set_cull_mode(m_cull_mode);
-
-    if (m_blend_backup)
-        CHK(glDisable(GL_BLEND));
+    state.set_enabled(GLState::Capability::Blend, false);
 }
 
 void RenderPass::end() {
@@ -220,45 +274,98 @@ void RenderPass::end() {
         throw std::runtime_error("RenderPass::end(): render pass is not active!");
 #endif
 
-    CHK(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+    GLState &state = GLState::current();
     if (m_blit_target)
         blit_to(Vector2i(0, 0), m_framebuffer_size, m_blit_target, Vector2i(0, 0));
+    invalidate_attachments(false);
+    if (m_gpu_timer)
+        m_gpu_timer->end();
+    state.bind_framebuffer(0);
+
+    /* Shaders leave their program and vertex array bound so that repeated
+       draws using the same shader skip these bindings. Release them here,
+       since later code may bind an index buffer (which would modify the
+       vertex array) */
+    state.use_program(0);
+    state.bind_vertex_array(0);
+    state.restore(m_state_backup);
 
-    CHK(glViewport(m_viewport_backup[0], m_viewport_backup[1],
-                   m_viewport_backup[2], m_viewport_backup[3]));
-    CHK(glScissor(m_scissor_backup[0], m_scissor_backup[1],
-                  m_scissor_backup[2], m_scissor_backup[3]));
+    m_active = false;
+}
 
-    if (m_depth_test_backup)
-        CHK(glEnable(GL_DEPTH_TEST));
-    else
-        CHK(glDisable(GL_DEPTH_TEST));
+void RenderPass::invalidate_attachments(bool begin) {
+#if defined(NANOGUI_INVALIDATE_FRAMEBUFFER)
+    if (!has_invalidate_framebuffer())
+        return;
 
-    CHK(glDepthMask(m_depth_write_backup));
+    GLenum attachments[32];
+    GLsizei count = 0;
 
-    if (m_scissor_test_backup)
-        CHK(glEnable(GL_SCISSOR_TEST));
-    else
-        CHK(glDisable(GL_SCISSOR_TEST));
+    for (size_t i = 0; i < m_targets.size() && count < 32; ++i) {
+        bool invalidate = begin ? m_load_action[i] == LoadAction::DontCare
+                                : m_store_action[i] == StoreAction::Discard;
+        if (!m_targets[i] || !invalidate)
+            continue;
 
-    if (m_cull_face_backup)
-        CHK(glEnable(GL_CULL_FACE));
-    else
-        CHK(glDisable(GL_CULL_FACE));
+        // The default framebuffer uses different attachment names
+        bool is_screen = dynamic_cast<Screen *>(m_targets[i]) != nullptr;
+        if (is_screen != (m_framebuffer_handle == 0))
+            continue;
 
-    if (m_blend_backup)
-        CHK(glEnable(GL_BLEND));
-    else
-        CHK(glDisable(GL_BLEND));
+        if (i == 0)
+            attachments[count++] = is_screen ? GL_DEPTH : GL_DEPTH_ATTACHMENT;
+        else if (i == 1)
+            attachments[count++] = is_screen ? GL_STENCIL : GL_STENCIL_ATTACHMENT;
+        else
+            attachments[count++] = is_screen ? GL_COLOR : (GLenum) (GL_COLOR_ATTACHMENT0 + i - 2);
+    }
 
-    m_active = false;
+    if (count == 0)
+        return;
+
+    GLState::current().bind_framebuffer(m_framebuffer_handle);
+    if (m_viewport_offset == Vector2i(0, 0) && m_viewport_size == m_framebuffer_size) {
+        CHK(glInvalidateFramebuffer(GL_FRAMEBUFFER, count, attachments));
+    } else {
+        // Only the viewport region belongs to this render pass
+        int ypos = m_framebuffer_size.y() - m_viewport_size.y() - m_viewport_offset.y();
+        CHK(glInvalidateSubFramebuffer(GL_FRAMEBUFFER, count, attachments,
+                                       m_viewport_offset.x(), ypos,
+                                       m_viewport_size.x(), m_viewport_size.y()));
+    }
+#else
+    // Attachments keep their contents, which is always a valid implementation
+    (void) begin;
+#endif
 }
 
 void RenderPass::resize(const Vector2i &size) {
     for (size_t i = 0; i < m_targets.size(); ++i) {
         Texture *texture = dynamic_cast<Texture *>(m_targets[i]);
-        if (texture)
-            texture->resize(size);
+        if (!texture)
+            continue;
+
+        uint32_t texture_handle = texture->texture_handle(),
+                 renderbuffer_handle = texture->renderbuffer_handle();
+        texture->resize(size);
+
+        /* Resizing a render target may swap it for differently sized
+           storage taken from the texture pool */
+        if (texture_handle != texture->texture_handle() ||
+            renderbuffer_handle != texture->renderbuffer_handle()) {
+            GLenum attachment_id;
+            if (i == 0)
+                attachment_id = GL_DEPTH_ATTACHMENT;
+            else if (i == 1)
+                attachment_id = GL_STENCIL_ATTACHMENT;
+            else
+                attachment_id = (GLenum) (GL_COLOR_ATTACHMENT0 + i - 2);
+
+            GLState &state = GLState::current();
+            state.bind_framebuffer(m_framebuffer_handle);
+            attach_texture(attachment_id, texture);
+            state.bind_framebuffer(0);
+        }
     }
     m_framebuffer_size = size;
     m_viewport_offset = Vector2i(0, 0);
@@ -282,17 +389,15 @@ void RenderPass::set_viewport(const Vector2i &offset, const Vector2i &size) {
     m_viewport_size = size;
 
     if (m_active) {
+        GLState &state = GLState::current();
         int ypos = m_framebuffer_size.y() - m_viewport_size.y() - m_viewport_offset.y();
-        CHK(glViewport(m_viewport_offset.x(), ypos,
-                       m_viewport_size.x(), m_viewport_size.y()));
-        CHK(glScissor(m_viewport_offset.x(), ypos,
-                      m_viewport_size.x(), m_viewport_size.y()));
-
-        if (m_viewport_offset == Vector2i(0, 0) &&
-            m_viewport_size == m_framebuffer_size)
-            CHK(glDisable(GL_SCISSOR_TEST));
-        else
-            CHK(glEnable(GL_SCISSOR_TEST));
+        state.viewport(m_viewport_offset.x(), ypos,
+                       m_viewport_size.x(), m_viewport_size.y());
+        state.scissor(m_viewport_offset.x(), ypos,
+                      m_viewport_size.x(), m_viewport_size.y());
+        state.set_enabled(GLState::Capability::ScissorTest,
+                          m_viewport_offset != Vector2i(0, 0) ||
+                          m_viewport_size != m_framebuffer_size);
     }
 }
 
@@ -301,6 +406,7 @@ void RenderPass::set_depth_test(DepthTest depth_test, bool depth_write) {
     m_depth_write = depth_write;
 
     if (m_active) {
+        GLState &state = GLState::current();
         if (m_targets[0] && depth_test != DepthTest::Always) {
             GLenum func;
             switch (depth_test) {
@@ -314,12 +420,12 @@ void RenderPass::set_depth_test(DepthTest depth_test, bool depth_write) {
                 default:
                     throw std::runtime_error("Shader::set_depth_test(): invalid depth test mode!");
             }
-            CHK(glEnable(GL_DEPTH_TEST));
-            CHK(glDepthFunc(func));
+            state.set_enabled(GLState::Capability::DepthTest, true);
+            state.depth_func(func);
         } else {
-            CHK(glDisable(GL_DEPTH_TEST));
+            state.set_enabled(GLState::Capability::DepthTest, false);
         }
-        CHK(glDepthMask(depth_write ? GL_TRUE : GL_FALSE));
+        state.depth_mask(depth_write);
     }
 }
 
@@ -327,14 +433,15 @@ void RenderPass::set_cull_mode(CullMode cull_mode) {
     m_cull_mode = cull_mode;
 
     if (m_active) {
+        GLState &state = GLState::current();
         if (cull_mode == CullMode::Disabled) {
-            CHK(glDisable(GL_CULL_FACE));
+            state.set_enabled(GLState::Capability::CullFace, false);
         } else {
-            CHK(glEnable(GL_CULL_FACE));
+            state.set_enabled(GLState::Capability::CullFace, true);
             if (cull_mode == CullMode::Front)
-                CHK(glCullFace(GL_FRONT));
+                state.cull_face(GL_FRONT);
             else if (cull_mode == CullMode::Back)
-                CHK(glCullFace(GL_BACK));
+                state.cull_face(GL_BACK);
             else
                 throw std::runtime_error("Shader::set_cull_mode(): invalid cull mode!");
         }
@@ -378,6 +485,16 @@ void RenderPass::blit_to(const Vector2i &src_offset,
         what = GL_COLOR_BUFFER_BIT;
     #endif
 
+    // Discarded attachments have undefined contents
+    if (m_store_action[0] == StoreAction::Discard)
+        what &= ~GL_DEPTH_BUFFER_BIT;
+    if (m_store_action[1] == StoreAction::Discard)
+        what &= ~GL_STENCIL_BUFFER_BIT;
+    if (m_store_action.size() > 2 && m_store_action[2] == StoreAction::Discard)
+        what &= ~GL_COLOR_BUFFER_BIT;
+    if (what == 0)
+        return;
+
     CHK(glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer_handle));
     CHK(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target_id));
 
@@ -399,7 +516,10 @@ void RenderPass::blit_to(const Vector2i &src_offset,
                           (GLsizei) dst_end.x(), (GLsizei) dst_end.y(),
                           what, GL_NEAREST));
 
-    CHK(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+    // The read and draw bindings differ at this point
+    GLState &state = GLState::current();
+    state.invalidate(GLState::Framebuffer);
+    state.bind_framebuffer(0);
 #endif
 }
 
@@ -14,7 +14,9 @@ RenderPass::RenderPass(const std::vector<Object *> &color_targets,
                        Object *blit_target,
                        bool clear)
     : m_targets(color_targets.size() + 2), m_targets_ref(color_targets.size() + 2),
-      m_clear_color(color_targets.size()), m_clear(clear), m_clear_stencil(0),
+      m_clear_color(color_targets.size()),
+      m_load_action(color_targets.size() + 2, clear ? LoadAction::Clear : LoadAction::Load),
+      m_store_action(color_targets.size() + 2, StoreAction::Store), m_clear_stencil(0),
       m_clear_depth(1.f), m_viewport_offset(0), m_viewport_size(0),
       m_framebuffer_size(0), m_depth_test(DepthTest::Less),
       m_depth_write(true), m_cull_mode(CullMode::Back),
@@ -93,8 +95,11 @@ void RenderPass::begin() {
     MTLRenderPassDescriptor *pass_descriptor =
         (__bridge MTLRenderPassDescriptor *) m_pass_descriptor;
 
-    bool clear_manual = m_clear && (m_viewport_offset != Vector2i(0, 0) ||
-                                    m_viewport_size != m_framebuffer_size);
+    bool partial = m_viewport_offset != Vector2i(0, 0) ||
+                   m_viewport_size != m_framebuffer_size;
+    bool clear_manual = false;
+    for (size_t i = 0; i < m_targets.size(); ++i)
+        clear_manual |= partial && m_targets[i] && m_load_action[i] == LoadAction::Clear;
 
     for (size_t i = 0; i < m_targets.size(); ++i) {
         Texture *texture = dynamic_cast<Texture *>(m_targets[i]);
@@ -126,8 +131,14 @@ void RenderPass::begin() {
 
         att.texture = texture_handle;
 
-        att.loadAction = m_clear && ! clear_manual ?
-            MTLLoadActionClear : MTLLoadActionLoad;
+        /* Load actions affect the whole attachment, hence a partial
+           viewport clears using a shader and preserves the rest */
+        if (m_load_action[i] == LoadAction::Clear && !clear_manual)
+            att.loadAction = MTLLoadActionClear;
+        else if (m_load_action[i] == LoadAction::DontCare && !partial)
+            att.loadAction = MTLLoadActionDontCare;
+        else
+            att.loadAction = MTLLoadActionLoad;
 
         RenderPass *blit_rp = dynamic_cast<RenderPass *>(m_blit_target.get());
         if (blit_rp && i < blit_rp->targets().size()) {
@@ -147,7 +158,8 @@ void RenderPass::begin() {
             att.storeAction = MTLStoreActionMultisampleResolve;
             att.resolveTexture = resolve_texture_handle;
         } else {
-            att.storeAction = MTLStoreActionStore;
+            att.storeAction = m_store_action[i] == StoreAction::Discard && !partial ?
+                MTLStoreActionDontCare : MTLStoreActionStore;
         }
     }
 
@@ -248,6 +260,20 @@ void RenderPass::end() {
     id<MTLRenderCommandEncoder> command_encoder =
         (__bridge_transfer id<MTLRenderCommandEncoder>) m_command_encoder;
     [command_encoder endEncoding];
+
+    if (m_gpu_timer) {
+        if (@available(macOS 10.15, *)) {
+            // Keep the timer alive until the command buffer has completed
+            GPUTimer *timer = m_gpu_timer.get();
+            timer->inc_ref();
+            [command_buffer addCompletedHandler: ^(id<MTLCommandBuffer> buffer) {
+                timer->add_sample(
+                    (float) ((buffer.GPUEndTime - buffer.GPUStartTime) * 1000.0));
+                timer->dec_ref();
+            }];
+        }
+    }
+
     [command_buffer commit];
     m_command_encoder = nullptr;
     m_command_buffer = nullptr;
@@ -16,6 +16,11 @@
 #include <nanogui/opengl.h>
 #include <nanogui/window.h>
 #include <nanogui/popup.h>
+#include <nanogui/texturecache.h>
+#include <nanogui/glstate.h>
+#include <nanogui/gputimer.h>
+#include <nanogui/canvas.h>
+#include <nanogui/rendergraph.h>
 #include <nanogui/metal.h>
 #include <map>
 #include <iostream>
@@ -254,7 +259,7 @@ Screen::Screen(const Vector2i &size, const std::string &caption, bool resizable,
     glfwGetFramebufferSize(m_glfw_window, &m_fbsize[0], &m_fbsize[1]);
 
 #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
-    CHK(glViewport(0, 0, m_fbsize[0], m_fbsize[1]));
+    GLState::current().viewport(0, 0, m_fbsize[0], m_fbsize[1]);
     CHK(glClearColor(m_background[0], m_background[1],
                      m_background[2], m_background[3]));
     CHK(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT |
@@ -489,6 +494,9 @@ void Screen::initialize(GLFWwindow *window, bool shutdown_glfw) {
     /// Fixes retina display-related font rendering issue (#185)
     nvgBeginFrame(m_nvg_context, m_size[0], m_size[1], m_pixel_ratio);
     nvgEndFrame(m_nvg_context);
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    GLState::current().invalidate(GLState::NanoVG);
+#endif
 }
 
 Screen::~Screen() {
@@ -498,6 +506,21 @@ Screen::~Screen() {
             glfwDestroyCursor(m_cursors[i]);
     }
 
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    /* Free cached and idle pooled textures while this screen's context
+       still exists */
+    GLFWwindow *current_context = glfwGetCurrentContext();
+    if (m_glfw_window)
+        glfwMakeContextCurrent(m_glfw_window);
+#endif
+
+    TextureCache::release(m_glfw_window, m_nvg_context);
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    if (m_glfw_window)
+        Texture::clear_pool();
+#endif
+
     if (m_nvg_context) {
 #if defined(NANOGUI_USE_OPENGL)
         nvgDeleteGL3(m_nvg_context);
@@ -508,8 +531,17 @@ Screen::~Screen() {
 #endif
     }
 
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    GLState::release(m_glfw_window);
+#endif
+
     if (m_glfw_window && m_shutdown_glfw)
         glfwDestroyWindow(m_glfw_window);
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    if (m_glfw_window && current_context != m_glfw_window)
+        glfwMakeContextCurrent(current_context);
+#endif
 }
 
 void Screen::set_visible(bool visible) {
@@ -543,6 +575,10 @@ void Screen::set_size(const Vector2i &size) {
 
 void Screen::clear() {
 #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    // glClear() respects the scissor test and the depth write mask
+    GLState &state = GLState::current();
+    state.set_enabled(GLState::Capability::ScissorTest, false);
+    state.depth_mask(true);
     CHK(glClearColor(m_background[0], m_background[1], m_background[2], m_background[3]));
     CHK(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT));
 #elif defined(NANOGUI_USE_METAL)
@@ -582,8 +618,12 @@ void Screen::draw_setup() {
 #endif
 
 #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
-    CHK(glViewport(0, 0, m_fbsize[0], m_fbsize[1]));
+    GLState &state = GLState::current();
+    state.next_frame();
+    state.viewport(0, 0, m_fbsize[0], m_fbsize[1]);
 #endif
+
+    GPUTimer::poll_all();
 }
 
 void Screen::draw_teardown() {
@@ -624,9 +664,31 @@ void Screen::nvg_flush() {
     NVGparams *params = nvgInternalParams(m_nvg_context);
     params->renderFlush(params->userPtr);
     params->renderViewport(params->userPtr, m_size[0], m_size[1], m_pixel_ratio);
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    GLState::current().invalidate(GLState::NanoVG);
+#endif
+}
+
+/// Add the render passes of all visible deferred canvases to a render graph
+static void schedule_canvases(Widget *widget, RenderGraph *graph) {
+    for (Widget *child : widget->children()) {
+        if (!child->visible())
+            continue;
+        Canvas *canvas = dynamic_cast<Canvas *>(child);
+        if (canvas)
+            canvas->schedule(graph);
+        schedule_canvases(child, graph);
+    }
 }
 
 void Screen::draw_widgets() {
+    /* Render the contents of deferred canvases up front, so that they can
+       be composited without interrupting NanoVG */
+    if (!m_render_graph)
+        m_render_graph = new RenderGraph();
+    schedule_canvases(this, m_render_graph);
+    m_render_graph->execute();
+
     nvgBeginFrame(m_nvg_context, m_size[0], m_size[1], m_pixel_ratio);
 
     draw(m_nvg_context);
@@ -690,7 +752,53 @@ void Screen::draw_widgets() {
         }
     }
 
+    if (m_gpu_timer_overlay)
+        draw_gpu_timer_overlay();
+
     nvgEndFrame(m_nvg_context);
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    GLState::current().invalidate(GLState::NanoVG);
+#endif
+}
+
+void Screen::draw_gpu_timer_overlay() {
+    const std::vector<GPUTimer *> &timers = GPUTimer::timers();
+    if (timers.empty())
+        return;
+
+    const float font_size = 14.f, line_height = 17.f, margin = 6.f;
+    std::vector<std::string> lines;
+    for (const GPUTimer *timer : timers) {
+        GPUTimer::Stats stats = timer->stats();
+        char buf[160];
+        snprintf(buf, sizeof(buf), "%s: %.2f ms (min %.2f, max %.2f)",
+                 timer->name().empty() ? "GPUTimer" : timer->name().c_str(),
+                 stats.average, stats.minimum, stats.maximum);
+        lines.push_back(buf);
+    }
+
+    nvgSave(m_nvg_context);
+    nvgResetScissor(m_nvg_context);
+    nvgFontFace(m_nvg_context, "sans");
+    nvgFontSize(m_nvg_context, font_size);
+    nvgTextAlign(m_nvg_context, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
+
+    float width = 0.f;
+    for (const std::string &line : lines)
+        width = std::max(width, nvgTextBounds(m_nvg_context, 0.f, 0.f,
+                                              line.c_str(), nullptr, nullptr));
+
+    nvgBeginPath(m_nvg_context);
+    nvgRoundedRect(m_nvg_context, margin, margin, width + 2 * margin,
+                   lines.size() * line_height + 2 * margin, 3.f);
+    nvgFillColor(m_nvg_context, Color(0, 180));
+    nvgFill(m_nvg_context);
+
+    nvgFillColor(m_nvg_context, Color(255, 255));
+    for (size_t i = 0; i < lines.size(); ++i)
+        nvgText(m_nvg_context, 2 * margin, 2 * margin + i * line_height,
+                lines[i].c_str(), nullptr);
+    nvgRestore(m_nvg_context);
 }
 
 bool Screen::keyboard_event(int key, int scancode, int action, int modifiers) {
@@ -9,6 +9,7 @@ std::string Shader::Buffer::to_string() const {
         case BufferType::FragmentBuffer: result += "fragment"; break;
         case BufferType::UniformBuffer: result += "uniform"; break;
         case BufferType::IndexBuffer: result += "index"; break;
+        case BufferType::UniformBlockBuffer: result += "uniform block"; break;
         default: result += "unknown"; break;
     }
     result += ", dtype=";
@@ -23,4 +24,92 @@ std::string Shader::Buffer::to_string() const {
     return result;
 }
 
+Shader::Parameter Shader::parameter(const std::string &name) {
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    // Parameters are known once an asynchronously created program is linked
+    finish_linking();
+#endif
+
+    auto it = m_buffers.find(name);
+    if (it == m_buffers.end())
+        throw std::runtime_error(
+            "Shader::parameter(): could not find argument named \"" + name + "\"");
+
+    Parameter result;
+    result.m_shader = this;
+    result.m_entry = &*it;
+
+#if defined(NANOGUI_USE_METAL)
+    Buffer &buf = it->second;
+    if (buf.type == VertexTexture || buf.type == FragmentTexture) {
+        std::string sampler_name;
+        if (name.length() > 8 && name.compare(name.length() - 8, 8, "_texture") == 0)
+            sampler_name = name.substr(0, name.length() - 8) + "_sampler";
+        else
+            sampler_name = name + "_sampler";
+
+        auto it2 = m_buffers.find(sampler_name);
+        if (it2 != m_buffers.end())
+            result.m_sampler = &it2->second;
+    }
+#endif
+
+    return result;
+}
+
+const std::string &Shader::Parameter::name() const {
+    if (!m_entry)
+        throw std::runtime_error("Shader::Parameter::name(): invalid handle!");
+    return m_entry->first;
+}
+
+void Shader::set_buffer(const std::string &name, VariableType dtype, size_t ndim,
+                        const size_t *shape, const void *data) {
+    set_buffer(parameter(name), dtype, ndim, shape, data);
+}
+
+void Shader::update_buffer(const std::string &name, size_t offset, VariableType dtype,
+                           size_t ndim, const size_t *shape, const void *data) {
+    update_buffer(parameter(name), offset, dtype, ndim, shape, data);
+}
+
+void Shader::set_buffer_usage(const std::string &name, BufferUsage usage) {
+    set_buffer_usage(parameter(name), usage);
+}
+
+void Shader::set_buffer_usage(const Parameter &parameter, BufferUsage usage) {
+    if (parameter.m_shader != this)
+        throw std::runtime_error(
+            "Shader::set_buffer_usage(): the parameter handle does not belong to this shader!");
+
+    Buffer &buf = parameter.m_entry->second;
+    if (buf.type != VertexBuffer && buf.type != IndexBuffer)
+        throw std::runtime_error("Shader::set_buffer_usage(): argument named \"" +
+                                 parameter.m_entry->first + "\" is not a vertex or index buffer!");
+
+    if (buf.usage != usage) {
+        buf.usage = usage;
+        buf.capacity = 0;
+    }
+}
+
+void Shader::set_buffer_divisor(const std::string &name, uint32_t divisor) {
+    set_buffer_divisor(parameter(name), divisor);
+}
+
+void Shader::set_texture(const std::string &name, Texture *texture) {
+    set_texture(parameter(name), texture);
+}
+
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+void Shader::set_stream_buffer(const std::string &name, StreamBuffer *buffer, size_t offset,
+                               VariableType dtype, size_t ndim, const size_t *shape) {
+    set_stream_buffer(parameter(name), buffer, offset, dtype, ndim, shape);
+}
+
+void Shader::set_uniform_block(const std::string &name, UniformBlock *block) {
+    set_uniform_block(parameter(name), block);
+}
+#endif
+
 NAMESPACE_END(nanogui)
@@ -3,17 +3,26 @@
 #include <nanogui/screen.h>
 #include <nanogui/texture.h>
 #include <nanogui/renderpass.h>
+#include <nanogui/uniformblock.h>
+#include <nanogui/streambuffer.h>
+#include <nanogui/glstate.h>
 #include "opengl_check.h"
+#include <fstream>
+#include <cstdio>
+#include <cstring>
 
 #if !defined(GL_HALF_FLOAT)
 #  define GL_HALF_FLOAT 0x140B
 #endif
 
+#if !defined(GL_COMPLETION_STATUS_KHR)
+#  define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
 NAMESPACE_BEGIN(nanogui)
 
-static GLuint compile_gl_shader(GLenum type,
-                                const std::string &name,
-                                const std::string &shader_string) {
+/// Submit a shader for compilation (the result is checked by \ref check_gl_shader())
+static GLuint compile_gl_shader(GLenum type, const std::string &shader_string) {
     if (shader_string.empty())
         return (GLuint) 0;
 
@@ -21,6 +30,12 @@ static GLuint compile_gl_shader(GLenum type,
     const char *shader_string_const = shader_string.c_str();
     CHK(glShaderSource(id, 1, &shader_string_const, nullptr));
     CHK(glCompileShader(id));
+    return id;
+}
+
+static void check_gl_shader(GLuint id, GLenum type, const std::string &name) {
+    if (id == 0)
+        return;
 
     GLint status;
     CHK(glGetShaderiv(id, GL_COMPILE_STATUS, &status));
@@ -45,26 +60,273 @@ static GLuint compile_gl_shader(GLenum type,
                           type_str + " \"" + name + "\":\n\n" + error_shader;
         throw std::runtime_error(msg);
     }
+}
 
-    return id;
+/// Can compilation progress be polled (KHR/ARB_parallel_shader_compile)?
+static bool parallel_compile_supported() {
+    static int supported = -1;
+    if (supported < 0) {
+        supported = glfwExtensionSupported("GL_KHR_parallel_shader_compile") ||
+                    glfwExtensionSupported("GL_ARB_parallel_shader_compile");
+
+        // Let the driver use as many compiler threads as it likes
+        using MaxThreadsFn = void (*)(GLuint);
+        MaxThreadsFn max_threads = (MaxThreadsFn) glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+        if (!max_threads)
+            max_threads = (MaxThreadsFn) glfwGetProcAddress("glMaxShaderCompilerThreadsARB");
+        if (supported && max_threads)
+            max_threads(0xFFFFFFFFu);
+    }
+    return supported != 0;
+}
+
+/// Directory holding cached program binaries (empty if disabled)
+static std::string binary_cache_dir;
+
+/// Can linked programs be retrieved and reloaded on this context?
+static bool program_binary_supported() {
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+    return false;
+#else
+#  if defined(NANOGUI_USE_OPENGL)
+#    if defined(NANOGUI_GLAD)
+    if (!glProgramBinary || !glGetProgramBinary)
+        return false;
+#    else
+    GLint major = 0, minor = 0;
+    CHK(glGetIntegerv(GL_MAJOR_VERSION, &major));
+    CHK(glGetIntegerv(GL_MINOR_VERSION, &minor));
+    if (major < 4 || (major == 4 && minor < 1))
+        return false;
+#    endif
+#  endif
+    // Some drivers implement the entry points but support no binary format
+    GLint formats = 0;
+    CHK(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats));
+    return formats > 0;
+#endif
+}
+
+/// Return the cache file of a program, keyed by its source and the driver
+static std::string program_binary_path(const std::string &vertex_shader,
+                                       const std::string &fragment_shader) {
+    // 64-bit FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ull;
+    auto hash_string = [&hash](const char *str, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= (uint8_t) str[i];
+            hash *= 0x100000001b3ull;
+        }
+        hash ^= 0xff; // separator
+        hash *= 0x100000001b3ull;
+    };
+
+    for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+        const char *str = (const char *) glGetString(name);
+        if (str)
+            hash_string(str, strlen(str));
+    }
+    hash_string(vertex_shader.data(), vertex_shader.size());
+    hash_string(fragment_shader.data(), fragment_shader.size());
+
+    char filename[32];
+    snprintf(filename, sizeof(filename), "%016llx.bin", (unsigned long long) hash);
+
+    std::string path = binary_cache_dir;
+    if (path.back() != '/' && path.back() != '\\')
+        path += '/';
+    return path + filename;
+}
+
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+/// Header of a cached program binary
+struct ProgramBinaryHeader {
+    char magic[4];
+    uint32_t format;
+    uint32_t size;
+};
+
+static const char program_binary_magic[4] = { 'N', 'G', 'P', 'B' };
+
+/// Try to load a cached program binary, returns \c false if there is none or it was rejected
+static bool load_program_binary(GLuint program, const std::string &path) {
+    std::ifstream is(path, std::ios::binary);
+    if (!is)
+        return false;
+
+    is.seekg(0, std::ios::end);
+    std::streamoff file_size = is.tellg();
+    is.seekg(0, std::ios::beg);
+
+    // A truncated or corrupted entry is a cache miss
+    ProgramBinaryHeader header;
+    if (!is.read((char *) &header, sizeof(header)) ||
+        memcmp(header.magic, program_binary_magic, 4) != 0 ||
+        header.size == 0 ||
+        (std::streamoff) header.size != file_size - (std::streamoff) sizeof(header))
+        return false;
+
+    std::vector<uint8_t> binary(header.size);
+    if (!is.read((char *) binary.data(), (std::streamsize) header.size))
+        return false;
+
+    /* An updated driver may reject the binary (usually caught by the
+       version string in the key), which is reported via the link status */
+    glProgramBinary(program, (GLenum) header.format, binary.data(), (GLsizei) header.size);
+    while (glGetError() != GL_NO_ERROR)
+        ;
+
+    GLint status = GL_FALSE;
+    CHK(glGetProgramiv(program, GL_LINK_STATUS, &status));
+    return status == GL_TRUE;
+}
+
+/// Write the binary of a linked program to the cache
+static void save_program_binary(GLuint program, const std::string &path) {
+    GLint size = 0;
+    CHK(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &size));
+    if (size <= 0)
+        return;
+
+    std::vector<uint8_t> binary((size_t) size);
+    GLenum format = 0;
+    GLsizei length = 0;
+    CHK(glGetProgramBinary(program, size, &length, &format, binary.data()));
+    if (length <= 0)
+        return;
+
+    ProgramBinaryHeader header;
+    memcpy(header.magic, program_binary_magic, 4);
+    header.format = (uint32_t) format;
+    header.size = (uint32_t) length;
+
+    // Write to a temporary file first, so that concurrent readers never see partial data
+    std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream os(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!os)
+            return;
+        os.write((const char *) &header, sizeof(header));
+        os.write((const char *) binary.data(), length);
+        if (!os) {
+            os.close();
+            std::remove(tmp_path.c_str());
+            return;
+        }
+    }
+    std::remove(path.c_str());
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0)
+        std::remove(tmp_path.c_str());
+}
+#endif
+
+void Shader::set_binary_cache_directory(const std::string &path) {
+    binary_cache_dir = path;
+}
+
+const std::string &Shader::binary_cache_directory() {
+    return binary_cache_dir;
+}
+
+/// Vertex buffer shared by the attributes of an interleaved layout
+class InterleavedStorage : public Object {
+public:
+    InterleavedStorage() { CHK(glGenBuffers(1, &handle)); }
+    ~InterleavedStorage() { CHK(glDeleteBuffers(1, &handle)); }
+
+    GLuint handle = 0;
+    size_t capacity = 0;
+};
+
+static GLenum gl_buffer_usage(Shader::BufferUsage usage) {
+    switch (usage) {
+        case Shader::BufferUsage::Static: return GL_STATIC_DRAW;
+        case Shader::BufferUsage::Stream: return GL_STREAM_DRAW;
+        default: return GL_DYNAMIC_DRAW;
+    }
 }
 
 Shader::Shader(RenderPass *render_pass,
                const std::string &name,
                const std::string &vertex_shader,
                const std::string &fragment_shader,
-               BlendMode blend_mode)
+               BlendMode blend_mode,
+               bool asynchronous)
     : m_render_pass(render_pass), m_name(name), m_blend_mode(blend_mode), m_shader_handle(0) {
 
-    GLuint vertex_shader_handle   = compile_gl_shader(GL_VERTEX_SHADER,   name, vertex_shader),
-           fragment_shader_handle = compile_gl_shader(GL_FRAGMENT_SHADER, name, fragment_shader);
-
     m_shader_handle = glCreateProgram();
 
+    if (!binary_cache_dir.empty() && program_binary_supported())
+        m_cache_path = program_binary_path(vertex_shader, fragment_shader);
+
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+    if (!m_cache_path.empty())
+        m_loaded_from_cache = load_program_binary(m_shader_handle, m_cache_path);
+#endif
+
+    if (!m_loaded_from_cache) {
+        if (asynchronous)
+            parallel_compile_supported();
+
+        /* Submit both shaders and the link before querying any status, so
+           that drivers with background compilation can work on them */
+        m_vertex_shader_handle   = compile_gl_shader(GL_VERTEX_SHADER,   vertex_shader);
+        m_fragment_shader_handle = compile_gl_shader(GL_FRAGMENT_SHADER, fragment_shader);
+
+        CHK(glAttachShader(m_shader_handle, m_vertex_shader_handle));
+        CHK(glAttachShader(m_shader_handle, m_fragment_shader_handle));
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+        if (!m_cache_path.empty())
+            CHK(glProgramParameteri(m_shader_handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+#endif
+        CHK(glLinkProgram(m_shader_handle));
+    }
+    m_linking = true;
+
+#if defined(NANOGUI_USE_OPENGL)
+    m_uses_point_size = vertex_shader.find("gl_PointSize") != std::string::npos;
+#endif
+
+    if (!asynchronous)
+        finish_linking();
+}
+
+bool Shader::ready() {
+    if (!m_linking)
+        return true;
+
+    if (!m_loaded_from_cache && parallel_compile_supported()) {
+        GLint completed = GL_FALSE;
+        CHK(glGetProgramiv(m_shader_handle, GL_COMPLETION_STATUS_KHR, &completed));
+        if (completed != GL_TRUE)
+            return false;
+    }
+
+    finish_linking();
+    return true;
+}
+
+void Shader::finish_linking() {
+    if (!m_linking)
+        return;
+    m_linking = false;
+
+    GLuint vertex_shader_handle   = m_vertex_shader_handle,
+           fragment_shader_handle = m_fragment_shader_handle;
+    m_vertex_shader_handle = m_fragment_shader_handle = 0;
+
     GLint status;
-    CHK(glAttachShader(m_shader_handle, vertex_shader_handle));
-    CHK(glAttachShader(m_shader_handle, fragment_shader_handle));
-    CHK(glLinkProgram(m_shader_handle));
+    try {
+        check_gl_shader(vertex_shader_handle, GL_VERTEX_SHADER, m_name);
+        check_gl_shader(fragment_shader_handle, GL_FRAGMENT_SHADER, m_name);
+    } catch (...) {
+        CHK(glDeleteShader(vertex_shader_handle));
+        CHK(glDeleteShader(fragment_shader_handle));
+        CHK(glDeleteProgram(m_shader_handle));
+        m_shader_handle = 0;
+        throw;
+    }
+
     CHK(glDeleteShader(vertex_shader_handle));
     CHK(glDeleteShader(fragment_shader_handle));
     CHK(glGetProgramiv(m_shader_handle, GL_LINK_STATUS, &status));
@@ -72,11 +334,17 @@ Shader::Shader(RenderPass *render_pass,
     if (status != GL_TRUE) {
         char error_shader[4096];
         CHK(glGetProgramInfoLog(m_shader_handle, sizeof(error_shader), nullptr, error_shader));
+        CHK(glDeleteProgram(m_shader_handle));
         m_shader_handle = 0;
-        throw std::runtime_error("Shader::Shader(name=\"" + name +
+        throw std::runtime_error("Shader::Shader(name=\"" + m_name +
                                  "\"): unable to link shader!\n\n" + error_shader);
     }
 
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+    if (!m_cache_path.empty() && !m_loaded_from_cache)
+        save_program_binary(m_shader_handle, m_cache_path);
+#endif
+
     GLint attribute_count, uniform_count;
     CHK(glGetProgramiv(m_shader_handle, GL_ACTIVE_ATTRIBUTES, &attribute_count));
     CHK(glGetProgramiv(m_shader_handle, GL_ACTIVE_UNIFORMS, &uniform_count));
@@ -234,10 +502,40 @@ Shader::Shader(RenderPass *render_pass,
         GLint size = 0;
         CHK(glGetActiveUniform(m_shader_handle, i, sizeof(uniform_name), nullptr,
                                &size, &type, uniform_name));
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+        // Members of uniform blocks are set via UniformBlock
+        GLuint uniform_index = (GLuint) i;
+        GLint block_index = -1;
+        CHK(glGetActiveUniformsiv(m_shader_handle, 1, &uniform_index,
+                                  GL_UNIFORM_BLOCK_INDEX, &block_index));
+        if (block_index != -1)
+            continue;
+#endif
         GLint index = glGetUniformLocation(m_shader_handle, uniform_name);
         register_buffer(UniformBuffer, uniform_name, index, type);
     }
 
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+    GLint block_count = 0;
+    CHK(glGetProgramiv(m_shader_handle, GL_ACTIVE_UNIFORM_BLOCKS, &block_count));
+    for (int i = 0; i < block_count; ++i) {
+        char block_name[128];
+        GLint data_size = 0;
+        CHK(glGetActiveUniformBlockName(m_shader_handle, i, sizeof(block_name),
+                                        nullptr, block_name));
+        CHK(glGetActiveUniformBlockiv(m_shader_handle, i, GL_UNIFORM_BLOCK_DATA_SIZE,
+                                      &data_size));
+        if (m_buffers.find(block_name) != m_buffers.end())
+            throw std::runtime_error(
+                "Shader::Shader(): duplicate attribute/uniform name in shader code!");
+
+        Buffer &buf = m_buffers[block_name];
+        buf.index = i;
+        buf.type = UniformBlockBuffer;
+        buf.size = (size_t) data_size;
+    }
+#endif
+
     Buffer &buf = m_buffers["indices"];
     buf.index = -1;
     buf.ndim = 1;
@@ -248,29 +546,38 @@ Shader::Shader(RenderPass *render_pass,
 
 #if defined(NANOGUI_USE_OPENGL)
     CHK(glGenVertexArrays(1, &m_vertex_array_handle));
-
-    m_uses_point_size = vertex_shader.find("gl_PointSize") != std::string::npos;
 #endif
 }
 
 Shader::~Shader() {
+    if (m_linking) {
+        CHK(glDeleteShader(m_vertex_shader_handle));
+        CHK(glDeleteShader(m_fragment_shader_handle));
+    }
+    for (auto &[key, buf] : m_buffers) {
+        if (buf.type == UniformBlockBuffer && buf.buffer)
+            ((UniformBlock *) buf.buffer)->dec_ref();
+    }
+    GLState &state = GLState::current();
+    state.program_deleted(m_shader_handle);
     CHK(glDeleteProgram(m_shader_handle));
 #if defined(NANOGUI_USE_OPENGL)
+    state.vertex_array_deleted(m_vertex_array_handle);
     CHK(glDeleteVertexArrays(1, &m_vertex_array_handle));
 #endif
 }
 
-void Shader::set_buffer(const std::string &name,
+void Shader::set_buffer(const Parameter &parameter,
                         VariableType dtype,
                         size_t ndim,
                         const size_t *shape,
                         const void *data) {
-    auto it = m_buffers.find(name);
-    if (it == m_buffers.end())
+    if (parameter.m_shader != this)
         throw std::runtime_error(
-            "Shader::set_buffer(): could not find argument named \"" + name + "\"");
+            "Shader::set_buffer(): the parameter handle does not belong to this shader!");
 
-    Buffer &buf = m_buffers[name];
+    const std::string &name = parameter.m_entry->first;
+    Buffer &buf = parameter.m_entry->second;
 
     bool mismatch = ndim != buf.ndim || dtype != buf.dtype;
     for (size_t i = (buf.type == UniformBuffer ? 0 : 1); i < ndim; ++i)
@@ -303,17 +610,51 @@ void Shader::set_buffer(const std::string &name,
             buf.buffer = new uint8_t[size];
         memcpy(buf.buffer, data, size);
     } else {
+        if (buf.source) {
+            // Switch back from a stream or interleaved buffer to storage owned by the shader
+            buf.source = nullptr;
+            buf.buffer = nullptr;
+            buf.offset = 0;
+            buf.stride = 0;
+            buf.normalized = false;
+        }
+
         GLuint buffer_id = 0;
         if (buf.buffer) {
             buffer_id = (GLuint) ((uintptr_t) buf.buffer);
         } else {
             CHK(glGenBuffers(1, &buffer_id));
             buf.buffer = (void *) ((uintptr_t) buffer_id);
+            buf.capacity = 0;
         }
-        GLenum buf_type = (name == "indices")
+        GLenum buf_type = (buf.type == IndexBuffer)
             ? GL_ELEMENT_ARRAY_BUFFER : GL_ARRAY_BUFFER;
+        // The index buffer binding is part of the bound vertex array
+#if defined(NANOGUI_USE_OPENGL)
+        if (buf.type == IndexBuffer)
+            GLState::current().bind_vertex_array(0);
+#endif
         CHK(glBindBuffer(buf_type, buffer_id));
-        CHK(glBufferData(buf_type, size, data, GL_DYNAMIC_DRAW));
+
+        if (size > buf.capacity || buf.capacity == 0) {
+            /* Grow geometrically, unless the buffer is not expected to change.
+               The first allocation matches the requested size exactly. */
+            size_t capacity = size;
+            if (buf.capacity != 0 && buf.usage != BufferUsage::Static)
+                capacity = std::max(size, buf.capacity * 2);
+            CHK(glBufferData(buf_type, capacity, capacity == size ? data : nullptr,
+                             gl_buffer_usage(buf.usage)));
+            if (capacity != size)
+                CHK(glBufferSubData(buf_type, 0, size, data));
+            buf.capacity = capacity;
+        } else {
+            /* Reuse the existing storage. Streamed buffers are orphaned first,
+               so that the driver does not have to wait for pending draw calls */
+            if (buf.usage == BufferUsage::Stream)
+                CHK(glBufferData(buf_type, buf.capacity, nullptr,
+                                 gl_buffer_usage(buf.usage)));
+            CHK(glBufferSubData(buf_type, 0, size, data));
+        }
     }
 
     buf.dtype = dtype;
@@ -322,12 +663,193 @@ void Shader::set_buffer(const std::string &name,
     buf.dirty = true;
 }
 
-void Shader::set_texture(const std::string &name, Texture *texture) {
-    auto it = m_buffers.find(name);
-    if (it == m_buffers.end())
+void Shader::set_interleaved_buffer(const std::vector<VertexAttribute> &layout,
+                                    size_t stride, size_t count, const void *data) {
+    if (layout.empty() || stride == 0)
+        throw std::runtime_error("Shader::set_interleaved_buffer(): the layout and "
+                                 "stride must be nonzero!");
+
+    finish_linking();
+    std::vector<Buffer *> bufs;
+    for (const VertexAttribute &attr : layout) {
+        auto it = m_buffers.find(attr.name);
+        if (it == m_buffers.end() || it->second.type != VertexBuffer)
+            throw std::runtime_error("Shader::set_interleaved_buffer(): could not find "
+                                     "vertex attribute named \"" + attr.name + "\"!");
+        Buffer &buf = it->second;
+
+        // The attribute was registered with a shape of [0, components]
+        if (attr.components != buf.shape[1] || attr.type == VariableType::Bool ||
+            attr.type == VariableType::Invalid || attr.type == VariableType::Float64 ||
+            attr.offset + attr.components * type_size(attr.type) > stride)
+            throw std::runtime_error("Shader::set_interleaved_buffer(): vertex attribute \"" +
+                                     attr.name + "\" has an invalid type, size, or offset!");
+        bufs.push_back(&buf);
+    }
+
+    // Reuse the storage if the attributes already share an interleaved buffer
+    ref<InterleavedStorage> storage =
+        dynamic_cast<InterleavedStorage *>(bufs[0]->source.get());
+    for (Buffer *buf : bufs) {
+        if (!storage || buf->source.get() != storage.get()) {
+            storage = new InterleavedStorage();
+            break;
+        }
+    }
+
+    size_t size = stride * count;
+    CHK(glBindBuffer(GL_ARRAY_BUFFER, storage->handle));
+    if (size > storage->capacity || storage->capacity == 0) {
+        CHK(glBufferData(GL_ARRAY_BUFFER, size, data, GL_DYNAMIC_DRAW));
+        storage->capacity = size;
+    } else {
+        CHK(glBufferSubData(GL_ARRAY_BUFFER, 0, size, data));
+    }
+
+    for (size_t i = 0; i < layout.size(); ++i) {
+        const VertexAttribute &attr = layout[i];
+        Buffer &buf = *bufs[i];
+
+        if (!buf.source && buf.buffer) {
+            GLuint buffer_id = (GLuint) ((uintptr_t) buf.buffer);
+            CHK(glDeleteBuffers(1, &buffer_id));
+        }
+
+        buf.source     = storage;
+        buf.buffer     = (void *) ((uintptr_t) storage->handle);
+        buf.offset     = attr.offset;
+        buf.stride     = stride;
+        buf.normalized = attr.normalized;
+        buf.dtype      = attr.type;
+        buf.ndim       = 2;
+        buf.shape[0]   = count;
+        buf.shape[1]   = attr.components;
+        buf.shape[2]   = 1;
+        buf.size       = size;
+        buf.capacity   = 0;
+        buf.dirty      = true;
+    }
+}
+
+void Shader::update_buffer(const Parameter &parameter,
+                           size_t offset,
+                           VariableType dtype,
+                           size_t ndim,
+                           const size_t *shape,
+                           const void *data) {
+    if (parameter.m_shader != this)
+        throw std::runtime_error(
+            "Shader::update_buffer(): the parameter handle does not belong to this shader!");
+
+    const std::string &name = parameter.m_entry->first;
+    Buffer &buf = parameter.m_entry->second;
+    if (buf.type != VertexBuffer && buf.type != IndexBuffer)
+        throw std::runtime_error("Shader::update_buffer(): argument named \"" + name +
+                                 "\" is not a vertex or index buffer!");
+    if (!buf.buffer || buf.source)
+        throw std::runtime_error("Shader::update_buffer(): argument named \"" + name +
+                                 "\" must first be uploaded using set_buffer()!");
+
+    bool mismatch = ndim != buf.ndim || dtype != buf.dtype;
+    for (size_t i = 1; i < ndim; ++i)
+        mismatch |= shape[i] != buf.shape[i];
+    if (mismatch)
+        throw std::runtime_error("Shader::update_buffer(\"" + name +
+                                 "\"): shape/dtype mismatch: expected " + buf.to_string());
+
+    size_t count = ndim > 0 ? shape[0] : 1;
+    if (offset + count > buf.shape[0])
+        throw std::runtime_error("Shader::update_buffer(\"" + name +
+                                 "\"): the range exceeds the size of the buffer!");
+    if (count == 0)
+        return;
+
+    size_t stride = type_size(dtype) * buf.shape[1] * buf.shape[2];
+    GLenum buf_type = (buf.type == IndexBuffer)
+        ? GL_ELEMENT_ARRAY_BUFFER : GL_ARRAY_BUFFER;
+#if defined(NANOGUI_USE_OPENGL)
+    if (buf.type == IndexBuffer)
+        GLState::current().bind_vertex_array(0);
+#endif
+    CHK(glBindBuffer(buf_type, (GLuint) ((uintptr_t) buf.buffer)));
+    CHK(glBufferSubData(buf_type, (GLintptr) (offset * stride),
+                        (GLsizeiptr) (count * stride), data));
+}
+
+void Shader::set_stream_buffer(const Parameter &parameter,
+                               StreamBuffer *stream,
+                               size_t offset,
+                               VariableType dtype,
+                               size_t ndim,
+                               const size_t *shape) {
+    if (parameter.m_shader != this)
+        throw std::runtime_error(
+            "Shader::set_stream_buffer(): the parameter handle does not belong to this shader!");
+
+    const std::string &name = parameter.m_entry->first;
+    Buffer &buf = parameter.m_entry->second;
+    if (buf.type != VertexBuffer)
+        throw std::runtime_error("Shader::set_stream_buffer(): argument named \"" + name +
+                                 "\" is not a vertex attribute!");
+
+    bool mismatch = ndim != buf.ndim || dtype != buf.dtype;
+    for (size_t i = 1; i < ndim; ++i)
+        mismatch |= shape[i] != buf.shape[i];
+    if (mismatch)
+        throw std::runtime_error("Shader::set_stream_buffer(\"" + name +
+                                 "\"): shape/dtype mismatch: expected " + buf.to_string());
+
+    size_t size = type_size(dtype);
+    for (size_t i = 0; i < 3; ++i) {
+        buf.shape[i] = i < ndim ? shape[i] : 1;
+        size *= buf.shape[i];
+    }
+
+    if (!buf.source && buf.buffer) {
+        GLuint buffer_id = (GLuint) ((uintptr_t) buf.buffer);
+        CHK(glDeleteBuffers(1, &buffer_id));
+    }
+
+    buf.source   = stream;
+    buf.buffer   = (void *) ((uintptr_t) stream->buffer_handle());
+    buf.offset   = offset;
+    buf.stride   = 0;
+    buf.normalized = false;
+    buf.size     = size;
+    buf.capacity = 0;
+    buf.dirty    = true;
+}
+
+void Shader::set_buffer_divisor(const Parameter &parameter, uint32_t divisor) {
+    if (parameter.m_shader != this)
+        throw std::runtime_error(
+            "Shader::set_buffer_divisor(): the parameter handle does not belong to this shader!");
+
+    const std::string &name = parameter.m_entry->first;
+    Buffer &buf = parameter.m_entry->second;
+    if (buf.type != VertexBuffer)
+        throw std::runtime_error("Shader::set_buffer_divisor(): argument named \"" + name +
+                                 "\" is not a vertex attribute!");
+
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+    if (divisor != 0)
+        throw std::runtime_error("Shader::set_buffer_divisor(): instanced rendering is not "
+                                 "supported on OpenGL ES 2!");
+#endif
+
+    if (buf.divisor != divisor) {
+        buf.divisor = divisor;
+        buf.dirty = true;
+    }
+}
+
+void Shader::set_texture(const Parameter &parameter, Texture *texture) {
+    if (parameter.m_shader != this)
         throw std::runtime_error(
-            "Shader::set_texture(): could not find argument named \"" + name + "\"");
-    Buffer &buf = m_buffers[name];
+            "Shader::set_texture(): the parameter handle does not belong to this shader!");
+
+    const std::string &name = parameter.m_entry->first;
+    Buffer &buf = parameter.m_entry->second;
     if (!(buf.type == VertexTexture || buf.type == FragmentTexture))
         throw std::runtime_error(
             "Shader::set_texture(): argument named \"" + name + "\" is not a texture!");
@@ -336,13 +858,42 @@ void Shader::set_texture(const std::string &name, Texture *texture) {
     buf.dirty  = true;
 }
 
+void Shader::set_uniform_block(const Parameter &parameter, UniformBlock *block) {
+    if (parameter.m_shader != this)
+        throw std::runtime_error(
+            "Shader::set_uniform_block(): the parameter handle does not belong to this shader!");
+
+    const std::string &name = parameter.m_entry->first;
+    Buffer &buf = parameter.m_entry->second;
+    if (buf.type != UniformBlockBuffer)
+        throw std::runtime_error(
+            "Shader::set_uniform_block(): argument named \"" + name + "\" is not a uniform block!");
+    if (block->size() != buf.size)
+        throw std::runtime_error(
+            "Shader::set_uniform_block(\"" + name + "\"): size mismatch: expected " +
+            std::to_string(buf.size) + " bytes, got " + std::to_string(block->size()) +
+            " (declare the block using layout(std140) in all shaders)");
+
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+    CHK(glUniformBlockBinding(m_shader_handle, (GLuint) buf.index, block->binding()));
+#endif
+
+    block->inc_ref();
+    if (buf.buffer)
+        ((UniformBlock *) buf.buffer)->dec_ref();
+    buf.buffer = block;
+}
+
 void Shader::begin() {
-    int texture_unit = 0;
+    finish_linking();
 
-    CHK(glUseProgram(m_shader_handle));
+    int texture_unit = 0;
+    GLuint bound_array_buffer = 0;
 
+    GLState &state = GLState::current();
+    state.use_program(m_shader_handle);
 #if defined(NANOGUI_USE_OPENGL)
-    CHK(glBindVertexArray(m_vertex_array_handle));
+    state.bind_vertex_array(m_vertex_array_handle);
 #endif
 
     for (auto &[key, buf] : m_buffers) {
@@ -360,7 +911,8 @@ void Shader::begin() {
         GLenum gl_type = 0;
 
 #if defined(NANOGUI_USE_OPENGL)
-        if (!buf.dirty && buf.type != VertexTexture && buf.type != FragmentTexture)
+        if (!buf.dirty && buf.type != VertexTexture && buf.type != FragmentTexture &&
+            buf.type != UniformBlockBuffer)
             continue;
 #endif
 
@@ -371,7 +923,11 @@ void Shader::begin() {
                 break;
 
             case VertexBuffer:
-                CHK(glBindBuffer(GL_ARRAY_BUFFER, buffer_id));
+                // Attributes of an interleaved layout share a buffer
+                if (buffer_id != bound_array_buffer) {
+                    CHK(glBindBuffer(GL_ARRAY_BUFFER, buffer_id));
+                    bound_array_buffer = buffer_id;
+                }
                 CHK(glEnableVertexAttribArray(buf.index));
 
                 switch (buf.dtype) {
@@ -393,14 +949,27 @@ void Shader::begin() {
                                              "\" has an invalid shapeension (expected ndim=2, got " +
                                              std::to_string(buf.ndim) + ")");
 
-                CHK(glVertexAttribPointer(buf.index, (GLint) buf.shape[1],
-                                          gl_type, GL_FALSE, 0, nullptr));
+                CHK(glVertexAttribPointer(buf.index, (GLint) buf.shape[1], gl_type,
+                                          buf.normalized ? GL_TRUE : GL_FALSE,
+                                          (GLsizei) buf.stride,
+                                          (const void *) buf.offset));
+#if defined(NANOGUI_USE_OPENGL)
+                CHK(glVertexAttribDivisor(buf.index, buf.divisor));
+#elif NANOGUI_GLES_VERSION >= 3
+                if (buf.divisor != 0)
+                    CHK(glVertexAttribDivisor(buf.index, buf.divisor));
+#endif
+                break;
+
+            case UniformBlockBuffer:
+                // Shared by other shaders, which may have modified it
+                ((UniformBlock *) buf.buffer)->upload();
                 break;
 
             case VertexTexture:
             case FragmentTexture:
-                CHK(glActiveTexture(GL_TEXTURE0 + texture_unit));
-                CHK(glBindTexture(GL_TEXTURE_2D, (GLuint) ((uintptr_t) buf.buffer)));
+                state.bind_texture((uint32_t) texture_unit, GL_TEXTURE_2D,
+                                   (GLuint) ((uintptr_t) buf.buffer));
                 if (buf.dirty)
                     CHK(glUniform1i(buf.index, texture_unit));
                 texture_unit++;
@@ -506,32 +1075,31 @@ void Shader::begin() {
         buf.dirty = false;
     }
 
-    if (m_blend_mode == BlendMode::AlphaBlend) {
-        CHK(glEnable(GL_BLEND));
-        CHK(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
-    }
+    state.set_enabled(GLState::Capability::Blend, m_blend_mode == BlendMode::AlphaBlend);
+    if (m_blend_mode == BlendMode::AlphaBlend)
+        state.blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 #if defined(NANOGUI_USE_OPENGL)
-    if (m_uses_point_size)
-        CHK(glEnable(GL_PROGRAM_POINT_SIZE));
+    state.set_enabled(GLState::Capability::ProgramPointSize, m_uses_point_size);
 #endif
 }
 
 void Shader::end() {
-    if (m_blend_mode == BlendMode::AlphaBlend)
-        CHK(glDisable(GL_BLEND));
-#if defined(NANOGUI_USE_OPENGL)
-    if (m_uses_point_size)
-        CHK(glDisable(GL_PROGRAM_POINT_SIZE));
-    CHK(glBindVertexArray(0));
-#else
+    /* The program, vertex array, and blending state stay in place, which
+       avoids rebinding them when the next draw call uses the same shader.
+       RenderPass::end() releases the program and vertex array. */
+#if defined(NANOGUI_USE_GLES)
     for (const auto &[key, buf] : m_buffers) {
         if (buf.type != VertexBuffer)
             continue;
         CHK(glDisableVertexAttribArray(buf.index));
+#if NANOGUI_GLES_VERSION >= 3
+        // Without a vertex array object, the divisor would affect subsequent draw calls
+        if (buf.divisor != 0)
+            CHK(glVertexAttribDivisor(buf.index, 0));
+#endif
     }
 #endif
-    CHK(glUseProgram(0));
 }
 
 void Shader::draw_array(PrimitiveType primitive_type,
@@ -554,4 +1122,34 @@ void Shader::draw_array(PrimitiveType primitive_type,
                            (const void *) (offset * sizeof(uint32_t))));
 }
 
+void Shader::draw_array_instanced(PrimitiveType primitive_type,
+                                  size_t offset, size_t count,
+                                  size_t instances,
+                                  bool indexed) {
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+    if (instances != 1)
+        throw std::runtime_error("Shader::draw_array_instanced(): instanced rendering is "
+                                 "not supported on OpenGL ES 2!");
+    draw_array(primitive_type, offset, count, indexed);
+#else
+    GLenum primitive_type_gl;
+    switch (primitive_type) {
+        case PrimitiveType::Point:         primitive_type_gl = GL_POINTS;         break;
+        case PrimitiveType::Line:          primitive_type_gl = GL_LINES;          break;
+        case PrimitiveType::LineStrip:     primitive_type_gl = GL_LINE_STRIP;     break;
+        case PrimitiveType::Triangle:      primitive_type_gl = GL_TRIANGLES;      break;
+        case PrimitiveType::TriangleStrip: primitive_type_gl = GL_TRIANGLE_STRIP; break;
+        default: throw std::runtime_error("Shader::draw_array_instanced(): invalid primitive type!");
+    }
+
+    if (!indexed)
+        CHK(glDrawArraysInstanced(primitive_type_gl, (GLint) offset, (GLsizei) count,
+                                  (GLsizei) instances));
+    else
+        CHK(glDrawElementsInstanced(primitive_type_gl, (GLsizei) count, GL_UNSIGNED_INT,
+                                    (const void *) (offset * sizeof(uint32_t)),
+                                    (GLsizei) instances));
+#endif
+}
+
 NAMESPACE_END(nanogui)
@@ -58,7 +58,8 @@ Shader::Shader(RenderPass *render_pass,
                const std::string &name,
                const std::string &vertex_shader,
                const std::string &fragment_shader,
-               BlendMode blend_mode)
+               BlendMode blend_mode,
+               bool /* asynchronous */)
     : m_render_pass(render_pass), m_name(name), m_blend_mode(blend_mode), m_pipeline_state(nullptr) {
     id<MTLDevice> device = (__bridge id<MTLDevice>) metal_device();
     id<MTLFunction> vertex_func   = compile_metal_shader(device, name, "vertex", vertex_shader),
@@ -189,6 +190,11 @@ Shader::Shader(RenderPass *render_pass,
     buf.type = IndexBuffer;
 }
 
+bool Shader::ready() {
+    // Metal pipelines are created synchronously
+    return true;
+}
+
 Shader::~Shader() {
     for (const auto &[key, buf] : m_buffers) {
         if (!buf.buffer)
@@ -213,16 +219,58 @@ Shader::~Shader() {
     (void) (__bridge_transfer id<MTLRenderPipelineState>) m_pipeline_state;
 }
 
-void Shader::set_buffer(const std::string &name,
+/**
+ * Write 'size' bytes of 'data' to 'target' at 'offset' by means of a blit
+ * from a shared staging buffer. When 'source' is specified, its contents
+ * are copied into 'target' first.
+ *
+ * The blit is committed on its own command buffer. Command buffers of a
+ * queue execute in the order in which they are committed, and render
+ * passes commit theirs in RenderPass::end(), hence there is no need to
+ * wait for the copy. The staging buffer is retained until it completes.
+ */
+static void metal_upload_buffer(id<MTLBuffer> target, id<MTLBuffer> source,
+                                size_t offset, const void *data, size_t size) {
+    id<MTLDevice> device = (__bridge id<MTLDevice>) metal_device();
+    id<MTLBuffer> staging_buffer =
+        [device newBufferWithBytes: data
+                            length: size
+                           options: MTLResourceStorageModeShared];
+
+    id<MTLCommandQueue> command_queue =
+        (__bridge id<MTLCommandQueue>) metal_command_queue();
+    id<MTLCommandBuffer> command_buffer = [command_queue commandBuffer];
+    id<MTLBlitCommandEncoder> blit_encoder =
+        [command_buffer blitCommandEncoder];
+
+    if (source)
+        [blit_encoder copyFromBuffer: source
+                        sourceOffset: 0
+                            toBuffer: target
+                   destinationOffset: 0
+                                size: [source length]];
+
+    [blit_encoder copyFromBuffer: staging_buffer
+                    sourceOffset: 0
+                        toBuffer: target
+               destinationOffset: offset
+                            size: size];
+
+    [blit_encoder endEncoding];
+    [command_buffer commit];
+}
+
+void Shader::set_buffer(const Parameter &parameter,
                         VariableType dtype,
                         size_t ndim,
                         const size_t *shape,
                         const void *data) {
-    auto it = m_buffers.find(name);
-    if (it == m_buffers.end())
+    if (parameter.m_shader != this)
         throw std::runtime_error(
-            "Shader::set_buffer(): could not find argument named \"" + name + "\"");
-    Buffer &buf = m_buffers[name];
+            "Shader::set_buffer(): the parameter handle does not belong to this shader!");
+
+    const std::string &name = parameter.m_entry->first;
+    Buffer &buf = parameter.m_entry->second;
     if (!(buf.type == VertexBuffer ||
           buf.type == FragmentBuffer ||
           buf.type == IndexBuffer))
@@ -241,43 +289,28 @@ void Shader::set_buffer(const std::string &name,
         buf.buffer = nullptr;
     }
 
-    if (size <= NANOGUI_BUFFER_THRESHOLD && name != "indices") {
+    if (size <= NANOGUI_BUFFER_THRESHOLD && buf.type != IndexBuffer) {
         if (!buf.buffer)
             buf.buffer = new uint8_t[size];
         memcpy(buf.buffer, data, size);
     } else {
         /* Procedure recommended by Apple: create a temporary shared buffer and
-           blit into a private GPU-only buffer */
+           blit into a private GPU-only buffer. The blit executes before any
+           draw calls of an active render pass, which therefore receive a new
+           buffer while the ones encoded so far keep the old contents */
         id<MTLDevice> device = (__bridge id<MTLDevice>) metal_device();
-        id<MTLBuffer> mtl_buffer;
+        id<MTLBuffer> mtl_buffer = nil;
 
-        if (buf.buffer)
+        if (buf.buffer) {
             mtl_buffer = (__bridge_transfer id<MTLBuffer>) buf.buffer;
-        else
+            buf.buffer = nullptr;
+        }
+        if (!mtl_buffer || m_render_pass->active())
             mtl_buffer =
                 [device newBufferWithLength: size
                                     options: MTLResourceStorageModePrivate];
 
-        id<MTLBuffer> temp_buffer =
-            [device newBufferWithBytes: data
-                                length: size
-                               options: MTLResourceStorageModeShared];
-
-        id<MTLCommandQueue> command_queue =
-            (__bridge id<MTLCommandQueue>) metal_command_queue();
-        id<MTLCommandBuffer> command_buffer = [command_queue commandBuffer];
-        id<MTLBlitCommandEncoder> blit_encoder =
-            [command_buffer blitCommandEncoder];
-
-        [blit_encoder copyFromBuffer: temp_buffer
-                        sourceOffset: 0
-                            toBuffer: mtl_buffer
-                   destinationOffset: 0
-                                size: size];
-
-        [blit_encoder endEncoding];
-        [command_buffer commit];
-        [command_buffer waitUntilCompleted];
+        metal_upload_buffer(mtl_buffer, nil, 0, data, size);
 
         buf.buffer = (__bridge_retained void *) mtl_buffer;
     }
@@ -287,12 +320,77 @@ void Shader::set_buffer(const std::string &name,
     buf.size  = size;
 }
 
-void Shader::set_texture(const std::string &name, Texture *texture) {
-    auto it = m_buffers.find(name);
-    if (it == m_buffers.end())
+void Shader::set_interleaved_buffer(const std::vector<VertexAttribute> &,
+                                    size_t, size_t, const void *) {
+    throw std::runtime_error("Shader::set_interleaved_buffer(): not supported by the Metal "
+                             "backend, declare a vertex struct in the shader instead!");
+}
+
+void Shader::update_buffer(const Parameter &parameter,
+                           size_t offset,
+                           VariableType dtype,
+                           size_t ndim,
+                           const size_t *shape,
+                           const void *data) {
+    if (parameter.m_shader != this)
         throw std::runtime_error(
-            "Shader::set_texture(): could not find argument named \"" + name + "\"");
-    Buffer &buf = m_buffers[name];
+            "Shader::update_buffer(): the parameter handle does not belong to this shader!");
+
+    const std::string &name = parameter.m_entry->first;
+    Buffer &buf = parameter.m_entry->second;
+    if (buf.type != VertexBuffer && buf.type != IndexBuffer)
+        throw std::runtime_error("Shader::update_buffer(): argument named \"" + name +
+                                 "\" is not a vertex or index buffer!");
+    if (!buf.buffer)
+        throw std::runtime_error("Shader::update_buffer(): argument named \"" + name +
+                                 "\" must first be uploaded using set_buffer()!");
+
+    bool mismatch = ndim != buf.ndim || dtype != buf.dtype;
+    for (size_t i = 1; i < ndim; ++i)
+        mismatch |= shape[i] != buf.shape[i];
+    if (mismatch)
+        throw std::runtime_error("Shader::update_buffer(\"" + name +
+                                 "\"): shape/dtype mismatch: expected " + buf.to_string());
+
+    size_t count = ndim > 0 ? shape[0] : 1;
+    if (offset + count > buf.shape[0])
+        throw std::runtime_error("Shader::update_buffer(\"" + name +
+                                 "\"): the range exceeds the size of the buffer!");
+    if (count == 0)
+        return;
+
+    size_t stride = type_size(dtype) * buf.shape[1] * buf.shape[2];
+
+    if (buf.size <= NANOGUI_BUFFER_THRESHOLD && buf.type != IndexBuffer) {
+        memcpy((uint8_t *) buf.buffer + offset * stride, data, count * stride);
+    } else {
+        id<MTLBuffer> mtl_buffer = (__bridge id<MTLBuffer>) buf.buffer;
+
+        if (m_render_pass->active()) {
+            /* The blit would execute before the draw calls that the active
+               render pass has already encoded. Give the remaining ones a
+               modified copy instead (copy on write) */
+            id<MTLDevice> device = (__bridge id<MTLDevice>) metal_device();
+            id<MTLBuffer> new_buffer =
+                [device newBufferWithLength: [mtl_buffer length]
+                                    options: MTLResourceStorageModePrivate];
+            metal_upload_buffer(new_buffer, mtl_buffer, offset * stride, data,
+                                count * stride);
+            (void) (__bridge_transfer id<MTLBuffer>) buf.buffer;
+            buf.buffer = (__bridge_retained void *) new_buffer;
+        } else {
+            metal_upload_buffer(mtl_buffer, nil, offset * stride, data, count * stride);
+        }
+    }
+}
+
+void Shader::set_texture(const Parameter &parameter, Texture *texture) {
+    if (parameter.m_shader != this)
+        throw std::runtime_error(
+            "Shader::set_texture(): the parameter handle does not belong to this shader!");
+
+    const std::string &name = parameter.m_entry->first;
+    Buffer &buf = parameter.m_entry->second;
     if (!(buf.type == VertexTexture || buf.type == FragmentTexture))
         throw std::runtime_error(
             "Shader::set_texture(): argument named \"" + name + "\" is not a texture!");
@@ -305,15 +403,9 @@ void Shader::set_texture(const std::string &name, Texture *texture) {
     buf.buffer = (__bridge_retained void *) ((__bridge id<MTLTexture>)
                                                  texture->texture_handle());
 
-    std::string sampler_name;
-    if (name.length() > 8 && name.compare(name.length() - 8, 8, "_texture") == 0)
-        sampler_name = name.substr(0, name.length()-8) + "_sampler";
-    else
-        sampler_name = name + "_sampler";
-
-    if (m_buffers.find(sampler_name) != m_buffers.end()) {
+    if (parameter.m_sampler) {
         /* Also set the sampler state */
-        Buffer &buf2 = m_buffers[sampler_name];
+        Buffer &buf2 = *parameter.m_sampler;
 
         if (buf2.buffer) {
             (void) (__bridge_transfer id<MTLTexture>) buf2.buffer;
@@ -402,9 +494,25 @@ void Shader::end() {
     /* No-op */
 }
 
+void Shader::set_buffer_divisor(const Parameter &parameter, uint32_t divisor) {
+    if (parameter.m_shader != this)
+        throw std::runtime_error(
+            "Shader::set_buffer_divisor(): the parameter handle does not belong to this shader!");
+    if (divisor != 0)
+        throw std::runtime_error("Shader::set_buffer_divisor(): not supported by the Metal "
+                                 "backend, index per-instance data using [[instance_id]]!");
+}
+
 void Shader::draw_array(PrimitiveType primitive_type,
                         size_t offset, size_t count,
                         bool indexed) {
+    draw_array_instanced(primitive_type, offset, count, 1, indexed);
+}
+
+void Shader::draw_array_instanced(PrimitiveType primitive_type,
+                                  size_t offset, size_t count,
+                                  size_t instances,
+                                  bool indexed) {
     MTLPrimitiveType primitive_type_mtl;
     switch (primitive_type) {
         case PrimitiveType::Point:         primitive_type_mtl = MTLPrimitiveTypePoint;         break;
@@ -421,7 +529,8 @@ void Shader::draw_array(PrimitiveType primitive_type,
     if (!indexed) {
         [command_enc drawPrimitives: primitive_type_mtl
                         vertexStart: offset
-                        vertexCount: count];
+                        vertexCount: count
+                      instanceCount: instances];
     } else {
         id<MTLBuffer> index_buffer =
             (__bridge id<MTLBuffer>) m_buffers["indices"].buffer;
@@ -429,7 +538,8 @@ void Shader::draw_array(PrimitiveType primitive_type,
                                 indexCount: count
                                  indexType: MTLIndexTypeUInt32
                                indexBuffer: index_buffer
-                         indexBufferOffset: offset * 4];
+                         indexBufferOffset: offset * 4
+                             instanceCount: instances];
     }
 }
 
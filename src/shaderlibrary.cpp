@@ -0,0 +1,96 @@
+#include <nanogui/shaderlibrary.h>
+
+NAMESPACE_BEGIN(nanogui)
+
+ShaderLibrary::ShaderLibrary(RenderPass *render_pass,
+                             const std::string &name,
+                             const std::string &vertex_shader,
+                             const std::string &fragment_shader,
+                             const std::vector<std::string> &features,
+                             Shader::BlendMode blend_mode,
+                             bool asynchronous)
+    : m_render_pass(render_pass), m_name(name), m_vertex_shader(vertex_shader),
+      m_fragment_shader(fragment_shader), m_features(features),
+      m_blend_mode(blend_mode), m_asynchronous(asynchronous) {
+    if (features.size() > MaxFeatures)
+        throw std::runtime_error("ShaderLibrary::ShaderLibrary(\"" + name +
+                                 "\"): at most 32 features are supported!");
+
+#if defined(NANOGUI_USE_METAL)
+    if (vertex_shader.compare(0, 4, "MTLB") == 0 ||
+        fragment_shader.compare(0, 4, "MTLB") == 0)
+        throw std::runtime_error("ShaderLibrary::ShaderLibrary(\"" + name +
+                                 "\"): precompiled Metal libraries cannot be "
+                                 "specialized, use NANOGUI_SHADER_SOURCE()!");
+#endif
+}
+
+uint32_t ShaderLibrary::feature(const std::string &name) const {
+    for (size_t i = 0; i < m_features.size(); ++i) {
+        if (m_features[i] == name)
+            return 1u << i;
+    }
+    throw std::runtime_error("ShaderLibrary::feature(): unknown feature \"" +
+                             name + "\"!");
+}
+
+std::string ShaderLibrary::specialize(const std::string &source,
+                                      uint32_t features) const {
+    std::string defines;
+    for (size_t i = 0; i < m_features.size(); ++i) {
+        if (features & (1u << i))
+            defines += "#define " + m_features[i] + " 1\n";
+    }
+    if (defines.empty())
+        return source;
+
+    /* GLSL requires #version to precede everything else except for
+       comments and whitespace */
+    size_t pos = 0;
+    size_t version = source.find("#version");
+    if (version != std::string::npos &&
+        (version == 0 || source[version - 1] == '\n')) {
+        pos = source.find('\n', version);
+        if (pos == std::string::npos)
+            return source + "\n" + defines;
+        pos++;
+    }
+
+    return source.substr(0, pos) + defines + source.substr(pos);
+}
+
+Shader *ShaderLibrary::shader(uint32_t features) {
+    auto it = m_shaders.find(features);
+    if (it != m_shaders.end())
+        return it->second.get();
+
+    uint32_t valid = m_features.size() == 32 ? 0xFFFFFFFFu
+                                             : ((1u << m_features.size()) - 1u);
+    if (features & ~valid)
+        throw std::runtime_error("ShaderLibrary::shader(\"" + m_name +
+                                 "\"): the feature mask contains unknown bits!");
+
+    std::string name = m_name;
+    if (features) {
+        name += "[";
+        for (size_t i = 0; i < m_features.size(); ++i) {
+            if (!(features & (1u << i)))
+                continue;
+            if (name.back() != '[')
+                name += ",";
+            name += m_features[i];
+        }
+        name += "]";
+    }
+
+    ref<Shader> shader = new Shader(
+        m_render_pass, name,
+        specialize(m_vertex_shader, features),
+        specialize(m_fragment_shader, features),
+        m_blend_mode, m_asynchronous);
+
+    m_shaders[features] = shader;
+    return shader.get();
+}
+
+NAMESPACE_END(nanogui)
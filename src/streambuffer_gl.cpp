@@ -0,0 +1,175 @@
+#include <nanogui/streambuffer.h>
+#include <nanogui/opengl.h>
+#include "opengl_check.h"
+#include <cstring>
+
+NAMESPACE_BEGIN(nanogui)
+
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+/// Is glBufferStorage() (OpenGL 4.4 or ARB_buffer_storage) available?
+static bool has_buffer_storage() {
+#if defined(NANOGUI_USE_OPENGL) && defined(GL_MAP_PERSISTENT_BIT)
+#  if defined(NANOGUI_GLAD)
+    return glBufferStorage != nullptr;
+#  else
+    GLint major = 0, minor = 0;
+    CHK(glGetIntegerv(GL_MAJOR_VERSION, &major));
+    CHK(glGetIntegerv(GL_MINOR_VERSION, &minor));
+    return major > 4 || (major == 4 && minor >= 4);
+#  endif
+#else
+    return false;
+#endif
+}
+#endif
+
+StreamBuffer::StreamBuffer(size_t frame_size) : m_frame_size(frame_size) {
+    if (frame_size == 0)
+        throw std::runtime_error("StreamBuffer::StreamBuffer(): the size must be positive!");
+
+    size_t size = frame_size * SegmentCount;
+    CHK(glGenBuffers(1, &m_buffer_handle));
+    CHK(glBindBuffer(GL_ARRAY_BUFFER, m_buffer_handle));
+
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+    if (has_buffer_storage()) {
+#  if defined(NANOGUI_USE_OPENGL) && defined(GL_MAP_PERSISTENT_BIT)
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        CHK(glBufferStorage(GL_ARRAY_BUFFER, (GLsizeiptr) size, nullptr, flags));
+        m_persistent = (uint8_t *) glMapBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr) size, flags);
+        if (!m_persistent)
+            throw std::runtime_error("StreamBuffer::StreamBuffer(): could not map the buffer!");
+#  endif
+    } else {
+        CHK(glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) size, nullptr, GL_STREAM_DRAW));
+    }
+#else
+    CHK(glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) size, nullptr, GL_STREAM_DRAW));
+#endif
+
+    CHK(glBindBuffer(GL_ARRAY_BUFFER, 0));
+}
+
+StreamBuffer::~StreamBuffer() {
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+    for (size_t i = 0; i < SegmentCount; ++i) {
+        if (m_fences[i])
+            CHK(glDeleteSync((GLsync) m_fences[i]));
+    }
+    if (m_persistent) {
+        CHK(glBindBuffer(GL_ARRAY_BUFFER, m_buffer_handle));
+        CHK(glUnmapBuffer(GL_ARRAY_BUFFER));
+        CHK(glBindBuffer(GL_ARRAY_BUFFER, 0));
+    }
+#endif
+    CHK(glDeleteBuffers(1, &m_buffer_handle));
+}
+
+uint8_t *StreamBuffer::map(size_t size, size_t &offset, size_t alignment) {
+    if (m_mapped)
+        throw std::runtime_error("StreamBuffer::map(): the previous write was not "
+                                 "finished using unmap()!");
+    if (alignment == 0)
+        alignment = 1;
+
+    size_t start = (m_head + alignment - 1) / alignment * alignment;
+    if (start + size > (m_segment + 1) * m_frame_size)
+        throw std::runtime_error(
+            "StreamBuffer::map(): out of space for this frame (requested " +
+            std::to_string(size) + " bytes, " + std::to_string(m_frame_size - used()) +
+            " remain)!");
+
+    offset = start;
+    m_head = start + size;
+    m_map_offset = start;
+    m_map_size = size;
+    m_mapped = true;
+
+    if (m_persistent)
+        return m_persistent + start;
+
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+    /* The fence of this segment was waited on by next_frame(), hence no
+       further synchronization is needed */
+    CHK(glBindBuffer(GL_ARRAY_BUFFER, m_buffer_handle));
+    void *ptr = glMapBufferRange(GL_ARRAY_BUFFER, (GLintptr) start, (GLsizeiptr) size,
+                                 GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT |
+                                 GL_MAP_INVALIDATE_RANGE_BIT);
+    CHK(glBindBuffer(GL_ARRAY_BUFFER, 0));
+    if (!ptr) {
+        m_mapped = false;
+        throw std::runtime_error("StreamBuffer::map(): could not map the buffer!");
+    }
+    return (uint8_t *) ptr;
+#else
+    if (m_staging.size() < size)
+        m_staging.resize(size);
+    return m_staging.data();
+#endif
+}
+
+void StreamBuffer::unmap() {
+    if (!m_mapped)
+        throw std::runtime_error("StreamBuffer::unmap(): no write in progress!");
+    m_mapped = false;
+
+    if (m_persistent)
+        return;
+
+    CHK(glBindBuffer(GL_ARRAY_BUFFER, m_buffer_handle));
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+    CHK(glUnmapBuffer(GL_ARRAY_BUFFER));
+#else
+    CHK(glBufferSubData(GL_ARRAY_BUFFER, (GLintptr) m_map_offset,
+                        (GLsizeiptr) m_map_size, m_staging.data()));
+#endif
+    CHK(glBindBuffer(GL_ARRAY_BUFFER, 0));
+}
+
+size_t StreamBuffer::write(const void *data, size_t size, size_t alignment) {
+    size_t offset;
+    uint8_t *ptr = map(size, offset, alignment);
+    memcpy(ptr, data, size);
+    unmap();
+    return offset;
+}
+
+void StreamBuffer::next_frame() {
+    if (m_mapped)
+        throw std::runtime_error("StreamBuffer::next_frame(): the previous write was not "
+                                 "finished using unmap()!");
+
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+    if (m_fences[m_segment])
+        CHK(glDeleteSync((GLsync) m_fences[m_segment]));
+    m_fences[m_segment] = (void *) glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#endif
+
+    m_segment = (m_segment + 1) % SegmentCount;
+    m_head = m_segment * m_frame_size;
+    wait_segment(m_segment);
+}
+
+void StreamBuffer::wait_segment(size_t segment) {
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+    GLsync fence = (GLsync) m_fences[segment];
+    if (!fence)
+        return;
+
+    // Flush, since the wait never returns if the fence was not submitted to the GPU
+    while (true) {
+        GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+        if (result != GL_TIMEOUT_EXPIRED)
+            break;
+    }
+
+    CHK(glDeleteSync(fence));
+    m_fences[segment] = nullptr;
+#else
+    /* glBufferSubData() lets the driver resolve hazards with pending draw
+       calls, hence there is nothing to wait for */
+    (void) segment;
+#endif
+}
+
+NAMESPACE_END(nanogui)
@@ -1,9 +1,350 @@
 #include <nanogui/texture.h>
+#include <nanogui/screen.h>
+#include <nanogui/mipmap.h>
 #include <stb_image.h>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <deque>
+#include <algorithm>
+#include <map>
+#include <fstream>
+#include <cstring>
 
 NAMESPACE_BEGIN(nanogui)
 
+extern std::map<GLFWwindow *, Screen *> __nanogui_screens;
+
+/// Pool of worker threads that decode images for \ref Texture::load_async()
+struct TextureLoader {
+    std::mutex mutex;
+    /// Signaled when jobs are added or decoded bytes are released
+    std::condition_variable cond;
+    std::deque<std::function<void()>> jobs;
+    size_t limit = 256 * 1024 * 1024;
+    size_t in_flight = 0;
+    bool started = false;
+
+    void enqueue(std::function<void()> &&job) {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (!started) {
+            unsigned int count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+            for (unsigned int i = 0; i < std::min(count, 4u); ++i)
+                std::thread([this]() { run(); }).detach();
+            started = true;
+        }
+        jobs.push_back(std::move(job));
+        cond.notify_all();
+    }
+
+    /// Wait until 'bytes' more decoded data fit into the limit, then claim them
+    void reserve(size_t bytes) {
+        std::unique_lock<std::mutex> guard(mutex);
+        cond.wait(guard, [&]() { return in_flight == 0 || in_flight + bytes <= limit; });
+        in_flight += bytes;
+    }
+
+    void release(size_t bytes) {
+        std::lock_guard<std::mutex> guard(mutex);
+        in_flight -= bytes;
+        cond.notify_all();
+    }
+
+    void run() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> guard(mutex);
+                cond.wait(guard, [&]() { return !jobs.empty(); });
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            job();
+        }
+    }
+};
+
+/* Intentionally leaked: the detached workers may outlive static destructors */
+static TextureLoader *texture_loader = new TextureLoader();
+
+/// Pixel data and mip chain of an image file
+struct TextureImage {
+    Texture::PixelFormat pixel_format = Texture::PixelFormat::RGBA;
+    Vector2i size { 0, 0 };
+    std::vector<std::vector<uint8_t>> levels;
+};
+
+/// Return the block dimensions and bytes per block of a pixel format with 8 bit components
+static void texture_format_block(Texture::PixelFormat pixel_format,
+                                 Vector2i &block_size, size_t &block_bytes) {
+    using PixelFormat = Texture::PixelFormat;
+    block_size = Vector2i(4, 4);
+    switch (pixel_format) {
+        case PixelFormat::ETC2_RGB:
+        case PixelFormat::BC1_RGBA:
+            block_bytes = 8;
+            break;
+
+        case PixelFormat::ETC2_RGBA:
+        case PixelFormat::ASTC_4x4_RGBA:
+        case PixelFormat::BC3_RGBA:
+        case PixelFormat::BC7_RGBA:
+            block_bytes = 16;
+            break;
+
+        case PixelFormat::R:    block_size = Vector2i(1, 1); block_bytes = 1; break;
+        case PixelFormat::RA:   block_size = Vector2i(1, 1); block_bytes = 2; break;
+        case PixelFormat::RGB:  block_size = Vector2i(1, 1); block_bytes = 3; break;
+        case PixelFormat::RGBA: block_size = Vector2i(1, 1); block_bytes = 4; break;
+
+        default:
+            throw std::runtime_error("texture_format_block(): unsupported pixel format!");
+    }
+}
+
+static size_t texture_image_level_size(Texture::PixelFormat pixel_format, const Vector2i &size) {
+    Vector2i block_size;
+    size_t block_bytes;
+    texture_format_block(pixel_format, block_size, block_bytes);
+    return (size_t) ((size.x() + block_size.x() - 1) / block_size.x()) *
+           (size_t) ((size.y() + block_size.y() - 1) / block_size.y()) * block_bytes;
+}
+
+static Vector2i texture_mip_size(const Vector2i &size, uint32_t level) {
+    return Vector2i(std::max(1, size.x() >> level), std::max(1, size.y() >> level));
+}
+
+static const uint8_t ktx1_identifier[12] = {
+    0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'
+};
+
+static const uint8_t ktx2_identifier[12] = {
+    0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'
+};
+
+/// Check the signature of a KTX or KTX2 container
+static bool texture_is_ktx(const std::string &filename) {
+    uint8_t identifier[12];
+    std::ifstream is(filename, std::ios::binary);
+    if (!is.read((char *) identifier, sizeof(identifier)))
+        return false;
+    return memcmp(identifier, ktx1_identifier, 12) == 0 ||
+           memcmp(identifier, ktx2_identifier, 12) == 0;
+}
+
+/// Load a 2D image along with its mip chain from a KTX or KTX2 container
+static void texture_load_ktx(const std::string &filename, TextureImage &image) {
+    using PixelFormat = Texture::PixelFormat;
+
+    std::ifstream is(filename, std::ios::binary | std::ios::ate);
+    if (!is)
+        throw std::runtime_error("Could not load texture data from file \"" + filename + "\".");
+    std::vector<uint8_t> file((size_t) is.tellg());
+    is.seekg(0);
+    if (!is.read((char *) file.data(), (std::streamsize) file.size()))
+        throw std::runtime_error("Could not load texture data from file \"" + filename + "\".");
+
+    auto fail = [&](const char *reason) {
+        throw std::runtime_error("Texture::Texture(): invalid KTX file \"" + filename +
+                                 "\": " + reason + "!");
+    };
+
+    auto read_u32 = [&](size_t offset) {
+        uint32_t value;
+        if (offset > file.size() || sizeof(uint32_t) > file.size() - offset)
+            fail("truncated header");
+        memcpy(&value, file.data() + offset, sizeof(uint32_t));
+        return value;
+    };
+
+    auto read_u64 = [&](size_t offset) {
+        uint64_t value;
+        if (offset > file.size() || sizeof(uint64_t) > file.size() - offset)
+            fail("truncated header");
+        memcpy(&value, file.data() + offset, sizeof(uint64_t));
+        return value;
+    };
+
+    uint32_t level_count;
+
+    /* Validate the header before the level sizes are computed. The size
+       limit keeps these computations from overflowing. */
+    auto check_size = [&]() {
+        if (image.size.x() <= 0 || image.size.y() <= 0 ||
+            image.size.x() > 65536 || image.size.y() > 65536)
+            fail("invalid image size");
+        uint32_t max_levels = 1;
+        for (int s = std::max(image.size.x(), image.size.y()); s > 1; s >>= 1)
+            max_levels++;
+        if (level_count > max_levels)
+            fail("too many mip levels");
+    };
+
+    if (file.size() >= 12 && memcmp(file.data(), ktx1_identifier, 12) == 0) {
+        if (read_u32(12) != 0x04030201)
+            fail("only little endian files are supported");
+
+        uint32_t gl_type             = read_u32(16),
+                 gl_format           = read_u32(24),
+                 gl_internal_format  = read_u32(28),
+                 pixel_depth         = read_u32(44),
+                 array_elements      = read_u32(48),
+                 faces               = read_u32(52),
+                 kv_bytes            = read_u32(60);
+
+        image.size = Vector2i((int) read_u32(36), (int) read_u32(40));
+        level_count = std::max(read_u32(56), 1u);
+
+        if (pixel_depth > 1 || array_elements > 0 || faces != 1)
+            fail("only 2D textures are supported");
+        check_size();
+
+        switch (gl_internal_format) {
+            case 0x9274: image.pixel_format = PixelFormat::ETC2_RGB;      break;
+            case 0x9278: image.pixel_format = PixelFormat::ETC2_RGBA;     break;
+            case 0x93B0: image.pixel_format = PixelFormat::ASTC_4x4_RGBA; break;
+            case 0x83F0:
+            case 0x83F1: image.pixel_format = PixelFormat::BC1_RGBA;      break;
+            case 0x83F3: image.pixel_format = PixelFormat::BC3_RGBA;      break;
+            case 0x8E8C: image.pixel_format = PixelFormat::BC7_RGBA;      break;
+            default:
+                if (gl_type != 0x1401 /* GL_UNSIGNED_BYTE */)
+                    fail("unsupported format");
+                switch (gl_format) {
+                    case 0x1903: /* GL_RED */
+                    case 0x1909: /* GL_LUMINANCE */
+                        image.pixel_format = PixelFormat::R; break;
+                    case 0x8227: /* GL_RG */
+                    case 0x190A: /* GL_LUMINANCE_ALPHA */
+                        image.pixel_format = PixelFormat::RA; break;
+                    case 0x1907: /* GL_RGB */
+                        image.pixel_format = PixelFormat::RGB; break;
+                    case 0x1908: /* GL_RGBA */
+                        image.pixel_format = PixelFormat::RGBA; break;
+                    default:
+                        fail("unsupported format");
+                }
+        }
+
+        bool uncompressed = gl_type != 0;
+        size_t offset = 64 + (size_t) kv_bytes;
+        for (uint32_t i = 0; i < level_count; ++i) {
+            Vector2i size = texture_mip_size(image.size, i);
+            size_t image_size = read_u32(offset),
+                   level_size = texture_image_level_size(image.pixel_format, size);
+            offset += 4;
+            if (offset > file.size() || image_size > file.size() - offset)
+                fail("truncated image data");
+
+            /* Rows of uncompressed KTX 1 images are padded to 4 bytes */
+            size_t row_bytes = level_size / (size_t) size.y(),
+                   row_pitch = (row_bytes + 3) & ~(size_t) 3;
+            if (uncompressed ? image_size < row_pitch * (size_t) (size.y() - 1) + row_bytes
+                             : image_size != level_size)
+                fail("invalid image size");
+
+            // Only allocate once the data is known to be present in the file
+            std::vector<uint8_t> level(level_size);
+            if (uncompressed) {
+                for (int y = 0; y < size.y(); ++y)
+                    memcpy(level.data() + y * row_bytes,
+                           file.data() + offset + y * row_pitch, row_bytes);
+            } else {
+                memcpy(level.data(), file.data() + offset, level_size);
+            }
+            image.levels.push_back(std::move(level));
+            offset += (image_size + 3) & ~(size_t) 3;
+        }
+    } else if (file.size() >= 12 && memcmp(file.data(), ktx2_identifier, 12) == 0) {
+        uint32_t vk_format      = read_u32(12),
+                 pixel_depth    = read_u32(28),
+                 layers         = read_u32(32),
+                 faces          = read_u32(36),
+                 supercompression = read_u32(44);
+
+        image.size = Vector2i((int) read_u32(20), (int) read_u32(24));
+        level_count = std::max(read_u32(40), 1u);
+
+        if (pixel_depth > 1 || layers > 0 || faces != 1)
+            fail("only 2D textures are supported");
+        check_size();
+        if (supercompression != 0)
+            fail("supercompression is not supported");
+
+        switch (vk_format) {
+            case 9:   image.pixel_format = PixelFormat::R;             break;
+            case 16:  image.pixel_format = PixelFormat::RA;            break;
+            case 23:  image.pixel_format = PixelFormat::RGB;           break;
+            case 37:  image.pixel_format = PixelFormat::RGBA;          break;
+            case 131:
+            case 133: image.pixel_format = PixelFormat::BC1_RGBA;      break;
+            case 137: image.pixel_format = PixelFormat::BC3_RGBA;      break;
+            case 145: image.pixel_format = PixelFormat::BC7_RGBA;      break;
+            case 147: image.pixel_format = PixelFormat::ETC2_RGB;      break;
+            case 151: image.pixel_format = PixelFormat::ETC2_RGBA;     break;
+            case 157: image.pixel_format = PixelFormat::ASTC_4x4_RGBA; break;
+            default:
+                fail("unsupported format");
+        }
+
+        for (uint32_t i = 0; i < level_count; ++i) {
+            size_t entry = 80 + (size_t) i * 24;
+            uint64_t offset = read_u64(entry),
+                     length = read_u64(entry + 8);
+            size_t level_size =
+                texture_image_level_size(image.pixel_format, texture_mip_size(image.size, i));
+            if (length != level_size)
+                fail("invalid image size");
+            if (offset > file.size() || length > file.size() - offset)
+                fail("truncated image data");
+            image.levels.emplace_back(file.data() + offset, file.data() + offset + length);
+        }
+    } else {
+        fail("unrecognized signature");
+    }
+}
+
+/// Load an image file (KTX/KTX2 containers or any format supported by stb-image)
+static void texture_load_image(const std::string &filename, TextureImage &image) {
+    if (texture_is_ktx(filename)) {
+        texture_load_ktx(filename, image);
+        return;
+    }
+
+    int n = 0;
+    using Holder = std::unique_ptr<uint8_t[], void(*)(void*)>;
+    Holder texture_data(stbi_load(filename.c_str(), &image.size.x(), &image.size.y(), &n, 0),
+                        stbi_image_free);
+    if (!texture_data)
+        throw std::runtime_error("Could not load texture data from file \"" + filename + "\".");
+
+    switch (n) {
+        case 1: image.pixel_format = Texture::PixelFormat::R;    break;
+        case 2: image.pixel_format = Texture::PixelFormat::RA;   break;
+        case 3: image.pixel_format = Texture::PixelFormat::RGB;  break;
+        case 4: image.pixel_format = Texture::PixelFormat::RGBA; break;
+        default:
+            throw std::runtime_error("Texture::Texture(): unsupported channel count!");
+    }
+
+    size_t size = (size_t) image.size.x() * (size_t) image.size.y() * (size_t) n;
+    image.levels.emplace_back(texture_data.get(), texture_data.get() + size);
+}
+
+/// Estimate the amount of memory needed to load an image file (zero if it cannot be read)
+static size_t texture_image_bytes(const std::string &filename) {
+    if (texture_is_ktx(filename)) {
+        std::ifstream is(filename, std::ios::binary | std::ios::ate);
+        return is ? (size_t) is.tellg() : 0;
+    }
+
+    int w = 0, h = 0, n = 0;
+    if (!stbi_info(filename.c_str(), &w, &h, &n))
+        return 0;
+    return (size_t) w * (size_t) h * (size_t) n;
+}
+
 Texture::Texture(PixelFormat pixel_format,
                  ComponentFormat component_format,
                  const Vector2i &size,
@@ -23,6 +364,16 @@ Texture::Texture(PixelFormat pixel_format,
       m_size(size),
       m_mipmap_manual(mipmap_manual) {
 
+    if (compressed() && ((m_flags & (uint8_t) TextureFlags::RenderTarget) || m_samples > 1))
+        throw std::runtime_error("Texture::Texture(): block-compressed formats require "
+                                 "ShaderRead-only textures with samples=1!");
+
+#if !defined(NANOGUI_USE_GLES)
+    if (m_flags & (uint8_t) TextureFlags::ImplicitResolve)
+        throw std::runtime_error("Texture::Texture(): the ImplicitResolve flag "
+                                 "is only supported on GLES!");
+#endif
+
     init();
 }
 
@@ -37,29 +388,110 @@ Texture::Texture(const std::string &filename,
       m_samples(1),
       m_flags(TextureFlags::ShaderRead),
       m_mipmap_manual(false) {
-    int n = 0;
-    using Holder = std::unique_ptr<uint8_t[], void(*)(void*)>;
-    Holder texture_data(stbi_load(filename.c_str(), &m_size.x(), &m_size.y(), &n, 0),
-                        stbi_image_free);
-    if (!texture_data)
-        throw std::runtime_error("Could not load texture data from file \"" + filename + "\".");
+    TextureImage image;
+    texture_load_image(filename, image);
+
+    m_pixel_format = image.pixel_format;
+    m_size = image.size;
+    m_mipmap_manual = image.levels.size() > 1;
 
-    switch (n) {
-        case 1: m_pixel_format = PixelFormat::R;    break;
-        case 2: m_pixel_format = PixelFormat::RA;   break;
-        case 3: m_pixel_format = PixelFormat::RGB;  break;
-        case 4: m_pixel_format = PixelFormat::RGBA; break;
-        default:
-            throw std::runtime_error("Texture::Texture(): unsupported channel count!");
-    }
-    PixelFormat pixel_format = m_pixel_format;
     init();
-    if (m_pixel_format != pixel_format)
+    if (m_pixel_format != image.pixel_format)
         throw std::runtime_error("Texture::Texture(): pixel format not supported by the hardware!");
-    upload((const uint8_t *) texture_data.get());
+
+    upload(image.levels[0].data());
+    for (uint32_t i = 1; i < (uint32_t) image.levels.size(); ++i)
+        upload_mip_level(i, image.levels[i].data());
+}
+
+ref<Texture> Texture::load_async(const std::string &filename,
+                                 const std::function<void(Texture *, const std::string &)> &callback,
+                                 InterpolationMode min_interpolation_mode,
+                                 InterpolationMode mag_interpolation_mode,
+                                 WrapMode wrap_mode) {
+    ref<Texture> texture = new Texture(PixelFormat::RGBA, ComponentFormat::UInt8, Vector2i(1, 1),
+                                       min_interpolation_mode, mag_interpolation_mode, wrap_mode);
+    uint8_t placeholder[4] = { 0, 0, 0, 0 };
+    texture->upload(placeholder);
+
+    /* The reference is dropped on the main thread, since the destructor
+       must not release GPU resources from a worker thread */
+    Texture *texture_ptr = texture.get();
+    texture_ptr->inc_ref();
+
+    texture_loader->enqueue([texture_ptr, filename, callback]() {
+        std::shared_ptr<TextureImage> image;
+        std::string error;
+
+        size_t bytes = texture_image_bytes(filename);
+        if (bytes == 0) {
+            error = "Could not load texture data from file \"" + filename + "\".";
+        } else {
+            texture_loader->reserve(bytes);
+            try {
+                image = std::make_shared<TextureImage>();
+                texture_load_image(filename, *image);
+            } catch (const std::exception &e) {
+                image.reset();
+                error = e.what();
+            }
+        }
+
+        async([texture_ptr, callback, image, bytes, error]() {
+            std::string message = error;
+            if (image) {
+                Texture *t = texture_ptr;
+                PixelFormat placeholder_format = t->m_pixel_format;
+                t->m_pixel_format = image->pixel_format;
+                t->m_mipmap_manual = image->levels.size() > 1;
+                t->m_size = Vector2i(0);
+                t->resize(image->size);
+
+                if (t->m_pixel_format == image->pixel_format) {
+                    t->upload(image->levels[0].data());
+                    for (uint32_t i = 1; i < (uint32_t) image->levels.size(); ++i)
+                        t->upload_mip_level(i, image->levels[i].data());
+                } else {
+                    message = "Texture::load_async(): pixel format not supported by the hardware!";
+                    t->m_pixel_format = placeholder_format;
+                    t->m_mipmap_manual = false;
+                    t->resize(Vector2i(1, 1));
+                    uint8_t placeholder[4] = { 0, 0, 0, 0 };
+                    t->upload(placeholder);
+                }
+            }
+
+            if (bytes)
+                texture_loader->release(bytes);
+
+            for (auto kv : __nanogui_screens)
+                kv.second->redraw();
+
+            if (callback)
+                callback(texture_ptr, message);
+            texture_ptr->dec_ref();
+        });
+    });
+
+    return texture;
+}
+
+void Texture::set_load_limit(size_t bytes) {
+    std::lock_guard<std::mutex> guard(texture_loader->mutex);
+    texture_loader->limit = bytes;
+    texture_loader->cond.notify_all();
+}
+
+size_t Texture::load_limit() {
+    std::lock_guard<std::mutex> guard(texture_loader->mutex);
+    return texture_loader->limit;
 }
 
 size_t Texture::bytes_per_pixel() const {
+    if (compressed())
+        throw std::runtime_error("Texture::bytes_per_pixel(): undefined for "
+                                 "block-compressed formats!");
+
     size_t result = 0;
     switch (m_component_format) {
         case ComponentFormat::UInt8:   result = 1; break;
@@ -88,10 +520,129 @@ size_t Texture::channels() const {
         case PixelFormat::BGRA:         result = 4;  break;
         case PixelFormat::Depth:        result = 1;  break;
         case PixelFormat::DepthStencil: result = 2;  break;
+        case PixelFormat::ETC2_RGB:     result = 3;  break;
+        case PixelFormat::ETC2_RGBA:
+        case PixelFormat::ASTC_4x4_RGBA:
+        case PixelFormat::BC1_RGBA:
+        case PixelFormat::BC3_RGBA:
+        case PixelFormat::BC7_RGBA:     result = 4;  break;
         default: throw std::runtime_error("Texture::channels(): invalid "
                                           "pixel format!");
     }
     return result;
 }
 
+bool Texture::compressed() const {
+    switch (m_pixel_format) {
+        case PixelFormat::ETC2_RGB:
+        case PixelFormat::ETC2_RGBA:
+        case PixelFormat::ASTC_4x4_RGBA:
+        case PixelFormat::BC1_RGBA:
+        case PixelFormat::BC3_RGBA:
+        case PixelFormat::BC7_RGBA:
+            return true;
+        default:
+            return false;
+    }
+}
+
+Vector2i Texture::block_size() const {
+    return compressed() ? Vector2i(4, 4) : Vector2i(1, 1);
+}
+
+size_t Texture::data_size(const Vector2i &size) const {
+    if (!compressed())
+        return bytes_per_pixel() * (size_t) size.x() * (size_t) size.y();
+    return texture_image_level_size(m_pixel_format, size);
+}
+
+void Texture::set_mipmap_filter(MipmapFilter filter, bool srgb) {
+    if (filter != MipmapFilter::GPU) {
+        if (compressed() || m_pixel_format == PixelFormat::Depth ||
+            m_pixel_format == PixelFormat::DepthStencil)
+            throw std::runtime_error("Texture::set_mipmap_filter(): CPU filters require "
+                                     "an uncompressed color format!");
+        if (m_component_format != ComponentFormat::UInt8 &&
+            m_component_format != ComponentFormat::UInt16 &&
+            m_component_format != ComponentFormat::Float16 &&
+            m_component_format != ComponentFormat::Float32)
+            throw std::runtime_error("Texture::set_mipmap_filter(): CPU filters require "
+                                     "UInt8, UInt16, Float16, or Float32 components!");
+    }
+
+    m_mipmap_filter = filter;
+    m_mipmap_srgb = srgb;
+    m_mipmap_levels.clear();
+}
+
+void Texture::update_mipmap(const uint8_t *data, const Vector2i &origin,
+                            const Vector2i &size, size_t row_pitch) {
+    if (m_mipmap_filter == MipmapFilter::GPU || m_samples > 1) {
+        m_mipmap_levels.clear();
+        generate_mipmap();
+        return;
+    }
+
+    if (size.x() <= 0 || size.y() <= 0)
+        return;
+
+    size_t bpp = bytes_per_pixel();
+    uint32_t level_count = mipmap_level_count(m_size);
+    bool full = origin == Vector2i(0) && size == m_size;
+
+    if (m_mipmap_levels.size() != level_count ||
+        m_mipmap_levels[0].size() != data_size(m_size)) {
+        /* Without a CPU copy of level 0, the rest of it would have to be read
+           back from the GPU. Let the GPU compute the mip map instead until
+           the next full upload */
+        if (!full) {
+            m_mipmap_levels.clear();
+            generate_mipmap();
+            return;
+        }
+
+        m_mipmap_levels.resize(level_count);
+        for (uint32_t i = 0; i < level_count; ++i)
+            m_mipmap_levels[i].resize(data_size(mipmap_level_size(m_size, i)));
+    }
+
+    std::vector<uint8_t> &level0 = m_mipmap_levels[0];
+    for (int y = 0; y < size.y(); ++y) {
+        uint8_t *dst = level0.data() + ((size_t) (origin.y() + y) * m_size.x() + origin.x()) * bpp;
+        if (data)
+            memcpy(dst, data + y * row_pitch, bpp * size.x());
+        else
+            memset(dst, 0, bpp * size.x());
+    }
+
+    /* Floor division of possibly negative integers by two */
+    auto div2 = [](int value) { return value >= 0 ? value / 2 : -((1 - value) / 2); };
+
+    // Dirty region of the current level as [lo, hi] and the filter radius (in source pixels)
+    Vector2i lo = origin, hi = origin + size - Vector2i(1);
+    int radius = m_mipmap_filter == MipmapFilter::Box ? 1 : 3;
+
+    for (uint32_t i = 1; i < level_count; ++i) {
+        Vector2i src_size = mipmap_level_size(m_size, i - 1),
+                 dst_size = mipmap_level_size(m_size, i);
+
+        for (int k = 0; k < 2; ++k) {
+            lo[k] = std::max(0, -div2(radius - lo[k]));
+            hi[k] = std::min(dst_size[k] - 1, div2(hi[k] + radius - 1));
+        }
+
+        Vector2i region_size = hi - lo + Vector2i(1);
+        mipmap_downsample(m_mipmap_levels[i - 1].data(), src_size, m_mipmap_levels[i].data(),
+                          lo, region_size, channels(), (VariableType) m_component_format,
+                          m_mipmap_filter, m_mipmap_srgb);
+
+        if (full)
+            upload_mip_level(i, m_mipmap_levels[i].data());
+        else
+            upload_mip_sub_region(i, m_mipmap_levels[i].data() +
+                                         ((size_t) lo.y() * dst_size.x() + lo.x()) * bpp,
+                                  lo, region_size, bpp * dst_size.x());
+    }
+}
+
 NAMESPACE_END(nanogui)
@@ -1,7 +1,12 @@
 #include <nanogui/texture.h>
 #include <nanogui/opengl.h>
+#include <nanogui/glstate.h>
 #include "opengl_check.h"
+#include "opengl_ext.h"
 #include <memory>
+#include <algorithm>
+#include <list>
+#include <map>
 
 #if !defined(GL_HALF_FLOAT)
 #  define GL_HALF_FLOAT 0x140B
@@ -48,6 +53,24 @@
 #  define GL_DEPTH_COMPONENT32F 0x8CAC
 #endif
 
+#if !defined(GL_COMPRESSED_RGB8_ETC2)
+#  define GL_COMPRESSED_RGB8_ETC2 0x9274
+#  define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+#if !defined(GL_COMPRESSED_RGBA_ASTC_4x4_KHR)
+#  define GL_COMPRESSED_RGBA_ASTC_4x4_KHR 0x93B0
+#endif
+#if !defined(GL_COMPRESSED_RGBA_S3TC_DXT1_EXT)
+#  define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#  define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#if !defined(GL_COMPRESSED_RGBA_BPTC_UNORM)
+#  define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+#if !defined(GL_TEXTURE_MAX_LEVEL)
+#  define GL_TEXTURE_MAX_LEVEL 0x813D
+#endif
+
 // NOTE: Add to support GL_TEXTURE_2D_MULTISAMPLE
 #if !defined(GL_TEXTURE_2D_MULTISAMPLE)
 #define GL_TEXTURE_2D_MULTISAMPLE 0x9100
@@ -56,17 +79,128 @@
 
 NAMESPACE_BEGIN(nanogui)
 
+extern std::map<GLFWwindow *, Screen *> __nanogui_screens;
+
 static void gl_map_texture_format(Texture::PixelFormat &pixel_format,
                                   Texture::ComponentFormat &component_format,
                                   GLenum &pixel_format_gl,
                                   GLenum &component_format_gl,
                                   GLenum &internal_format_gl);
 
+/// Idle texture and render buffer storage awaiting reuse
+struct TexturePool {
+    struct Key {
+        GLFWwindow *context;
+        Texture::PixelFormat pixel_format;
+        Texture::ComponentFormat component_format;
+        uint8_t samples;
+        uint8_t flags;
+        Vector2i size;
+
+        bool operator==(const Key &k) const {
+            return context == k.context && pixel_format == k.pixel_format &&
+                   component_format == k.component_format &&
+                   samples == k.samples && flags == k.flags && size == k.size;
+        }
+    };
+
+    struct Entry {
+        Key key;
+        GLuint handle;
+        size_t bytes;
+    };
+
+    /// Most recently released entries come first
+    std::list<Entry> entries;
+    size_t limit = 128 * 1024 * 1024;
+    Texture::PoolStats stats;
+
+    static void free(const Entry &entry) {
+        if (entry.key.flags & (uint8_t) Texture::TextureFlags::ShaderRead) {
+            GLState::current().texture_deleted(entry.handle);
+            CHK(glDeleteTextures(1, &entry.handle));
+        } else {
+            CHK(glDeleteRenderbuffers(1, &entry.handle));
+        }
+    }
+
+    /// Free least recently released entries of the current context until within 'limit'
+    void trim(size_t limit) {
+        GLFWwindow *context = glfwGetCurrentContext();
+        for (auto it = entries.end(); it != entries.begin() && stats.bytes > limit; ) {
+            --it;
+            if (it->key.context != context)
+                continue;
+            free(*it);
+            stats.bytes -= it->bytes;
+            stats.entries--;
+            stats.evictions++;
+            it = entries.erase(it);
+        }
+    }
+};
+
+/// Not synchronized, only the rendering thread may create or destroy textures
+static TexturePool texture_pool;
+
+/* Render buffers are never sampled, hence their storage can exceed the
+   logical size of the texture. Round it up so that interactive resizing
+   (e.g. of a Canvas) does not reallocate on every frame. Sampled textures
+   keep their exact size, which OpenGL and GLES 3 allow to be mixed with
+   larger render buffers in a framebuffer. GLES 2 requires all attachments
+   to have the same size, hence nothing is rounded there. */
+static Vector2i texture_pool_storage_size(const Vector2i &size, uint8_t flags) {
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+    (void) flags;
+    return size;
+#else
+    if (flags & (uint8_t) Texture::TextureFlags::ShaderRead)
+        return size;
+#endif
+    const int granularity = 128;
+    return Vector2i((size.x() + granularity - 1) / granularity * granularity,
+                    (size.y() + granularity - 1) / granularity * granularity);
+}
+
+/* Textures with the ImplicitResolve flag only hold multiple samples in tile
+   memory, their storage is single-sampled */
+static uint8_t storage_samples(uint8_t samples, uint8_t flags) {
+    return (flags & (uint8_t) Texture::TextureFlags::ImplicitResolve) ? 1 : samples;
+}
+
+static GLenum texture_target(uint8_t samples, uint8_t flags) {
+    return storage_samples(samples, flags) > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+}
+
+bool Texture::implicit_resolve_supported() {
+#if defined(NANOGUI_USE_GLES)
+    return gl_multisampled_render_to_texture() != nullptr;
+#else
+    return false;
+#endif
+}
+
 void Texture::init() {
 #if defined(NANOGUI_USE_GLES)
-    m_samples = 1;
+    if (m_flags & (uint8_t) TextureFlags::ImplicitResolve) {
+        if (!implicit_resolve_supported())
+            throw std::runtime_error("Texture::Texture(): the ImplicitResolve flag requires "
+                                     "EXT_multisampled_render_to_texture!");
+    } else if (NANOGUI_GLES_VERSION == 2 || (m_flags & (uint8_t) TextureFlags::ShaderRead)) {
+        /* GLES 3 supports multisampled render buffers, which can be
+           resolved using RenderPass::blit_to() */
+        m_samples = 1;
+    }
 #endif
 
+    if (!(m_flags & ((uint8_t) TextureFlags::ShaderRead | (uint8_t) TextureFlags::RenderTarget)))
+        throw std::runtime_error(
+            "Texture::Texture(): flags must either specify ShaderRead, RenderTarget, or both!");
+
+    acquire_storage();
+}
+
+void Texture::acquire_storage() {
     GLuint interpolation_mode_gl[2];
     for (int i = 0; i<2; ++i) {
         switch (i == 0 ? m_min_interpolation_mode : m_mag_interpolation_mode) {
@@ -107,41 +241,112 @@ void Texture::init() {
 
     (void) pixel_format_gl; (void) component_format_gl;
 
-    GLenum tex_mode = m_samples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
+    m_context = glfwGetCurrentContext();
+    Vector2i storage_size = texture_pool_storage_size(m_size, m_flags);
+    TexturePool::Key key { m_context, m_pixel_format, m_component_format,
+                           m_samples, m_flags, storage_size };
+
+    GLuint handle = 0;
+    for (auto it = texture_pool.entries.begin(); it != texture_pool.entries.end(); ++it) {
+        if (it->key == key) {
+            handle = it->handle;
+            texture_pool.stats.bytes -= it->bytes;
+            texture_pool.stats.entries--;
+            texture_pool.entries.erase(it);
+            break;
+        }
+    }
+
+    if (handle)
+        texture_pool.stats.hits++;
+    else
+        texture_pool.stats.misses++;
+
+    GLenum tex_mode = texture_target(m_samples, m_flags);
 
     if (m_flags & (uint8_t) TextureFlags::ShaderRead) {
-        CHK(glGenTextures(1, &m_texture_handle));
-        CHK(glBindTexture(tex_mode, m_texture_handle));
+        if (handle)
+            m_texture_handle = handle;
+        else
+            CHK(glGenTextures(1, &m_texture_handle));
+        GLState::current().bind_texture(0, tex_mode, m_texture_handle);
         CHK(glTexParameteri(tex_mode, GL_TEXTURE_MIN_FILTER, interpolation_mode_gl[0]));
         CHK(glTexParameteri(tex_mode, GL_TEXTURE_MAG_FILTER, interpolation_mode_gl[1]));
         CHK(glTexParameteri(tex_mode, GL_TEXTURE_WRAP_S, wrap_mode_gl));
         CHK(glTexParameteri(tex_mode, GL_TEXTURE_WRAP_T, wrap_mode_gl));
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+        if (handle && storage_samples(m_samples, m_flags) == 1)
+            CHK(glTexParameteri(tex_mode, GL_TEXTURE_MAX_LEVEL, 1000));
+#endif
 
-        if (m_flags & (uint8_t) TextureFlags::RenderTarget)
+        if (!handle && (m_flags & (uint8_t) TextureFlags::RenderTarget))
             upload(nullptr);
-    } else if (m_flags & (uint8_t) TextureFlags::RenderTarget) {
+    } else if (handle) {
+        m_renderbuffer_handle = handle;
+    } else {
         CHK(glGenRenderbuffers(1, &m_renderbuffer_handle));
-        CHK(glBindRenderbuffer(GL_RENDERBUFFER, m_renderbuffer_handle));
-#if defined(NANOGUI_USE_OPENGL)
-        if (m_samples == 1)
-            CHK(glRenderbufferStorage(GL_RENDERBUFFER, internal_format_gl,
-                                      (GLsizei) m_size.x(), (GLsizei) m_size.y()));
-        else
-            CHK(glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_samples, internal_format_gl,
-                                                 (GLsizei) m_size.x(), (GLsizei) m_size.y()));
-#else
-        CHK(glRenderbufferStorage(GL_RENDERBUFFER, internal_format_gl,
-                                  (GLsizei) m_size.x(), (GLsizei) m_size.y()));
-#endif
+        upload(nullptr);
+    }
+}
+
+void Texture::release_storage() {
+    GLuint handle = m_texture_handle ? m_texture_handle : m_renderbuffer_handle;
+    if (!handle)
+        return;
+
+    /* Only pool storage of contexts that belong to a live Screen, whose
+       destructor releases the idle entries again */
+    bool pooled = texture_pool.limit > 0 && m_context != nullptr &&
+                  m_context == glfwGetCurrentContext() &&
+                  __nanogui_screens.find(m_context) != __nanogui_screens.end();
+
+    if (pooled) {
+        Vector2i storage_size = texture_pool_storage_size(m_size, m_flags);
+        size_t bytes = data_size(storage_size) * storage_samples(m_samples, m_flags);
+        TexturePool::Key key { m_context, m_pixel_format, m_component_format,
+                               m_samples, m_flags, storage_size };
+        texture_pool.entries.push_front(TexturePool::Entry{ key, handle, bytes });
+        texture_pool.stats.bytes += bytes;
+        texture_pool.stats.entries++;
+        texture_pool.trim(texture_pool.limit);
+    } else if (m_texture_handle) {
+        GLState::current().texture_deleted(m_texture_handle);
+        CHK(glDeleteTextures(1, &m_texture_handle));
     } else {
-        throw std::runtime_error(
-            "Texture::Texture(): flags must either specify ShaderRead, RenderTarget, or both!");
+        CHK(glDeleteRenderbuffers(1, &m_renderbuffer_handle));
     }
+
+    m_texture_handle = m_renderbuffer_handle = 0;
+}
+
+void Texture::set_pool_limit(size_t bytes) {
+    texture_pool.limit = bytes;
+    texture_pool.trim(bytes);
+}
+
+size_t Texture::pool_limit() {
+    return texture_pool.limit;
+}
+
+Texture::PoolStats Texture::pool_stats() {
+    return texture_pool.stats;
+}
+
+void Texture::clear_pool() {
+    texture_pool.trim(0);
 }
 
 Texture::~Texture() {
-    CHK(glDeleteTextures(1, &m_texture_handle));
-    CHK(glDeleteRenderbuffers(1, &m_renderbuffer_handle));
+    release_storage();
+
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+    for (PixelBuffer &pb : m_pixel_buffers) {
+        if (pb.fence)
+            CHK(glDeleteSync((GLsync) pb.fence));
+        if (pb.handle)
+            CHK(glDeleteBuffers(1, &pb.handle));
+    }
+#endif
 }
 
 void Texture::upload(const uint8_t *data) {
@@ -158,9 +363,17 @@ void Texture::upload(const uint8_t *data) {
                           component_format_gl,
                           internal_format_gl);
 
-    if (m_texture_handle != 0) {
-        GLenum tex_mode = m_samples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
-        CHK(glBindTexture(tex_mode, m_texture_handle));
+    if (m_texture_handle != 0 && compressed()) {
+        GLState::current().bind_texture(0, GL_TEXTURE_2D, m_texture_handle);
+        CHK(glCompressedTexImage2D(GL_TEXTURE_2D, 0, internal_format_gl, (GLsizei) m_size.x(),
+                                   (GLsizei) m_size.y(), 0, (GLsizei) data_size(m_size), data));
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+        // Only level 0 is present until upload_mip_level() provides more
+        CHK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
+#endif
+    } else if (m_texture_handle != 0) {
+        GLenum tex_mode = texture_target(m_samples, m_flags);
+        GLState::current().bind_texture(0, tex_mode, m_texture_handle);
 
         if (data)
             CHK(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
@@ -185,24 +398,104 @@ void Texture::upload(const uint8_t *data) {
 
         if (!m_mipmap_manual && (m_min_interpolation_mode == InterpolationMode::Trilinear ||
             m_mag_interpolation_mode == InterpolationMode::Trilinear))
-            generate_mipmap();
+            update_mipmap(data, Vector2i(0), m_size, bytes_per_pixel() * m_size.x());
     } else {
-#if defined(NANOGUI_USE_OPENGL)
+        Vector2i storage_size = texture_pool_storage_size(m_size, m_flags);
         CHK(glBindRenderbuffer(GL_RENDERBUFFER, m_renderbuffer_handle));
+#if defined(NANOGUI_USE_OPENGL)
         if (m_samples == 1)
             CHK(glRenderbufferStorage(GL_RENDERBUFFER, internal_format_gl,
-                                      (GLsizei) m_size.x(), (GLsizei) m_size.y()));
+                                      (GLsizei) storage_size.x(), (GLsizei) storage_size.y()));
         else
             CHK(glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_samples, internal_format_gl,
-                                                 (GLsizei) m_size.x(), (GLsizei) m_size.y()));
+                                                 (GLsizei) storage_size.x(), (GLsizei) storage_size.y()));
 #else
-        CHK(glRenderbufferStorage(GL_RENDERBUFFER, internal_format_gl,
-                                  (GLsizei) m_size.x(), (GLsizei) m_size.y()));
+        if (m_samples == 1)
+            CHK(glRenderbufferStorage(GL_RENDERBUFFER, internal_format_gl,
+                                      (GLsizei) storage_size.x(), (GLsizei) storage_size.y()));
+        else if (m_flags & (uint8_t) TextureFlags::ImplicitResolve)
+            CHK(gl_multisampled_render_to_texture()->renderbuffer_storage_multisample(
+                GL_RENDERBUFFER, m_samples, internal_format_gl,
+                (GLsizei) storage_size.x(), (GLsizei) storage_size.y()));
+#  if NANOGUI_GLES_VERSION == 3
+        else
+            CHK(glRenderbufferStorageMultisample(GL_RENDERBUFFER, m_samples, internal_format_gl,
+                                                 (GLsizei) storage_size.x(), (GLsizei) storage_size.y()));
+#  endif
 #endif
     }
 }
 
+void Texture::upload_mip_level(uint32_t level, const uint8_t *data) {
+    if (m_texture_handle == 0 || m_samples > 1)
+        throw std::runtime_error("Texture::upload_mip_level(): only implemented for "
+                                 "sampled textures with samples=1!");
+
+    GLenum pixel_format_gl,
+           component_format_gl,
+           internal_format_gl;
+
+    gl_map_texture_format(m_pixel_format,
+                          m_component_format,
+                          pixel_format_gl,
+                          component_format_gl,
+                          internal_format_gl);
+
+    Vector2i size(std::max(1, m_size.x() >> level), std::max(1, m_size.y() >> level));
+
+    GLState::current().bind_texture(0, GL_TEXTURE_2D, m_texture_handle);
+    if (compressed()) {
+        CHK(glCompressedTexImage2D(GL_TEXTURE_2D, (GLint) level, internal_format_gl,
+                                   (GLsizei) size.x(), (GLsizei) size.y(), 0,
+                                   (GLsizei) data_size(size), data));
+    } else {
+        CHK(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+        CHK(glTexImage2D(GL_TEXTURE_2D, (GLint) level, internal_format_gl, (GLsizei) size.x(),
+                         (GLsizei) size.y(), 0, pixel_format_gl, component_format_gl, data));
+    }
+
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+    CHK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint) level));
+#endif
+}
+
+void Texture::upload_mip_sub_region(uint32_t level, const uint8_t *data, const Vector2i &origin,
+                                    const Vector2i &size, size_t row_pitch) {
+    GLenum pixel_format_gl,
+           component_format_gl,
+           internal_format_gl;
+
+    gl_map_texture_format(m_pixel_format,
+                          m_component_format,
+                          pixel_format_gl,
+                          component_format_gl,
+                          internal_format_gl);
+
+    GLState::current().bind_texture(0, GL_TEXTURE_2D, m_texture_handle);
+    CHK(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+    for (int y = 0; y < size.y(); ++y)
+        CHK(glTexSubImage2D(GL_TEXTURE_2D, (GLint) level, (GLsizei) origin.x(),
+                            (GLsizei) (origin.y() + y), (GLsizei) size.x(), 1, pixel_format_gl,
+                            component_format_gl, data + y * row_pitch));
+#else
+    CHK(glPixelStorei(GL_UNPACK_ROW_LENGTH, (GLint) (row_pitch / bytes_per_pixel())));
+    CHK(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
+    CHK(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
+    CHK(glTexSubImage2D(GL_TEXTURE_2D, (GLint) level, (GLsizei) origin.x(), (GLsizei) origin.y(),
+                        (GLsizei) size.x(), (GLsizei) size.y(), pixel_format_gl,
+                        component_format_gl, data));
+    CHK(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+#endif
+}
+
 void Texture::upload_sub_region(const uint8_t *data, const Vector2i& origin, const Vector2i& size) {
+    upload_sub_region(data, origin, size, bytes_per_pixel() * size.x());
+}
+
+void Texture::upload_sub_region(const uint8_t *data, const Vector2i& origin, const Vector2i& size,
+                                size_t row_pitch, const Vector2i& src_origin) {
     if (m_samples > 1 && data != nullptr)
         throw std::runtime_error("Texture::upload_sub_region(): only implemented for samples=1!");
 
@@ -222,37 +515,247 @@ void Texture::upload_sub_region(const uint8_t *data, const Vector2i& origin, con
     if (origin.x() + size.x() > m_size.x() || origin.y() + size.y() > m_size.y())
         throw std::runtime_error("Texture::upload_sub_region(): out of bounds!");
 
-    GLenum tex_mode = m_samples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
-    CHK(glBindTexture(tex_mode, m_texture_handle));
+    size_t bpp = bytes_per_pixel(),
+           row_bytes = bpp * size.x();
+
+    if (row_pitch < row_bytes + bpp * src_origin.x())
+        throw std::runtime_error("Texture::upload_sub_region(): row pitch is too small!");
+
+    // First pixel of the region, for the CPU copy of the mip map
+    const uint8_t *region =
+        data ? data + src_origin.y() * row_pitch + src_origin.x() * bpp : nullptr;
+
+    GLenum tex_mode = texture_target(m_samples, m_flags);
+    GLState::current().bind_texture(0, tex_mode, m_texture_handle);
 
     if (data)
         CHK(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
 
-#if defined(NANOGUI_USE_OPENGL)
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+    /* No GL_UNPACK_ROW_LENGTH: upload tightly packed sources in one go,
+       and everything else one row at a time */
+    if (data)
+        data += src_origin.y() * row_pitch + src_origin.x() * bpp;
+
+    if (!data || row_pitch == row_bytes) {
+        CHK(glTexSubImage2D(tex_mode, 0, (GLsizei) origin.x(), (GLsizei) origin.y(),
+                            (GLsizei) size.x(), (GLsizei) size.y(), pixel_format_gl,
+                            component_format_gl, data));
+    } else {
+        for (int y = 0; y < size.y(); ++y)
+            CHK(glTexSubImage2D(tex_mode, 0, (GLsizei) origin.x(), (GLsizei) (origin.y() + y),
+                                (GLsizei) size.x(), 1, pixel_format_gl, component_format_gl,
+                                data + y * row_pitch));
+    }
+#else
+    bool strided = row_pitch % bpp == 0;
+
     if (data) {
+        CHK(glPixelStorei(GL_UNPACK_ROW_LENGTH, strided ? (GLint) (row_pitch / bpp) : 0));
+        CHK(glPixelStorei(GL_UNPACK_SKIP_ROWS, strided ? src_origin.y() : 0));
+        CHK(glPixelStorei(GL_UNPACK_SKIP_PIXELS, strided ? src_origin.x() : 0));
+    }
+
+    if (!data || strided) {
+        CHK(glTexSubImage2D(tex_mode, 0, (GLsizei) origin.x(), (GLsizei) origin.y(),
+                            (GLsizei) size.x(), (GLsizei) size.y(), pixel_format_gl,
+                            component_format_gl, data));
+    } else {
+        /* The row pitch is not a whole number of pixels */
+        data += src_origin.y() * row_pitch + src_origin.x() * bpp;
+        for (int y = 0; y < size.y(); ++y)
+            CHK(glTexSubImage2D(tex_mode, 0, (GLsizei) origin.x(), (GLsizei) (origin.y() + y),
+                                (GLsizei) size.x(), 1, pixel_format_gl, component_format_gl,
+                                data + y * row_pitch));
+    }
+
+    if (data && strided) {
         CHK(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
         CHK(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
         CHK(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
     }
 #endif
 
-    CHK(glTexSubImage2D(tex_mode, 0, (GLsizei) origin.x(), (GLsizei) origin.y(), (GLsizei) size.x(),
-                        (GLsizei) size.y(), pixel_format_gl, component_format_gl, data));
+    if (!m_mipmap_manual && (m_min_interpolation_mode == InterpolationMode::Trilinear ||
+        m_mag_interpolation_mode == InterpolationMode::Trilinear))
+        update_mipmap(region, origin, size, row_pitch);
+}
+
+void Texture::upload_async(const uint8_t *data) {
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+    upload(data);
+#else
+    if (m_samples > 1 || m_texture_handle == 0 || data == nullptr) {
+        upload(data);
+        return;
+    }
+
+    GLenum pixel_format_gl,
+           component_format_gl,
+           internal_format_gl;
+
+    gl_map_texture_format(m_pixel_format,
+                          m_component_format,
+                          pixel_format_gl,
+                          component_format_gl,
+                          internal_format_gl);
+
+    stage_pixel_buffer(data, data_size(m_size));
+
+    GLState::current().bind_texture(0, GL_TEXTURE_2D, m_texture_handle);
+    if (compressed()) {
+        CHK(glCompressedTexImage2D(GL_TEXTURE_2D, 0, internal_format_gl, (GLsizei) m_size.x(),
+                                   (GLsizei) m_size.y(), 0, (GLsizei) data_size(m_size), nullptr));
+        CHK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
+        release_pixel_buffer();
+        return;
+    }
+
+    CHK(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+    CHK(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+    CHK(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
+    CHK(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
+    CHK(glTexImage2D(GL_TEXTURE_2D, 0, internal_format_gl, (GLsizei) m_size.x(),
+                     (GLsizei) m_size.y(), 0, pixel_format_gl, component_format_gl, nullptr));
+
+    release_pixel_buffer();
+
+    if (!m_mipmap_manual && (m_min_interpolation_mode == InterpolationMode::Trilinear ||
+        m_mag_interpolation_mode == InterpolationMode::Trilinear))
+        update_mipmap(data, Vector2i(0), m_size, bytes_per_pixel() * m_size.x());
+#endif
+}
+
+void Texture::upload_sub_region_async(const uint8_t *data, const Vector2i& origin,
+                                      const Vector2i& size) {
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+    upload_sub_region(data, origin, size);
+#else
+    if (m_samples > 1 || data == nullptr) {
+        upload_sub_region(data, origin, size);
+        return;
+    }
+
+    GLenum pixel_format_gl,
+           component_format_gl,
+           internal_format_gl;
+
+    gl_map_texture_format(m_pixel_format,
+                          m_component_format,
+                          pixel_format_gl,
+                          component_format_gl,
+                          internal_format_gl);
+
+    if (m_texture_handle == 0)
+        throw std::runtime_error("Texture::upload_sub_region_async(): not implemented for render targets!");
+
+    if (origin.x() + size.x() > m_size.x() || origin.y() + size.y() > m_size.y())
+        throw std::runtime_error("Texture::upload_sub_region_async(): out of bounds!");
+
+    stage_pixel_buffer(data, bytes_per_pixel() * size.x() * size.y());
+
+    GLState::current().bind_texture(0, GL_TEXTURE_2D, m_texture_handle);
+    CHK(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+    CHK(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+    CHK(glPixelStorei(GL_UNPACK_SKIP_ROWS, 0));
+    CHK(glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0));
+    CHK(glTexSubImage2D(GL_TEXTURE_2D, 0, (GLsizei) origin.x(), (GLsizei) origin.y(),
+                        (GLsizei) size.x(), (GLsizei) size.y(), pixel_format_gl,
+                        component_format_gl, nullptr));
+
+    release_pixel_buffer();
 
     if (!m_mipmap_manual && (m_min_interpolation_mode == InterpolationMode::Trilinear ||
         m_mag_interpolation_mode == InterpolationMode::Trilinear))
-        generate_mipmap();
+        update_mipmap(data, origin, size, bytes_per_pixel() * size.x());
+#endif
+}
+
+bool Texture::upload_finished() {
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+    for (PixelBuffer &pb : m_pixel_buffers) {
+        if (!pb.fence)
+            continue;
+        GLenum rv = glClientWaitSync((GLsync) pb.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (rv == GL_TIMEOUT_EXPIRED)
+            return false;
+        CHK(glDeleteSync((GLsync) pb.fence));
+        pb.fence = nullptr;
+    }
+#endif
+    return true;
+}
+
+void Texture::stage_pixel_buffer(const uint8_t *data, size_t size) {
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+    (void) data; (void) size;
+    throw std::runtime_error("Texture::stage_pixel_buffer(): not supported on GLES 2!");
+#else
+    PixelBuffer &pb = m_pixel_buffers[m_pixel_buffer_index];
+
+    if (pb.handle == 0)
+        CHK(glGenBuffers(1, &pb.handle));
+    CHK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pb.handle));
+
+    /* Is the GPU still reading from the previous contents of this buffer? */
+    bool busy = false;
+    if (pb.fence) {
+        busy = glClientWaitSync((GLsync) pb.fence, 0, 0) == GL_TIMEOUT_EXPIRED;
+        CHK(glDeleteSync((GLsync) pb.fence));
+        pb.fence = nullptr;
+    }
+
+    GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+    if (busy || pb.size < size) {
+        /* Orphan the old storage instead of waiting for the GPU to release it */
+        pb.size = std::max(pb.size, size);
+        CHK(glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr) pb.size, nullptr,
+                         GL_STREAM_DRAW));
+    } else {
+        access |= GL_MAP_UNSYNCHRONIZED_BIT;
+    }
+
+    void *ptr = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr) size, access);
+    if (!ptr) {
+        CHK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+        throw std::runtime_error("Texture::stage_pixel_buffer(): could not map pixel buffer!");
+    }
+    memcpy(ptr, data, size);
+    CHK(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+#endif
+}
+
+void Texture::release_pixel_buffer() {
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+    PixelBuffer &pb = m_pixel_buffers[m_pixel_buffer_index];
+    pb.fence = (void *) glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    CHK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+
+    m_pixel_buffer_index = (m_pixel_buffer_index + 1) %
+        (uint32_t) (sizeof(m_pixel_buffers) / sizeof(PixelBuffer));
+#endif
 }
 
 void Texture::download(uint8_t *data) {
-#if defined(NANOGUI_USE_GLES)
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
     (void) data;
     throw std::runtime_error("Texture::download(): not supported on GLES 2!");
 #else
-    if (m_texture_handle == 0)
-        throw std::runtime_error("Texture::download(): no texture handle!");
+    download_async()->read(data);
+#endif
+}
+
+ref<TextureReadback> Texture::download_async() {
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+    throw std::runtime_error("Texture::download_async(): not supported on GLES 2!");
+#else
+    if (m_texture_handle == 0 && m_renderbuffer_handle == 0)
+        throw std::runtime_error("Texture::download_async(): no texture handle!");
     else if (m_samples > 1)
-        throw std::runtime_error("Texture::download(): only implemented for samples=1!");
+        throw std::runtime_error("Texture::download_async(): only implemented for samples=1!");
+    else if (compressed())
+        throw std::runtime_error("Texture::download_async(): not supported for "
+                                 "block-compressed formats!");
 
     GLenum pixel_format_gl,
            component_format_gl,
@@ -265,35 +768,209 @@ void Texture::download(uint8_t *data) {
                           internal_format_gl);
 
     (void) internal_format_gl;
-    CHK(glBindTexture(GL_TEXTURE_2D, m_texture_handle));
-    CHK(glGetTexImage(GL_TEXTURE_2D, 0, pixel_format_gl, component_format_gl, data));
 
-    if (m_flags & (uint8_t) TextureFlags::RenderTarget) {
-        size_t stride = bytes_per_pixel() * m_size.x();
-        std::unique_ptr<uint8_t[]> temp(new uint8_t[stride]);
+    ref<TextureReadback> rb = new TextureReadback();
+    rb->m_size = m_size;
+    rb->m_channels = channels();
+    rb->m_dtype = (VariableType) m_component_format;
+    rb->m_bytes_per_pixel = bytes_per_pixel();
+    rb->m_buffer_bytes_per_pixel = rb->m_bytes_per_pixel;
+    rb->m_flip = m_flags & (uint8_t) TextureFlags::RenderTarget;
+
+    GLenum attachment_id = GL_COLOR_ATTACHMENT0;
+    if (m_pixel_format == PixelFormat::Depth)
+        attachment_id = GL_DEPTH_ATTACHMENT;
+    else if (m_pixel_format == PixelFormat::DepthStencil)
+        attachment_id = GL_DEPTH_STENCIL_ATTACHMENT;
 
-        uint8_t *low = (uint8_t *) data,
-                *high = low + (m_size.y() - 1) * stride;
+#if defined(NANOGUI_USE_GLES)
+    if (attachment_id != GL_COLOR_ATTACHMENT0)
+        throw std::runtime_error("Texture::download_async(): depth readback is not supported on GLES!");
+    if (m_pixel_format == PixelFormat::R || m_pixel_format == PixelFormat::RA)
+        throw std::runtime_error("Texture::download_async(): R and RA textures use luminance "
+                                 "formats on GLES, which cannot be attached to a framebuffer!");
+#endif
 
-        for (; low < high; low += stride, high -= stride) {
-            memcpy(temp.get(), low, stride);
-            memcpy(low, high, stride);
-            memcpy(high, temp.get(), stride);
+    /* Restore the caller's read framebuffer afterwards (e.g. the source of a
+       blit in progress), which also keeps the state tracker accurate */
+    GLint prev_read_framebuffer = 0;
+    CHK(glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &prev_read_framebuffer));
+
+    GLuint framebuffer_handle = 0;
+    CHK(glGenFramebuffers(1, &framebuffer_handle));
+    CHK(glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer_handle));
+    if (m_texture_handle)
+        CHK(glFramebufferTexture2D(GL_READ_FRAMEBUFFER, attachment_id, GL_TEXTURE_2D,
+                                   m_texture_handle, 0));
+    else
+        CHK(glFramebufferRenderbuffer(GL_READ_FRAMEBUFFER, attachment_id, GL_RENDERBUFFER,
+                                      m_renderbuffer_handle));
+    CHK(glReadBuffer(attachment_id == GL_COLOR_ATTACHMENT0 ? GL_COLOR_ATTACHMENT0 : GL_NONE));
+
+    bool complete = glCheckFramebufferStatus(GL_READ_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    const char *error = complete ? nullptr : "texture format cannot be attached to a "
+                                             "framebuffer for readback";
+
+#if defined(NANOGUI_USE_GLES)
+    if (complete) {
+        /* GLES only guarantees glReadPixels() support for RGBA data of type
+           GL_UNSIGNED_BYTE (normalized formats) or GL_FLOAT (floating point
+           formats), plus one format/type pair chosen by the implementation.
+           Surplus channels are dropped while copying out of the buffer. */
+        GLint read_format = 0, read_type = 0;
+        CHK(glGetIntegerv(GL_IMPLEMENTATION_COLOR_READ_FORMAT, &read_format));
+        CHK(glGetIntegerv(GL_IMPLEMENTATION_COLOR_READ_TYPE, &read_type));
+
+        bool guaranteed =
+            (m_component_format == ComponentFormat::UInt8 && component_format_gl == GL_UNSIGNED_BYTE) ||
+            (m_component_format == ComponentFormat::Float32 && component_format_gl == GL_FLOAT);
+
+        if ((GLenum) read_format == pixel_format_gl && (GLenum) read_type == component_format_gl) {
+            // The implementation reads the texture's own layout
+        } else if (guaranteed || ((GLenum) read_format == GL_RGBA &&
+                                  (GLenum) read_type == component_format_gl)) {
+            pixel_format_gl = GL_RGBA;
+            rb->m_buffer_bytes_per_pixel = rb->m_bytes_per_pixel / channels() * 4;
+        } else {
+            complete = false;
+            error = "the GLES implementation cannot read back this component format";
         }
     }
 #endif
+
+#if defined(NANOGUI_USE_OPENGL)
+    /* Formats that are not color-renderable can still be fetched directly */
+    bool fetch_texture = !complete && m_texture_handle;
+#else
+    bool fetch_texture = false;
+#endif
+
+    if (complete || fetch_texture) {
+        size_t size = rb->m_buffer_bytes_per_pixel * m_size.x() * m_size.y();
+        CHK(glGenBuffers(1, &rb->m_buffer_handle));
+        CHK(glBindBuffer(GL_PIXEL_PACK_BUFFER, rb->m_buffer_handle));
+        CHK(glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr) size, nullptr, GL_STREAM_READ));
+        CHK(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+    }
+
+    if (complete) {
+        CHK(glReadPixels(0, 0, (GLsizei) m_size.x(), (GLsizei) m_size.y(),
+                         pixel_format_gl, component_format_gl, nullptr));
+    }
+#if defined(NANOGUI_USE_OPENGL)
+    else if (fetch_texture) {
+        GLState::current().bind_texture(0, GL_TEXTURE_2D, m_texture_handle);
+        CHK(glGetTexImage(GL_TEXTURE_2D, 0, pixel_format_gl, component_format_gl, nullptr));
+        complete = true;
+    }
+#endif
+    rb->m_fence = (void *) glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    CHK(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+    CHK(glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint) prev_read_framebuffer));
+    CHK(glDeleteFramebuffers(1, &framebuffer_handle));
+
+    if (!complete)
+        throw std::runtime_error(std::string("Texture::download_async(): ") + error + "!");
+
+    return rb;
+#endif
+}
+
+TextureReadback::~TextureReadback() {
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+    if (m_fence)
+        CHK(glDeleteSync((GLsync) m_fence));
+    CHK(glDeleteBuffers(1, &m_buffer_handle));
+#endif
+}
+
+bool TextureReadback::ready() {
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+    if (m_fence) {
+        GLenum rv = glClientWaitSync((GLsync) m_fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        if (rv == GL_TIMEOUT_EXPIRED)
+            return false;
+        CHK(glDeleteSync((GLsync) m_fence));
+        m_fence = nullptr;
+    }
+#endif
+    return true;
+}
+
+void TextureReadback::read(uint8_t *data) {
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+    (void) data;
+    throw std::runtime_error("TextureReadback::read(): not supported on GLES 2!");
+#else
+    if (m_fence) {
+        GLenum rv;
+        do {
+            rv = glClientWaitSync((GLsync) m_fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                  1000000000ull);
+        } while (rv == GL_TIMEOUT_EXPIRED);
+        if (rv == GL_WAIT_FAILED)
+            throw std::runtime_error("TextureReadback::read(): waiting for the GPU failed!");
+        CHK(glDeleteSync((GLsync) m_fence));
+        m_fence = nullptr;
+    }
+
+    size_t src_stride = m_buffer_bytes_per_pixel * m_size.x(),
+           dst_stride = m_bytes_per_pixel * m_size.x();
+
+    CHK(glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffer_handle));
+    const uint8_t *src = (const uint8_t *) glMapBufferRange(
+        GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr) (src_stride * m_size.y()), GL_MAP_READ_BIT);
+
+    if (!src) {
+        CHK(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+        throw std::runtime_error("TextureReadback::read(): could not map pixel buffer!");
+    }
+
+    /* Flip the rows of render targets while copying */
+    for (int y = 0; y < m_size.y(); ++y) {
+        const uint8_t *src_row = src + (m_flip ? m_size.y() - 1 - y : y) * src_stride;
+        uint8_t *dst_row = data + y * dst_stride;
+
+        if (m_buffer_bytes_per_pixel == m_bytes_per_pixel) {
+            memcpy(dst_row, src_row, dst_stride);
+        } else {
+            for (int x = 0; x < m_size.x(); ++x)
+                memcpy(dst_row + x * m_bytes_per_pixel,
+                       src_row + x * m_buffer_bytes_per_pixel, m_bytes_per_pixel);
+        }
+    }
+
+    CHK(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+    CHK(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+#endif
 }
 
 void Texture::resize(const Vector2i &size) {
     if (m_size == size)
         return;
-    m_size = size;
-    upload(nullptr);
+
+    if (m_texture_handle && !(m_flags & (uint8_t) TextureFlags::RenderTarget)) {
+        m_size = size;
+        upload(nullptr);
+    } else if (texture_pool_storage_size(size, m_flags) ==
+               texture_pool_storage_size(m_size, m_flags)) {
+        // The current render buffer storage is large enough
+        m_size = size;
+    } else {
+        /* Swap the render target for pooled storage of the new size, which
+           changes its handle (\ref RenderPass::resize() re-attaches it).
+           Storage released while the size changes back and forth (e.g.
+           when a window is maximized and restored) is then reused */
+        release_storage();
+        m_size = size;
+        acquire_storage();
+    }
 }
 
 void Texture::generate_mipmap() {
-    GLenum tex_mode = m_samples > 1 ? GL_TEXTURE_2D_MULTISAMPLE : GL_TEXTURE_2D;
-    CHK(glBindTexture(tex_mode, m_texture_handle));
+    GLenum tex_mode = texture_target(m_samples, m_flags);
+    GLState::current().bind_texture(0, tex_mode, m_texture_handle);
     CHK(glGenerateMipmap(tex_mode));
 }
 
@@ -439,6 +1116,29 @@ static void gl_map_texture_format(Texture::PixelFormat &pixel_format,
             }
             break;
 
+        case PixelFormat::ETC2_RGB:
+        case PixelFormat::ETC2_RGBA:
+        case PixelFormat::ASTC_4x4_RGBA:
+        case PixelFormat::BC1_RGBA:
+        case PixelFormat::BC3_RGBA:
+        case PixelFormat::BC7_RGBA:
+            /* Block-compressed formats are uploaded as is. Whether they are
+               supported depends on the implementation (e.g. ETC2 is part of
+               GLES 3, while ASTC and BC require extensions there) */
+            component_format = ComponentFormat::UInt8;
+            pixel_format_gl = pixel_format == PixelFormat::ETC2_RGB ? GL_RGB : GL_RGBA;
+
+            switch (pixel_format) {
+                case PixelFormat::ETC2_RGB:      internal_format_gl = GL_COMPRESSED_RGB8_ETC2;          break;
+                case PixelFormat::ETC2_RGBA:     internal_format_gl = GL_COMPRESSED_RGBA8_ETC2_EAC;     break;
+                case PixelFormat::ASTC_4x4_RGBA: internal_format_gl = GL_COMPRESSED_RGBA_ASTC_4x4_KHR;  break;
+                case PixelFormat::BC1_RGBA:      internal_format_gl = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT; break;
+                case PixelFormat::BC3_RGBA:      internal_format_gl = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; break;
+                case PixelFormat::BC7_RGBA:      internal_format_gl = GL_COMPRESSED_RGBA_BPTC_UNORM;    break;
+                default: break;
+            }
+            break;
+
         default:
             break;
     }
@@ -1,6 +1,7 @@
 #include <nanogui/texture.h>
 #include <nanogui/metal.h>
 #import <Metal/Metal.h>
+#include <algorithm>
 
 NAMESPACE_BEGIN(nanogui)
 
@@ -65,7 +66,7 @@ void Texture::upload(const uint8_t *data) {
     [temp_texture replaceRegion: MTLRegionMake2D(0, 0, (NSUInteger) m_size.x(), (NSUInteger) m_size.y())
                   mipmapLevel: 0
                   withBytes: data
-                  bytesPerRow: (NSUInteger) (bytes_per_pixel() * m_size.x())];
+                  bytesPerRow: (NSUInteger) data_size(Vector2i(m_size.x(), block_size().y()))];
 
     [command_encoder
                  copyFromTexture: temp_texture
@@ -82,11 +83,100 @@ void Texture::upload(const uint8_t *data) {
     [command_buffer commit];
     [command_buffer waitUntilCompleted];
 
-    if (!m_mipmap_manual && m_min_interpolation_mode == InterpolationMode::Trilinear)
-        generate_mipmap();
+    if (!m_mipmap_manual && !compressed() &&
+        m_min_interpolation_mode == InterpolationMode::Trilinear)
+        update_mipmap(data, Vector2i(0), m_size, bytes_per_pixel() * m_size.x());
+}
+
+void Texture::upload_mip_level(uint32_t level, const uint8_t *data) {
+    id<MTLTexture> texture = (__bridge id<MTLTexture>) m_texture_handle;
+    if (level >= texture.mipmapLevelCount)
+        throw std::runtime_error("Texture::upload_mip_level(): the texture has no such "
+                                 "level (use trilinear interpolation)!");
+
+    Vector2i size(std::max(1, m_size.x() >> level), std::max(1, m_size.y() >> level));
+
+    MTLTextureDescriptor *texture_desc =
+        [MTLTextureDescriptor texture2DDescriptorWithPixelFormat: texture.pixelFormat
+                                                           width: (NSUInteger) size.x()
+                                                          height: (NSUInteger) size.y()
+                                                       mipmapped: NO];
+
+    id<MTLDevice> device = (__bridge id<MTLDevice>) metal_device();
+    id<MTLCommandQueue> command_queue = (__bridge id<MTLCommandQueue>) metal_command_queue();
+    id<MTLCommandBuffer> command_buffer = [command_queue commandBuffer];
+    id<MTLBlitCommandEncoder> command_encoder = [command_buffer blitCommandEncoder];
+    id<MTLTexture> temp_texture = [device newTextureWithDescriptor:texture_desc];
+
+    [temp_texture replaceRegion: MTLRegionMake2D(0, 0, (NSUInteger) size.x(), (NSUInteger) size.y())
+                  mipmapLevel: 0
+                  withBytes: data
+                  bytesPerRow: (NSUInteger) data_size(Vector2i(size.x(), block_size().y()))];
+
+    [command_encoder
+                 copyFromTexture: temp_texture
+                     sourceSlice: 0
+                     sourceLevel: 0
+                    sourceOrigin: MTLOriginMake(0, 0, 0)
+                      sourceSize: MTLSizeMake((NSUInteger) size.x(), (NSUInteger) size.y(), 1)
+                       toTexture: texture
+                destinationSlice: 0
+                destinationLevel: level
+               destinationOrigin: MTLOriginMake(0, 0, 0)];
+
+    [command_encoder endEncoding];
+    [command_buffer commit];
+    [command_buffer waitUntilCompleted];
+}
+
+void Texture::upload_mip_sub_region(uint32_t level, const uint8_t *data, const Vector2i &origin,
+                                    const Vector2i &size, size_t row_pitch) {
+    id<MTLTexture> texture = (__bridge id<MTLTexture>) m_texture_handle;
+
+    MTLTextureDescriptor *texture_desc =
+        [MTLTextureDescriptor texture2DDescriptorWithPixelFormat: texture.pixelFormat
+                                                           width: (NSUInteger) size.x()
+                                                          height: (NSUInteger) size.y()
+                                                       mipmapped: NO];
+
+    id<MTLDevice> device = (__bridge id<MTLDevice>) metal_device();
+    id<MTLCommandQueue> command_queue = (__bridge id<MTLCommandQueue>) metal_command_queue();
+    id<MTLCommandBuffer> command_buffer = [command_queue commandBuffer];
+    id<MTLBlitCommandEncoder> command_encoder = [command_buffer blitCommandEncoder];
+    id<MTLTexture> temp_texture = [device newTextureWithDescriptor:texture_desc];
+
+    [temp_texture replaceRegion: MTLRegionMake2D(0, 0, (NSUInteger) size.x(), (NSUInteger) size.y())
+                  mipmapLevel: 0
+                  withBytes: data
+                  bytesPerRow: (NSUInteger) row_pitch];
+
+    [command_encoder
+                 copyFromTexture: temp_texture
+                     sourceSlice: 0
+                     sourceLevel: 0
+                    sourceOrigin: MTLOriginMake(0, 0, 0)
+                      sourceSize: MTLSizeMake((NSUInteger) size.x(), (NSUInteger) size.y(), 1)
+                       toTexture: texture
+                destinationSlice: 0
+                destinationLevel: level
+               destinationOrigin: MTLOriginMake((NSUInteger) origin.x(), (NSUInteger) origin.y(), 0)];
+
+    [command_encoder endEncoding];
+    [command_buffer commit];
+    [command_buffer waitUntilCompleted];
 }
 
 void Texture::upload_sub_region(const uint8_t *data, const Vector2i& origin, const Vector2i& size) {
+    upload_sub_region(data, origin, size, bytes_per_pixel() * size.x());
+}
+
+void Texture::upload_sub_region(const uint8_t *data, const Vector2i& origin, const Vector2i& size,
+                                size_t row_pitch, const Vector2i& src_origin) {
+    if (row_pitch < bytes_per_pixel() * (size.x() + src_origin.x()))
+        throw std::runtime_error("Texture::upload_sub_region(): row pitch is too small!");
+
+    data += src_origin.y() * row_pitch + src_origin.x() * bytes_per_pixel();
+
     id<MTLTexture> texture = (__bridge id<MTLTexture>) m_texture_handle;
 
     MTLTextureDescriptor *texture_desc =
@@ -104,7 +194,7 @@ void Texture::upload_sub_region(const uint8_t *data, const Vector2i& origin, con
     [temp_texture replaceRegion: MTLRegionMake2D(0, 0, (NSUInteger) size.x(), (NSUInteger) size.y())
                   mipmapLevel: 0
                   withBytes: data
-                  bytesPerRow: (NSUInteger) (bytes_per_pixel() * size.x())];
+                  bytesPerRow: (NSUInteger) row_pitch];
 
     [command_encoder
                  copyFromTexture: temp_texture
@@ -122,10 +212,27 @@ void Texture::upload_sub_region(const uint8_t *data, const Vector2i& origin, con
     [command_buffer waitUntilCompleted];
 
     if (!m_mipmap_manual && m_min_interpolation_mode == InterpolationMode::Trilinear)
-        generate_mipmap();
+        update_mipmap(data, origin, size, row_pitch);
+}
+
+void Texture::upload_async(const uint8_t *data) {
+    upload(data);
+}
+
+void Texture::upload_sub_region_async(const uint8_t *data, const Vector2i& origin,
+                                      const Vector2i& size) {
+    upload_sub_region(data, origin, size);
+}
+
+bool Texture::upload_finished() {
+    return true;
 }
 
 void Texture::download(uint8_t *data) {
+    download_async()->read(data);
+}
+
+ref<TextureReadback> Texture::download_async() {
     id<MTLCommandQueue> command_queue =
         (__bridge id<MTLCommandQueue>) metal_command_queue();
     id<MTLCommandBuffer> command_buffer = [command_queue commandBuffer];
@@ -154,8 +261,54 @@ void Texture::download(uint8_t *data) {
 
     [command_encoder endEncoding];
     [command_buffer commit];
+
+    ref<TextureReadback> rb = new TextureReadback();
+    rb->m_size = m_size;
+    rb->m_channels = channels();
+    rb->m_dtype = (VariableType) m_component_format;
+    rb->m_bytes_per_pixel = rb->m_buffer_bytes_per_pixel = bytes_per_pixel();
+    rb->m_buffer = (__bridge_retained void *) buffer;
+    rb->m_command_buffer = (__bridge_retained void *) command_buffer;
+    return rb;
+}
+
+TextureReadback::~TextureReadback() {
+    (void) (__bridge_transfer id<MTLBuffer>) m_buffer;
+    (void) (__bridge_transfer id<MTLCommandBuffer>) m_command_buffer;
+}
+
+bool TextureReadback::ready() {
+    id<MTLCommandBuffer> command_buffer = (__bridge id<MTLCommandBuffer>) m_command_buffer;
+    return command_buffer.status == MTLCommandBufferStatusCompleted;
+}
+
+void TextureReadback::read(uint8_t *data) {
+    id<MTLCommandBuffer> command_buffer = (__bridge id<MTLCommandBuffer>) m_command_buffer;
+    id<MTLBuffer> buffer = (__bridge id<MTLBuffer>) m_buffer;
     [command_buffer waitUntilCompleted];
-    memcpy(data, buffer.contents, img_bytes);
+    memcpy(data, buffer.contents, m_bytes_per_pixel * m_size.x() * m_size.y());
+}
+
+/* Metal manages texture memory on its own (e.g. via heaps), hence the
+   texture pool is only used by the OpenGL backend */
+static size_t texture_pool_limit = 0;
+
+void Texture::set_pool_limit(size_t bytes) {
+    texture_pool_limit = bytes;
+}
+
+size_t Texture::pool_limit() {
+    return texture_pool_limit;
+}
+
+Texture::PoolStats Texture::pool_stats() {
+    return PoolStats();
+}
+
+void Texture::clear_pool() { }
+
+bool Texture::implicit_resolve_supported() {
+    return false;
 }
 
 void Texture::resize(const Vector2i &size) {
@@ -270,6 +423,13 @@ void Texture::resize(const Vector2i &size) {
             }
             break;
 
+        case PixelFormat::ETC2_RGB:      pixel_format_mtl = MTLPixelFormatETC2_RGB8;    break;
+        case PixelFormat::ETC2_RGBA:     pixel_format_mtl = MTLPixelFormatEAC_RGBA8;    break;
+        case PixelFormat::ASTC_4x4_RGBA: pixel_format_mtl = MTLPixelFormatASTC_4x4_LDR; break;
+        case PixelFormat::BC1_RGBA:      pixel_format_mtl = MTLPixelFormatBC1_RGBA;     break;
+        case PixelFormat::BC3_RGBA:      pixel_format_mtl = MTLPixelFormatBC3_RGBA;     break;
+        case PixelFormat::BC7_RGBA:      pixel_format_mtl = MTLPixelFormatBC7_RGBAUnorm; break;
+
         default:
             throw std::runtime_error("Texture::Texture(): invalid pixel format!");
     }
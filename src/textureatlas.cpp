@@ -0,0 +1,359 @@
+/*
+    src/textureatlas.cpp -- Packs many small images into a single texture
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/textureatlas.h>
+#include <nanogui/opengl.h>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#if defined(NANOGUI_USE_OPENGL)
+#  define NANOVG_GL3
+#  include <nanovg_gl.h>
+#elif defined(NANOGUI_USE_GLES)
+#  define NANOVG_GLES2
+#  include <nanovg_gl.h>
+#elif defined(NANOGUI_USE_METAL)
+#  include <nanovg_mtl.h>
+#endif
+
+NAMESPACE_BEGIN(nanogui)
+
+TextureAtlas::TextureAtlas(const Vector2i &size,
+                           PixelFormat pixel_format,
+                           ComponentFormat component_format,
+                           int padding,
+                           InterpolationMode min_interpolation_mode,
+                           InterpolationMode mag_interpolation_mode)
+    : m_padding(padding) {
+    if (size.x() <= 0 || size.y() <= 0 || padding < 0)
+        throw std::runtime_error("TextureAtlas::TextureAtlas(): invalid size or padding!");
+
+    m_texture = new Texture(pixel_format, component_format, size,
+                            min_interpolation_mode, mag_interpolation_mode,
+                            Texture::WrapMode::ClampToEdge);
+    if (m_texture->compressed())
+        throw std::runtime_error("TextureAtlas::TextureAtlas(): block-compressed "
+                                 "formats are not supported!");
+
+    m_bytes_per_pixel = m_texture->bytes_per_pixel();
+    m_pixels.resize(m_bytes_per_pixel * (size_t) size.x() * (size_t) size.y());
+    m_skyline.push_back(SkylineNode{ 0, 0, size.x() });
+    m_texture->upload(m_pixels.data());
+}
+
+TextureAtlas::~TextureAtlas() {
+    for (auto &kv : m_nvg_images)
+        nvgDeleteImage(kv.first, kv.second);
+}
+
+const TextureAtlas::Region &TextureAtlas::region(int id) const {
+    auto it = m_regions.find(id);
+    if (it == m_regions.end())
+        throw std::runtime_error("TextureAtlas: unknown region " + std::to_string(id) + "!");
+    return it->second;
+}
+
+int TextureAtlas::add(const uint8_t *data, const Vector2i &size, size_t row_pitch) {
+    if (size.x() <= 0 || size.y() <= 0)
+        throw std::runtime_error("TextureAtlas::add(): invalid image size!");
+
+    Vector2i padded = size + Vector2i(2 * m_padding);
+    const Vector2i &atlas_size = this->size();
+    if (padded.x() > atlas_size.x() || padded.y() > atlas_size.y())
+        throw std::runtime_error("TextureAtlas::add(): image is larger than the atlas!");
+
+    Vector2i position;
+    bool fits = pack(padded, position), repacked = false;
+    Layout layout;
+
+    if (!fits && m_wasted_area > 0)
+        fits = repacked = relayout(layout, padded, position);
+
+    if (!fits && m_eviction) {
+        size_t total_area = (size_t) atlas_size.x() * (size_t) atlas_size.y(),
+               needed = (size_t) padded.x() * (size_t) padded.y(),
+               live_area = 0;
+
+        std::vector<std::map<int, Region>::iterator> lru;
+        for (auto it = m_regions.begin(); it != m_regions.end(); ++it) {
+            Vector2i region_padded = it->second.size + Vector2i(2 * m_padding);
+            live_area += (size_t) region_padded.x() * (size_t) region_padded.y();
+            lru.push_back(it);
+        }
+        std::sort(lru.begin(), lru.end(),
+                  [](std::map<int, Region>::iterator a, std::map<int, Region>::iterator b) {
+                      return a->second.last_use < b->second.last_use;
+                  });
+
+        /* Evict until a compacted layout has room for the image. Only the
+           layout is recomputed per eviction; pixels move and the texture is
+           uploaded once at the end. Evicted regions are set aside rather
+           than dropped, so that a failed attempt leaves the atlas intact. */
+        std::vector<std::map<int, Region>::node_type> evicted;
+        for (auto it : lru) {
+            Vector2i lru_padded = it->second.size + Vector2i(2 * m_padding);
+            live_area -= (size_t) lru_padded.x() * (size_t) lru_padded.y();
+            evicted.push_back(m_regions.extract(it));
+
+            if (total_area - live_area >= needed &&
+                relayout(layout, padded, position)) {
+                fits = repacked = true;
+                break;
+            }
+        }
+
+        if (fits) {
+            m_evictions += evicted.size();
+        } else {
+            for (auto &node : evicted)
+                m_regions.insert(std::move(node));
+        }
+    }
+
+    if (!fits)
+        return -1;
+
+    if (repacked)
+        move_regions(layout);
+
+    int id = m_next_id++;
+    Region &region = m_regions[id];
+    region.position = position + Vector2i(m_padding);
+    region.size = size;
+    region.last_use = ++m_use_counter;
+
+    blit(region, data, row_pitch);
+    if (repacked)
+        m_texture->upload(m_pixels.data());
+    else
+        upload_region(region);
+    return id;
+}
+
+void TextureAtlas::update(int id, const uint8_t *data, size_t row_pitch) {
+    const Region &region = this->region(id);
+    blit(region, data, row_pitch);
+    upload_region(region);
+}
+
+void TextureAtlas::remove(int id) {
+    Vector2i padded = region(id).size + Vector2i(2 * m_padding);
+    m_wasted_area += (size_t) padded.x() * (size_t) padded.y();
+    m_regions.erase(id);
+}
+
+Vector4f TextureAtlas::uv(int id) {
+    auto it = m_regions.find(id);
+    if (it == m_regions.end())
+        throw std::runtime_error("TextureAtlas::uv(): unknown region " + std::to_string(id) + "!");
+
+    Region &region = it->second;
+    region.last_use = ++m_use_counter;
+
+    Vector2f scale = 1.f / Vector2f(size()),
+             p0 = Vector2f(region.position) * scale,
+             p1 = Vector2f(region.position + region.size) * scale;
+    return Vector4f(p0.x(), p0.y(), p1.x(), p1.y());
+}
+
+float TextureAtlas::occupancy() const {
+    size_t area = 0;
+    for (auto &kv : m_regions) {
+        Vector2i padded = kv.second.size + Vector2i(2 * m_padding);
+        area += (size_t) padded.x() * (size_t) padded.y();
+    }
+    return (float) area / ((float) size().x() * (float) size().y());
+}
+
+bool TextureAtlas::defragment() {
+    Layout layout;
+    if (!relayout(layout))
+        return false;
+    move_regions(layout);
+    m_texture->upload(m_pixels.data());
+    return true;
+}
+
+bool TextureAtlas::relayout(Layout &layout, const Vector2i &extra, Vector2i &extra_position) {
+    // Repack the tallest regions first, which keeps the skyline flat
+    std::vector<std::pair<int, Region *>> order;
+    for (auto &kv : m_regions)
+        order.emplace_back(kv.first, &kv.second);
+    std::sort(order.begin(), order.end(),
+              [](const std::pair<int, Region *> &a, const std::pair<int, Region *> &b) {
+                  if (a.second->size.y() != b.second->size.y())
+                      return a.second->size.y() > b.second->size.y();
+                  if (a.second->size.x() != b.second->size.x())
+                      return a.second->size.x() > b.second->size.x();
+                  return a.first < b.first;
+              });
+
+    std::vector<SkylineNode> skyline = std::move(m_skyline);
+    m_skyline.assign(1, SkylineNode{ 0, 0, size().x() });
+
+    layout.resize(order.size());
+    bool success = true;
+    for (size_t i = 0; i < order.size() && success; ++i) {
+        layout[i].first = order[i].second;
+        success = pack(order[i].second->size + Vector2i(2 * m_padding), layout[i].second);
+    }
+    if (success && extra != Vector2i(0))
+        success = pack(extra, extra_position);
+
+    // Keep the current layout on failure
+    if (!success)
+        m_skyline = std::move(skyline);
+    return success;
+}
+
+bool TextureAtlas::relayout(Layout &layout) {
+    Vector2i unused;
+    return relayout(layout, Vector2i(0), unused);
+}
+
+void TextureAtlas::move_regions(const Layout &layout) {
+    std::vector<uint8_t> pixels(m_pixels.size(), 0);
+    size_t row_pitch = m_bytes_per_pixel * size().x();
+    for (const auto &entry : layout) {
+        Region &region = *entry.first;
+        const Vector2i &dst = entry.second;
+        Vector2i src = region.position - Vector2i(m_padding),
+                 padded = region.size + Vector2i(2 * m_padding);
+        for (int y = 0; y < padded.y(); ++y)
+            memcpy(pixels.data() + (dst.y() + y) * row_pitch + dst.x() * m_bytes_per_pixel,
+                   m_pixels.data() + (src.y() + y) * row_pitch + src.x() * m_bytes_per_pixel,
+                   padded.x() * m_bytes_per_pixel);
+        region.position = dst + Vector2i(m_padding);
+    }
+
+    m_pixels.swap(pixels);
+    m_wasted_area = 0;
+}
+
+int TextureAtlas::nvg_image(NVGcontext *ctx) {
+    auto it = m_nvg_images.find(ctx);
+    if (it != m_nvg_images.end())
+        return it->second;
+
+    if (m_texture->pixel_format() != PixelFormat::RGBA ||
+        m_texture->component_format() != ComponentFormat::UInt8)
+        throw std::runtime_error("TextureAtlas::nvg_image(): NanoVG requires an RGBA atlas "
+                                 "with UInt8 components!");
+
+    const Vector2i &atlas_size = size();
+#if defined(NANOGUI_USE_OPENGL)
+    int image = nvglCreateImageFromHandleGL3(ctx, m_texture->texture_handle(), atlas_size.x(),
+                                             atlas_size.y(), NVG_IMAGE_NODELETE);
+#elif defined(NANOGUI_USE_GLES)
+    int image = nvglCreateImageFromHandleGLES2(ctx, m_texture->texture_handle(), atlas_size.x(),
+                                               atlas_size.y(), NVG_IMAGE_NODELETE);
+#elif defined(NANOGUI_USE_METAL)
+    (void) atlas_size;
+    int image = mnvgCreateImageFromHandle(ctx, m_texture->texture_handle(), 0);
+#endif
+    if (image == 0)
+        throw std::runtime_error("TextureAtlas::nvg_image(): could not create NanoVG image!");
+
+    m_nvg_images[ctx] = image;
+    return image;
+}
+
+bool TextureAtlas::pack(const Vector2i &size, Vector2i &position) {
+    const Vector2i &atlas_size = this->size();
+    int best_index = -1, best_bottom = INT_MAX, best_width = INT_MAX;
+
+    for (size_t i = 0; i < m_skyline.size(); ++i) {
+        // Lowest row at which the rectangle fits when its left edge is at node 'i'
+        int x = m_skyline[i].x, y = 0, remaining = size.x();
+        if (x + size.x() > atlas_size.x())
+            break;
+        size_t j = i;
+        while (remaining > 0) {
+            y = std::max(y, m_skyline[j].y);
+            remaining -= m_skyline[j].width;
+            ++j;
+        }
+        if (y + size.y() > atlas_size.y())
+            continue;
+
+        int bottom = y + size.y();
+        if (bottom < best_bottom || (bottom == best_bottom && m_skyline[i].width < best_width)) {
+            best_index = (int) i;
+            best_bottom = bottom;
+            best_width = m_skyline[i].width;
+            position = Vector2i(x, y);
+        }
+    }
+
+    if (best_index < 0)
+        return false;
+
+    // Raise the skyline over the new rectangle and trim the nodes it covers
+    m_skyline.insert(m_skyline.begin() + best_index,
+                     SkylineNode{ position.x(), position.y() + size.y(), size.x() });
+    for (size_t i = best_index + 1; i < m_skyline.size(); ) {
+        const SkylineNode &prev = m_skyline[i - 1];
+        SkylineNode &node = m_skyline[i];
+        int shrink = prev.x + prev.width - node.x;
+        if (shrink <= 0)
+            break;
+        node.x += shrink;
+        node.width -= shrink;
+        if (node.width > 0)
+            break;
+        m_skyline.erase(m_skyline.begin() + i);
+    }
+
+    // Merge neighboring nodes of the same height
+    for (size_t i = 0; i + 1 < m_skyline.size(); ) {
+        if (m_skyline[i].y == m_skyline[i + 1].y) {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + i + 1);
+        } else {
+            ++i;
+        }
+    }
+
+    return true;
+}
+
+void TextureAtlas::blit(const Region &region, const uint8_t *data, size_t row_pitch) {
+    size_t bpp = m_bytes_per_pixel,
+           atlas_pitch = bpp * size().x(),
+           row_bytes = bpp * region.size.x();
+    if (row_pitch == 0)
+        row_pitch = row_bytes;
+    else if (row_pitch < row_bytes)
+        throw std::runtime_error("TextureAtlas: row pitch is too small!");
+
+    for (int y = -m_padding; y < region.size.y() + m_padding; ++y) {
+        // Replicate the outermost rows and columns into the padding
+        const uint8_t *src = data + std::min(std::max(y, 0), region.size.y() - 1) * row_pitch;
+        uint8_t *dst = m_pixels.data() + (region.position.y() + y) * atlas_pitch +
+                       region.position.x() * bpp;
+
+        memcpy(dst, src, row_bytes);
+        for (int x = 1; x <= m_padding; ++x) {
+            memcpy(dst - x * bpp, src, bpp);
+            memcpy(dst + row_bytes + (x - 1) * bpp, src + row_bytes - bpp, bpp);
+        }
+    }
+}
+
+void TextureAtlas::upload_region(const Region &region) {
+    Vector2i origin = region.position - Vector2i(m_padding),
+             padded = region.size + Vector2i(2 * m_padding);
+    m_texture->upload_sub_region(m_pixels.data(), origin, padded,
+                                 m_bytes_per_pixel * size().x(), origin);
+}
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,192 @@
+/*
+    src/texturecache.cpp -- Shared, size-bounded cache of file-backed
+    textures and NanoVG images
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/texturecache.h>
+#include <nanogui/opengl.h>
+#include <sys/stat.h>
+#include <unordered_map>
+#include <list>
+
+NAMESPACE_BEGIN(nanogui)
+
+struct TextureCacheEntry {
+    std::string key;
+    size_t bytes = 0;
+
+    /// Owning window of file-backed textures
+    GLFWwindow *window = nullptr;
+    ref<Texture> texture;
+
+    /// NanoVG context and image handle of in-memory images
+    NVGcontext *ctx = nullptr;
+    int image = 0;
+};
+
+struct TextureCacheState {
+    /// Most recently requested entries come first
+    std::list<TextureCacheEntry> entries;
+    std::unordered_map<std::string, std::list<TextureCacheEntry>::iterator> index;
+    size_t budget = 256 * 1024 * 1024;
+    TextureCache::Stats stats;
+
+    /// Look up an entry and mark it as most recently used
+    TextureCacheEntry *find(const std::string &key) {
+        auto it = index.find(key);
+        if (it == index.end()) {
+            stats.misses++;
+            return nullptr;
+        }
+        stats.hits++;
+        entries.splice(entries.begin(), entries, it->second);
+        return &entries.front();
+    }
+
+    void insert(TextureCacheEntry &&entry) {
+        stats.bytes += entry.bytes;
+        stats.entries++;
+        entries.push_front(std::move(entry));
+        index[entries.front().key] = entries.begin();
+        trim(1);
+    }
+
+    std::list<TextureCacheEntry>::iterator erase(std::list<TextureCacheEntry>::iterator it) {
+        if (it->image)
+            nvgDeleteImage(it->ctx, it->image);
+        stats.bytes -= it->bytes;
+        stats.entries--;
+        index.erase(it->key);
+        return entries.erase(it);
+    }
+
+    /* Evict least recently used textures (except the first 'keep' entries)
+       until within budget. NanoVG images are never evicted: widgets keep
+       their integer handles (e.g. via nvgImageIcon()), which would then
+       refer to deleted or reused images */
+    void trim(size_t keep) {
+        size_t index = entries.size();
+        for (auto it = entries.end(); it != entries.begin() && stats.bytes > budget; ) {
+            --it;
+            if (--index < keep)
+                break;
+            if (it->image)
+                continue;
+            it = erase(it);
+            stats.evictions++;
+        }
+    }
+};
+
+/* Intentionally leaked: entries must not release GPU resources after the
+   contexts have been torn down */
+static TextureCacheState &texture_cache() {
+    static TextureCacheState *state = new TextureCacheState();
+    return *state;
+}
+
+ref<Texture> TextureCache::texture(const std::string &filename,
+                                   Texture::InterpolationMode min_interpolation_mode,
+                                   Texture::InterpolationMode mag_interpolation_mode,
+                                   Texture::WrapMode wrap_mode) {
+    struct stat st;
+    if (stat(filename.c_str(), &st) != 0)
+        return new Texture(filename, min_interpolation_mode,
+                           mag_interpolation_mode, wrap_mode);
+
+    GLFWwindow *window = glfwGetCurrentContext();
+    std::string key = "texture:" + filename + ":" +
+                      std::to_string((long long) st.st_mtime) + ":" +
+                      std::to_string((int) min_interpolation_mode) + ":" +
+                      std::to_string((int) mag_interpolation_mode) + ":" +
+                      std::to_string((int) wrap_mode) + ":" +
+                      std::to_string((uintptr_t) window);
+
+    TextureCacheState &cache = texture_cache();
+    TextureCacheEntry *entry = cache.find(key);
+    if (entry)
+        return entry->texture;
+
+    ref<Texture> texture = new Texture(filename, min_interpolation_mode,
+                                       mag_interpolation_mode, wrap_mode);
+
+    TextureCacheEntry new_entry;
+    new_entry.key = key;
+    new_entry.window = window;
+    new_entry.texture = texture;
+    new_entry.bytes = texture->data_size(texture->size());
+    if (min_interpolation_mode == Texture::InterpolationMode::Trilinear)
+        new_entry.bytes = new_entry.bytes * 4 / 3;
+    cache.insert(std::move(new_entry));
+
+    return texture;
+}
+
+int TextureCache::nvg_image(NVGcontext *ctx, const std::string &name,
+                            const uint8_t *data, uint32_t size) {
+    std::string key = "nvg:" + name + ":" + std::to_string((uintptr_t) ctx);
+
+    TextureCacheState &cache = texture_cache();
+    TextureCacheEntry *entry = cache.find(key);
+    if (entry)
+        return entry->image;
+
+    int image = nvgCreateImageMem(ctx, 0, (unsigned char *) data, (int) size);
+    if (image == 0)
+        throw std::runtime_error("Unable to load resource data.");
+
+    int w = 0, h = 0;
+    nvgImageSize(ctx, image, &w, &h);
+
+    TextureCacheEntry new_entry;
+    new_entry.key = key;
+    new_entry.ctx = ctx;
+    new_entry.image = image;
+    new_entry.bytes = 4 * (size_t) w * (size_t) h;
+    cache.insert(std::move(new_entry));
+
+    return image;
+}
+
+void TextureCache::set_budget(size_t bytes) {
+    TextureCacheState &cache = texture_cache();
+    cache.budget = bytes;
+    cache.trim(0);
+}
+
+size_t TextureCache::budget() {
+    return texture_cache().budget;
+}
+
+TextureCache::Stats TextureCache::stats() {
+    return texture_cache().stats;
+}
+
+void TextureCache::clear() {
+    TextureCacheState &cache = texture_cache();
+    for (auto it = cache.entries.begin(); it != cache.entries.end(); ) {
+        if (it->image)
+            ++it;
+        else
+            it = cache.erase(it);
+    }
+}
+
+void TextureCache::release(GLFWwindow *window, NVGcontext *ctx) {
+    TextureCacheState &cache = texture_cache();
+    for (auto it = cache.entries.begin(); it != cache.entries.end(); ) {
+        if ((it->texture && it->window == window) || (it->image && it->ctx == ctx))
+            it = cache.erase(it);
+        else
+            ++it;
+    }
+}
+
+NAMESPACE_END(nanogui)
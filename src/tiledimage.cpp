@@ -0,0 +1,328 @@
+/*
+    src/tiledimage.cpp -- Multi-resolution image that is paged into a
+    fixed-size GPU tile cache
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include <nanogui/tiledimage.h>
+#include <nanogui/screen.h>
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+NAMESPACE_BEGIN(nanogui)
+
+extern std::map<GLFWwindow *, Screen *> __nanogui_screens;
+
+struct TiledImage::LoaderState {
+    std::mutex mutex;
+    /// Signaled when jobs are added or the image is destroyed
+    std::condition_variable cond;
+    TileLoader loader;
+    size_t tile_bytes = 0;
+    /// Requested tiles, in the order in which they should be loaded
+    std::deque<uint64_t> jobs;
+    /// Tiles that are requested or being loaded
+    std::unordered_set<uint64_t> loading;
+    /// Loaded tiles awaiting upload (an empty buffer marks a failure)
+    std::vector<std::pair<uint64_t, std::vector<uint8_t>>> done;
+    bool stop = false;
+};
+
+TiledImage::TiledImage(const Vector2i &size,
+                       const TileLoader &loader,
+                       int tile_size,
+                       const Vector2i &cache_size,
+                       PixelFormat pixel_format,
+                       ComponentFormat component_format)
+    : m_size(size), m_tile_size(tile_size), m_cache_size(cache_size) {
+    if (size.x() <= 0 || size.y() <= 0 || tile_size <= 0)
+        throw std::runtime_error("TiledImage::TiledImage(): invalid image or tile size!");
+    if (cache_size.x() <= 0 || cache_size.y() <= 0 || cache_size.x() > 256 ||
+        cache_size.y() > 256 || cache_size.x() * cache_size.y() < 4)
+        throw std::runtime_error("TiledImage::TiledImage(): the cache must hold at least 4 "
+                                 "tiles and at most 256 along each axis!");
+    if (!loader)
+        throw std::runtime_error("TiledImage::TiledImage(): a tile loader is required!");
+
+    m_level_count = 1;
+    while (level_size(m_level_count - 1).x() > tile_size ||
+           level_size(m_level_count - 1).y() > tile_size)
+        m_level_count++;
+
+    m_cache = new Texture(pixel_format, component_format, cache_size * tile_size,
+                          Texture::InterpolationMode::Nearest,
+                          Texture::InterpolationMode::Nearest);
+    if (m_cache->compressed())
+        throw std::runtime_error("TiledImage::TiledImage(): block-compressed formats "
+                                 "are not supported!");
+
+    Vector2i indirection_size = tile_count(0);
+    m_indirection = new Texture(PixelFormat::RGBA, ComponentFormat::UInt8, indirection_size,
+                                Texture::InterpolationMode::Nearest,
+                                Texture::InterpolationMode::Nearest);
+    m_indirection_data.resize(4 * (size_t) indirection_size.x() * (size_t) indirection_size.y());
+    m_slots.resize((size_t) cache_size.x() * (size_t) cache_size.y());
+
+    m_loader = std::make_shared<LoaderState>();
+    m_loader->loader = loader;
+    m_loader->tile_bytes = tile_bytes();
+
+    /* The threads only hold on to the shared state, so that destroying the
+       image never has to wait for a tile that is still being loaded */
+    unsigned int count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    for (unsigned int i = 0; i < std::min(count, 4u); ++i)
+        std::thread(loader_thread, m_loader).detach();
+}
+
+TiledImage::~TiledImage() {
+    std::lock_guard<std::mutex> guard(m_loader->mutex);
+    m_loader->stop = true;
+    m_loader->jobs.clear();
+    m_loader->cond.notify_all();
+}
+
+void TiledImage::loader_thread(std::shared_ptr<LoaderState> state) {
+    while (true) {
+        uint64_t key;
+        {
+            std::unique_lock<std::mutex> guard(state->mutex);
+            state->cond.wait(guard, [&]() { return state->stop || !state->jobs.empty(); });
+            if (state->stop)
+                return;
+            key = state->jobs.front();
+            state->jobs.pop_front();
+        }
+
+        uint32_t level = (uint32_t) (key >> 48);
+        Vector2i tile((int) (key & 0xFFFFFF), (int) ((key >> 24) & 0xFFFFFF));
+
+        std::vector<uint8_t> data(state->tile_bytes);
+        bool success = false;
+        try {
+            success = state->loader(level, tile, data.data());
+        } catch (...) {
+            // Treated like a 'false' return value: the tile is marked as failed
+        }
+        if (!success)
+            data.clear();
+
+        {
+            std::lock_guard<std::mutex> guard(state->mutex);
+            if (state->stop)
+                return;
+            state->done.emplace_back(key, std::move(data));
+        }
+
+        async([]() {
+            for (auto kv : __nanogui_screens)
+                kv.second->redraw();
+        });
+    }
+}
+
+size_t TiledImage::tile_bytes() const {
+    return m_cache->bytes_per_pixel() * (size_t) m_tile_size * (size_t) m_tile_size;
+}
+
+Vector2i TiledImage::level_size(uint32_t level) const {
+    int64_t round = ((int64_t) 1 << level) - 1;
+    return Vector2i((int) ((m_size.x() + round) >> level),
+                    (int) ((m_size.y() + round) >> level));
+}
+
+Vector2i TiledImage::tile_count(uint32_t level) const {
+    Vector2i size = level_size(level);
+    return Vector2i((size.x() + m_tile_size - 1) / m_tile_size,
+                    (size.y() + m_tile_size - 1) / m_tile_size);
+}
+
+size_t TiledImage::pending_tiles() const {
+    std::lock_guard<std::mutex> guard(m_loader->mutex);
+    return m_loader->loading.size();
+}
+
+bool TiledImage::update(const Vector2f &min, const Vector2f &max, float scale) {
+    m_frame++;
+
+    // Range of tiles of a level that overlap the visible region
+    auto tile_range = [&](uint32_t level, Vector2i &lo, Vector2i &hi) {
+        float extent = std::ldexp((float) m_tile_size, (int) level);
+        Vector2i count = tile_count(level);
+        for (int k = 0; k < 2; ++k) {
+            // Clamp first, since the view may extend far beyond the image
+            float min_k = std::max(-1.f, std::min(min[k], (float) m_size[k])),
+                  max_k = std::max(-1.f, std::min(max[k], (float) m_size[k]));
+            lo[k] = std::max(0, (int) std::floor(min_k / extent));
+            hi[k] = std::min(count[k] - 1, (int) std::floor(max_k / extent));
+        }
+    };
+
+    auto range_size = [](const Vector2i &lo, const Vector2i &hi) {
+        return (size_t) std::max(0, hi.x() - lo.x() + 1) * (size_t) std::max(0, hi.y() - lo.y() + 1);
+    };
+
+    /* Choose the level whose pixels are closest to the screen pixels, but
+       coarsen it while the region (and the coarser levels providing
+       fallbacks) would not comfortably fit into the cache */
+    uint32_t target = 0;
+    if (scale > 0.f)
+        target = (uint32_t) std::max(0.f, std::floor(std::log2(1.f / scale)));
+    target = std::min(target, m_level_count - 1);
+
+    size_t capacity = m_slots.size() * 3 / 4;
+    for (; target + 1 < m_level_count; ++target) {
+        size_t count = 0;
+        for (uint32_t level = target; level < m_level_count; ++level) {
+            Vector2i lo, hi;
+            tile_range(level, lo, hi);
+            count += range_size(lo, hi);
+        }
+        if (count <= capacity)
+            break;
+    }
+
+    // Wanted tiles, coarse levels first and the center of the view first within a level
+    std::vector<uint64_t> wanted;
+    Vector2f center = .5f * (min + max);
+    for (uint32_t level = m_level_count; level-- > target; ) {
+        Vector2i lo, hi;
+        tile_range(level, lo, hi);
+        if (level == m_level_count - 1)
+            lo = hi = Vector2i(0); // Always keep the coarsest tile as a fallback
+
+        float extent = std::ldexp((float) m_tile_size, (int) level);
+        std::vector<std::pair<float, uint64_t>> tiles;
+        for (int y = lo.y(); y <= hi.y(); ++y) {
+            for (int x = lo.x(); x <= hi.x(); ++x) {
+                Vector2f d = (Vector2f((float) x, (float) y) + .5f) * extent - center;
+                tiles.emplace_back(d.x() * d.x() + d.y() * d.y(), tile_key(level, Vector2i(x, y)));
+            }
+        }
+        std::sort(tiles.begin(), tiles.end());
+        for (auto &t : tiles)
+            wanted.push_back(t.second);
+    }
+
+    // Protect the wanted tiles that are already resident from eviction
+    for (uint64_t key : wanted) {
+        auto it = m_resident.find(key);
+        if (it != m_resident.end())
+            m_slots[it->second].last_use = m_frame;
+    }
+
+    // Upload tiles that finished loading
+    std::vector<std::pair<uint64_t, std::vector<uint8_t>>> done;
+    {
+        std::lock_guard<std::mutex> guard(m_loader->mutex);
+        done.swap(m_loader->done);
+        for (auto &d : done)
+            m_loader->loading.erase(d.first);
+    }
+
+    for (auto &d : done) {
+        if (d.second.empty())
+            m_failed.insert(d.first);
+        else
+            insert_tile(d.first, d.second.data());
+    }
+
+    // Replace the queue of requests by the tiles that are still missing
+    bool complete = true;
+    {
+        std::lock_guard<std::mutex> guard(m_loader->mutex);
+        for (uint64_t key : m_loader->jobs)
+            m_loader->loading.erase(key);
+        m_loader->jobs.clear();
+
+        for (uint64_t key : wanted) {
+            if (m_resident.find(key) != m_resident.end() || m_failed.find(key) != m_failed.end())
+                continue;
+            complete = false;
+            if (m_loader->loading.insert(key).second)
+                m_loader->jobs.push_back(key);
+        }
+        m_loader->cond.notify_all();
+    }
+
+    if (m_indirection_dirty || m_indirection_level != target)
+        update_indirection(target);
+
+    return complete;
+}
+
+void TiledImage::insert_tile(uint64_t key, const uint8_t *data) {
+    if (m_resident.find(key) != m_resident.end())
+        return;
+
+    /* Take a free slot, or else the least recently used one that is
+       neither needed for the current view nor the coarsest tile */
+    uint64_t coarsest = tile_key(m_level_count - 1, Vector2i(0));
+    int64_t index = -1;
+    for (size_t i = 0; i < m_slots.size(); ++i) {
+        const Slot &slot = m_slots[i];
+        if (!slot.used) {
+            index = (int64_t) i;
+            break;
+        }
+        if (slot.last_use == m_frame || slot.key == coarsest)
+            continue;
+        if (index < 0 || slot.last_use < m_slots[index].last_use)
+            index = (int64_t) i;
+    }
+
+    if (index < 0)
+        return;
+
+    Slot &slot = m_slots[index];
+    if (slot.used)
+        m_resident.erase(slot.key);
+    slot.key = key;
+    slot.last_use = m_frame;
+    slot.used = true;
+    m_resident[key] = (uint32_t) index;
+
+    Vector2i origin((int) index % m_cache_size.x(), (int) index / m_cache_size.x());
+    m_cache->upload_sub_region(data, origin * m_tile_size, Vector2i(m_tile_size));
+    m_indirection_dirty = true;
+}
+
+void TiledImage::update_indirection(uint32_t target) {
+    Vector2i count = tile_count(0);
+    uint8_t *entry = m_indirection_data.data();
+
+    for (int y = 0; y < count.y(); ++y) {
+        for (int x = 0; x < count.x(); ++x) {
+            entry[0] = entry[1] = entry[2] = entry[3] = 0;
+
+            // Use the target level if possible, and the finest coarser level otherwise
+            for (uint32_t level = target; level < m_level_count; ++level) {
+                auto it = m_resident.find(tile_key(level, Vector2i(x >> level, y >> level)));
+                if (it == m_resident.end())
+                    continue;
+                entry[0] = (uint8_t) (it->second % m_cache_size.x());
+                entry[1] = (uint8_t) (it->second / m_cache_size.x());
+                entry[2] = (uint8_t) level;
+                entry[3] = 255;
+                break;
+            }
+            entry += 4;
+        }
+    }
+
+    m_indirection->upload(m_indirection_data.data());
+    m_indirection_level = target;
+    m_indirection_dirty = false;
+}
+
+NAMESPACE_END(nanogui)
@@ -0,0 +1,216 @@
+#include <nanogui/uniformblock.h>
+#include <nanogui/shader.h>
+#include <nanogui/opengl.h>
+#include "opengl_check.h"
+
+NAMESPACE_BEGIN(nanogui)
+
+#if !(defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2)
+
+/// Binding points in use (binding point 0 is left to NanoVG)
+static std::vector<bool> uniform_block_bindings;
+
+static bool block_member_type(GLenum gl_type, VariableType &dtype,
+                              size_t &rows, size_t &cols) {
+    rows = cols = 1;
+    switch (gl_type) {
+        case GL_FLOAT:             dtype = VariableType::Float32; break;
+        case GL_FLOAT_VEC2:        dtype = VariableType::Float32; rows = 2; break;
+        case GL_FLOAT_VEC3:        dtype = VariableType::Float32; rows = 3; break;
+        case GL_FLOAT_VEC4:        dtype = VariableType::Float32; rows = 4; break;
+        case GL_INT:               dtype = VariableType::Int32; break;
+        case GL_INT_VEC2:          dtype = VariableType::Int32; rows = 2; break;
+        case GL_INT_VEC3:          dtype = VariableType::Int32; rows = 3; break;
+        case GL_INT_VEC4:          dtype = VariableType::Int32; rows = 4; break;
+        case GL_UNSIGNED_INT:      dtype = VariableType::UInt32; break;
+        case GL_UNSIGNED_INT_VEC2: dtype = VariableType::UInt32; rows = 2; break;
+        case GL_UNSIGNED_INT_VEC3: dtype = VariableType::UInt32; rows = 3; break;
+        case GL_UNSIGNED_INT_VEC4: dtype = VariableType::UInt32; rows = 4; break;
+        case GL_BOOL:              dtype = VariableType::Bool; break;
+        case GL_BOOL_VEC2:         dtype = VariableType::Bool; rows = 2; break;
+        case GL_BOOL_VEC3:         dtype = VariableType::Bool; rows = 3; break;
+        case GL_BOOL_VEC4:         dtype = VariableType::Bool; rows = 4; break;
+        case GL_FLOAT_MAT2:        dtype = VariableType::Float32; rows = cols = 2; break;
+        case GL_FLOAT_MAT3:        dtype = VariableType::Float32; rows = cols = 3; break;
+        case GL_FLOAT_MAT4:        dtype = VariableType::Float32; rows = cols = 4; break;
+        default: return false;
+    }
+    return true;
+}
+
+UniformBlock::UniformBlock(Shader *shader, const std::string &name)
+    : m_name(name) {
+    GLuint program = shader->shader_handle();
+    GLuint block_index = glGetUniformBlockIndex(program, name.c_str());
+    if (block_index == GL_INVALID_INDEX)
+        throw std::runtime_error("UniformBlock::UniformBlock(): shader \"" + shader->name() +
+                                 "\" does not declare a uniform block named \"" + name + "\"!");
+
+    GLint data_size = 0, member_count = 0;
+    CHK(glGetActiveUniformBlockiv(program, block_index, GL_UNIFORM_BLOCK_DATA_SIZE, &data_size));
+    CHK(glGetActiveUniformBlockiv(program, block_index, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS,
+                                  &member_count));
+
+    std::vector<GLint> indices(member_count);
+    if (member_count > 0)
+        CHK(glGetActiveUniformBlockiv(program, block_index,
+                                      GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES, indices.data()));
+
+    std::vector<GLuint> uindices(indices.begin(), indices.end());
+    std::vector<GLint> offsets(member_count), array_strides(member_count),
+                       matrix_strides(member_count);
+    if (member_count > 0) {
+        CHK(glGetActiveUniformsiv(program, member_count, uindices.data(),
+                                  GL_UNIFORM_OFFSET, offsets.data()));
+        CHK(glGetActiveUniformsiv(program, member_count, uindices.data(),
+                                  GL_UNIFORM_ARRAY_STRIDE, array_strides.data()));
+        CHK(glGetActiveUniformsiv(program, member_count, uindices.data(),
+                                  GL_UNIFORM_MATRIX_STRIDE, matrix_strides.data()));
+    }
+
+    for (GLint i = 0; i < member_count; ++i) {
+        char member_name[128];
+        GLenum type = 0;
+        GLint count = 0;
+        CHK(glGetActiveUniform(program, uindices[i], sizeof(member_name), nullptr,
+                               &count, &type, member_name));
+
+        Member member;
+        if (!block_member_type(type, member.dtype, member.rows, member.cols))
+            throw std::runtime_error("UniformBlock::UniformBlock(): member \"" +
+                                     std::string(member_name) + "\" has an unsupported type!");
+        member.offset = (size_t) offsets[i];
+        member.count = (size_t) count;
+        member.array_stride = (size_t) array_strides[i];
+        member.matrix_stride = (size_t) matrix_strides[i];
+
+        // Members of blocks with an instance name are reported as "Block.member"
+        std::string key = member_name;
+        if (key.compare(0, name.length() + 1, name + ".") == 0)
+            key = key.substr(name.length() + 1);
+        // .. and arrays as "member[0]"
+        if (key.length() > 3 && key.compare(key.length() - 3, 3, "[0]") == 0)
+            key = key.substr(0, key.length() - 3);
+
+        m_members[key] = member;
+    }
+
+    m_data.resize((size_t) data_size);
+    m_dirty_begin = 0;
+    m_dirty_end = m_data.size();
+
+    size_t binding = 1;
+    while (binding < uniform_block_bindings.size() && uniform_block_bindings[binding])
+        binding++;
+
+    GLint max_bindings = 0;
+    CHK(glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &max_bindings));
+    if (binding >= (size_t) max_bindings)
+        throw std::runtime_error("UniformBlock::UniformBlock(): ran out of uniform "
+                                 "buffer binding points!");
+    if (binding >= uniform_block_bindings.size())
+        uniform_block_bindings.resize(binding + 1, false);
+    uniform_block_bindings[binding] = true;
+    m_binding = (uint32_t) binding;
+
+    CHK(glGenBuffers(1, &m_buffer_handle));
+    CHK(glBindBuffer(GL_UNIFORM_BUFFER, m_buffer_handle));
+    CHK(glBufferData(GL_UNIFORM_BUFFER, (GLsizeiptr) m_data.size(), nullptr, GL_DYNAMIC_DRAW));
+    CHK(glBindBuffer(GL_UNIFORM_BUFFER, 0));
+    bind();
+}
+
+UniformBlock::~UniformBlock() {
+    CHK(glDeleteBuffers(1, &m_buffer_handle));
+    if (m_binding < uniform_block_bindings.size())
+        uniform_block_bindings[m_binding] = false;
+}
+
+void UniformBlock::set_member(const std::string &name, VariableType dtype, size_t ndim,
+                              const size_t *shape, const void *data) {
+    auto it = m_members.find(name);
+    if (it == m_members.end())
+        throw std::runtime_error("UniformBlock::set_member(): block \"" + m_name +
+                                 "\" has no member named \"" + name + "\"!");
+    const Member &member = it->second;
+
+    // Expected shape: [count] x [rows] x [cols], omitting singleton dimensions
+    size_t expected[3], expected_ndim = 0;
+    if (member.count > 1)
+        expected[expected_ndim++] = member.count;
+    if (member.rows > 1 || member.cols > 1)
+        expected[expected_ndim++] = member.rows;
+    if (member.cols > 1)
+        expected[expected_ndim++] = member.cols;
+
+    bool mismatch = dtype != member.dtype || ndim != expected_ndim;
+    for (size_t i = 0; i < ndim && !mismatch; ++i)
+        mismatch |= shape[i] != expected[i];
+    if (mismatch)
+        throw std::runtime_error("UniformBlock::set_member(\"" + name +
+                                 "\"): shape/dtype mismatch!");
+
+    // std140 stores every scalar (including booleans) using 4 bytes
+    size_t src_size = type_size(dtype);
+    const uint8_t *src = (const uint8_t *) data;
+    size_t begin = (size_t) -1, end = 0;
+
+    for (size_t a = 0; a < member.count; ++a) {
+        for (size_t c = 0; c < member.cols; ++c) {
+            size_t offset = member.offset + a * member.array_stride + c * member.matrix_stride;
+            uint8_t *dst = m_data.data() + offset;
+            if (dtype == VariableType::Bool) {
+                for (size_t r = 0; r < member.rows; ++r) {
+                    uint32_t value = src[r] ? 1 : 0;
+                    memcpy(dst + r * 4, &value, 4);
+                }
+            } else {
+                memcpy(dst, src, member.rows * 4);
+            }
+            src += member.rows * src_size;
+            begin = std::min(begin, offset);
+            end = std::max(end, offset + member.rows * 4);
+        }
+    }
+
+    m_dirty_begin = std::min(m_dirty_begin, begin);
+    m_dirty_end = std::max(m_dirty_end, end);
+}
+
+void UniformBlock::upload() {
+    if (m_dirty_begin >= m_dirty_end)
+        return;
+
+    CHK(glBindBuffer(GL_UNIFORM_BUFFER, m_buffer_handle));
+    CHK(glBufferSubData(GL_UNIFORM_BUFFER, (GLintptr) m_dirty_begin,
+                        (GLsizeiptr) (m_dirty_end - m_dirty_begin),
+                        m_data.data() + m_dirty_begin));
+    CHK(glBindBuffer(GL_UNIFORM_BUFFER, 0));
+    m_dirty_begin = m_data.size();
+    m_dirty_end = 0;
+    bind();
+}
+
+void UniformBlock::bind() {
+    CHK(glBindBufferBase(GL_UNIFORM_BUFFER, m_binding, m_buffer_handle));
+}
+
+#else
+
+UniformBlock::UniformBlock(Shader *, const std::string &) {
+    throw std::runtime_error("UniformBlock::UniformBlock(): uniform blocks are not "
+                             "supported on OpenGL ES 2!");
+}
+
+UniformBlock::~UniformBlock() { }
+
+void UniformBlock::set_member(const std::string &, VariableType, size_t,
+                              const size_t *, const void *) { }
+
+void UniformBlock::upload() { }
+
+void UniformBlock::bind() { }
+
+#endif
+
+NAMESPACE_END(nanogui)
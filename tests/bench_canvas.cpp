@@ -0,0 +1,96 @@
+/*
+    tests/bench_canvas.cpp -- Frame time of a screen with N multisampled
+    canvases that render inline or through the render graph
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include "context.h"
+#include <nanogui/canvas.h>
+#include <nanogui/glstate.h>
+#include <nanogui/label.h>
+#include <nanogui/rendergraph.h>
+#include <benchmark/benchmark.h>
+#include <cmath>
+
+using namespace nanogui;
+
+/// Canvas that draws a single triangle
+class TriangleCanvas : public Canvas {
+public:
+    TriangleCanvas(Widget *parent) : Canvas(parent, 4) {
+        m_shader = test::create_shader(
+            render_pass(), "bench_triangle",
+            R"(attribute vec2 position;
+            void main() {
+                gl_Position = vec4(position, 0.0, 1.0);
+            })",
+            R"(void main() {
+                gl_FragColor = vec4(1.0, 0.5, 0.0, 1.0);
+            })");
+
+        const float positions[] = { -.8f, -.8f, .8f, -.8f, 0.f, .8f };
+        m_shader->set_buffer("position", VariableType::Float32, { 3, 2 }, positions);
+    }
+
+    void draw_contents() override {
+        m_shader->begin();
+        m_shader->draw_array(Shader::PrimitiveType::Triangle, 0, 3);
+        m_shader->end();
+    }
+
+private:
+    ref<Shader> m_shader;
+};
+
+/**
+ * Arguments: number of canvases, and whether they are deferred. A label
+ * next to each canvas makes NanoVG draw in between, which is what forces
+ * inline canvases to flush it.
+ */
+static void canvas_frame(benchmark::State &state) {
+    Screen *screen = test::screen();
+    int count = (int) state.range(0),
+        side = (int) std::ceil(std::sqrt((double) count)),
+        cell = screen->size().x() / side;
+
+    for (int i = 0; i < count; ++i) {
+        Vector2i position((i % side) * cell, (i / side) * cell);
+
+        TriangleCanvas *canvas = new TriangleCanvas(screen);
+        canvas->set_position(position);
+        canvas->set_size(Vector2i(cell, cell / 2));
+        canvas->set_deferred(state.range(1) != 0);
+
+        Label *label = new Label(screen, "Canvas " + std::to_string(i));
+        label->set_position(position + Vector2i(0, cell / 2));
+        label->set_size(Vector2i(cell, cell / 2));
+    }
+
+    for (auto _ : state) {
+        test::draw_frame();
+        test::finish();
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+
+    // Work per frame; the draw calls are identical across frames
+    const RenderGraph::Stats &graph_stats = screen->render_graph()->last_stats();
+    state.counters["passes"] = (double) graph_stats.passes;
+    state.counters["merged"] = (double) graph_stats.merged;
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+    const GLState::Stats &gl_stats = GLState::current().last_frame_stats();
+    state.counters["gl_issued"] = (double) gl_stats.issued;
+    state.counters["gl_elided"] = (double) gl_stats.elided;
+#endif
+}
+
+BENCHMARK(canvas_frame)
+    ->ArgNames({ "canvases", "deferred" })
+    ->ArgsProduct({ { 1, 4, 16, 64 }, { 0, 1 } })
+    ->Unit(benchmark::kMillisecond);
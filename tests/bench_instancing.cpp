@@ -0,0 +1,140 @@
+/*
+    tests/bench_instancing.cpp -- Rendering N copies of the cube of
+    example4 with one draw call per cube compared to instanced drawing
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include "context.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <vector>
+
+using namespace nanogui;
+
+static const uint32_t cube_indices[3*12] = {
+    3, 2, 6, 6, 7, 3,
+    4, 5, 1, 1, 0, 4,
+    4, 0, 3, 3, 7, 4,
+    1, 5, 6, 6, 2, 1,
+    0, 1, 2, 2, 3, 0,
+    7, 6, 5, 5, 4, 7
+};
+
+static const float cube_positions[3*8] = {
+    -1.f, 1.f, 1.f, -1.f, -1.f, 1.f,
+    1.f, -1.f, 1.f, 1.f, 1.f, 1.f,
+    -1.f, 1.f, -1.f, -1.f, -1.f, -1.f,
+    1.f, -1.f, -1.f, 1.f, 1.f, -1.f
+};
+
+static const float cube_colors[3*8] = {
+    0, 1, 1, 0, 0, 1,
+    1, 0, 1, 1, 1, 1,
+    0, 1, 0, 0, 0, 0,
+    1, 0, 0, 1, 1, 0
+};
+
+/// The shader of example4, optionally with a per-instance offset
+static ref<Shader> cube_shader(RenderPass *pass, bool instanced) {
+    std::string vertex =
+        std::string(instanced ? "attribute vec3 offset;\n" : "uniform vec3 offset;\n") +
+        R"(uniform mat4 mvp;
+        attribute vec3 position;
+        attribute vec3 color;
+        varying vec4 frag_color;
+        void main() {
+            frag_color = vec4(color, 1.0);
+            gl_Position = mvp * vec4(position * 0.02 + offset, 1.0);
+        })";
+
+    ref<Shader> shader = test::create_shader(
+        pass, instanced ? "bench_cubes_instanced" : "bench_cubes", vertex,
+        R"(varying vec4 frag_color;
+        void main() {
+            gl_FragColor = frag_color;
+        })");
+    shader->set_buffer("indices", VariableType::UInt32, { 3*12 }, cube_indices);
+    shader->set_buffer("position", VariableType::Float32, { 8, 3 }, cube_positions);
+    shader->set_buffer("color", VariableType::Float32, { 8, 3 }, cube_colors);
+
+    Matrix4f view = Matrix4f::look_at(Vector3f(0, -2, -10), Vector3f(0, 0, 0), Vector3f(0, 1, 0)),
+             proj = Matrix4f::perspective(float(25 * 3.14159f / 180), 0.1f, 20.f, 1.f);
+    shader->set_uniform("mvp", proj * view);
+    return shader;
+}
+
+/// Offsets of 'count' cubes arranged on a square grid
+static std::vector<float> cube_offsets(size_t count) {
+    size_t side = (size_t) std::ceil(std::sqrt((double) count));
+    std::vector<float> offsets;
+    offsets.reserve(count * 3);
+    for (size_t i = 0; i < count; ++i) {
+        offsets.push_back(((float) (i % side) / side - .5f) * 4.f);
+        offsets.push_back(((float) (i / side) / side - .5f) * 4.f);
+        offsets.push_back(0.f);
+    }
+    return offsets;
+}
+
+/// Offscreen color and depth targets, similar to the canvas of example4
+struct CubeScene : test::Offscreen {
+    CubeScene() : test::Offscreen(Vector2i(512, 512), true) {
+        pass->set_depth_test(RenderPass::DepthTest::Less, true);
+    }
+};
+
+static void cubes_per_draw(benchmark::State &state) {
+    CubeScene scene;
+    size_t count = (size_t) state.range(0);
+    ref<Shader> shader = cube_shader(scene.pass, false);
+    std::vector<float> offsets = cube_offsets(count);
+    Shader::Parameter offset = shader->parameter("offset");
+
+    for (auto _ : state) {
+        scene.pass->begin();
+        for (size_t i = 0; i < count; ++i) {
+            shader->set_uniform(offset, Vector3f(offsets[i * 3], offsets[i * 3 + 1],
+                                                 offsets[i * 3 + 2]));
+            shader->begin();
+            shader->draw_array(Shader::PrimitiveType::Triangle, 0, 12*3, true);
+            shader->end();
+        }
+        scene.pass->end();
+        test::finish();
+    }
+
+    state.SetItemsProcessed(state.iterations() * (int64_t) count);
+}
+
+static void cubes_instanced(benchmark::State &state) {
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+    state.SkipWithError("instanced drawing requires OpenGL ES 3");
+    return;
+#endif
+    CubeScene scene;
+    size_t count = (size_t) state.range(0);
+    ref<Shader> shader = cube_shader(scene.pass, true);
+    std::vector<float> offsets = cube_offsets(count);
+    shader->set_buffer("offset", VariableType::Float32, { count, 3 }, offsets.data());
+    shader->set_buffer_divisor("offset", 1);
+
+    for (auto _ : state) {
+        scene.pass->begin();
+        shader->begin();
+        shader->draw_array_instanced(Shader::PrimitiveType::Triangle, 0, 12*3, count, true);
+        shader->end();
+        scene.pass->end();
+        test::finish();
+    }
+
+    state.SetItemsProcessed(state.iterations() * (int64_t) count);
+}
+
+BENCHMARK(cubes_per_draw)->RangeMultiplier(10)->Range(10, 10000)->Unit(benchmark::kMillisecond);
+BENCHMARK(cubes_instanced)->RangeMultiplier(10)->Range(10, 10000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,27 @@
+/*
+    tests/bench_main.cpp -- Entry point of the NanoGUI benchmarks
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include "context.h"
+#include <benchmark/benchmark.h>
+
+int main(int argc, char **argv) {
+    nanogui::init();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    nanogui::test::release();
+    nanogui::shutdown();
+    return 0;
+}
@@ -0,0 +1,111 @@
+/*
+    tests/bench_mipmap.cpp -- Mip maps computed on the CPU compared to
+    glGenerateMipmap()
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include "context.h"
+#include <nanogui/mipmap.h>
+#include <nanogui/texture.h>
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace nanogui;
+
+static const Vector2i mipmap_size(2048, 2048);
+
+static std::vector<uint8_t> noise(size_t size) {
+    std::vector<uint8_t> data(size);
+    std::mt19937 rng(0);
+    for (uint8_t &value : data)
+        value = (uint8_t) rng();
+    return data;
+}
+
+static ref<Texture> trilinear_texture(Texture::MipmapFilter filter) {
+    test::screen();
+    ref<Texture> texture = new Texture(
+        Texture::PixelFormat::RGBA, Texture::ComponentFormat::UInt8, mipmap_size,
+        Texture::InterpolationMode::Trilinear, Texture::InterpolationMode::Bilinear);
+    texture->set_mipmap_filter(filter);
+    return texture;
+}
+
+/// Full upload of level 0 followed by the computation of all other levels
+static void mipmap_upload(benchmark::State &state, Texture::MipmapFilter filter) {
+    ref<Texture> texture = trilinear_texture(filter);
+    std::vector<uint8_t> data = noise(texture->data_size(mipmap_size));
+
+    for (auto _ : state) {
+        texture->upload(data.data());
+        test::finish();
+    }
+}
+
+/// Update of a 256x256 region, which the CPU filters propagate incrementally
+static void mipmap_update_region(benchmark::State &state, Texture::MipmapFilter filter) {
+    ref<Texture> texture = trilinear_texture(filter);
+    std::vector<uint8_t> data = noise(texture->data_size(mipmap_size));
+    texture->upload(data.data());
+
+    const Vector2i region(256, 256);
+    int offset = 0;
+    for (auto _ : state) {
+        Vector2i origin((offset * 97) % (mipmap_size.x() - region.x()),
+                        (offset * 61) % (mipmap_size.y() - region.y()));
+        offset++;
+        texture->upload_sub_region(data.data(), origin, region);
+        test::finish();
+    }
+}
+
+/// CPU filter alone, without any OpenGL calls
+static void mipmap_downsample_cpu(benchmark::State &state, Texture::MipmapFilter filter,
+                                  VariableType type) {
+    size_t channels = 4, bpp = type_size(type) * channels;
+    Vector2i level_size = mipmap_level_size(mipmap_size, 1);
+    std::vector<uint8_t> src = noise((size_t) mipmap_size.x() * mipmap_size.y() * bpp),
+                         dst((size_t) level_size.x() * level_size.y() * bpp);
+
+    // Random bits are not valid half or single precision numbers
+    if (type == VariableType::Float16) {
+        for (size_t i = 0; i < src.size(); i += 2) {
+            uint16_t value = (uint16_t) (0x3000 + src[i] * 8);
+            memcpy(src.data() + i, &value, sizeof(uint16_t));
+        }
+    } else if (type == VariableType::Float32) {
+        for (size_t i = 0; i < src.size(); i += 4) {
+            float value = src[i] / 255.f;
+            memcpy(src.data() + i, &value, sizeof(float));
+        }
+    }
+
+    for (auto _ : state) {
+        mipmap_downsample(src.data(), mipmap_size, dst.data(), Vector2i(0), level_size,
+                          channels, type, filter, false);
+        benchmark::DoNotOptimize(dst.data());
+    }
+
+    state.SetBytesProcessed((int64_t) state.iterations() * (int64_t) src.size());
+}
+
+BENCHMARK_CAPTURE(mipmap_upload, gpu, Texture::MipmapFilter::GPU)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(mipmap_upload, box, Texture::MipmapFilter::Box)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(mipmap_upload, kaiser, Texture::MipmapFilter::Kaiser)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(mipmap_update_region, gpu, Texture::MipmapFilter::GPU)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(mipmap_update_region, box, Texture::MipmapFilter::Box)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(mipmap_update_region, kaiser, Texture::MipmapFilter::Kaiser)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(mipmap_downsample_cpu, box_uint8, Texture::MipmapFilter::Box, VariableType::UInt8)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(mipmap_downsample_cpu, box_float16, Texture::MipmapFilter::Box, VariableType::Float16)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(mipmap_downsample_cpu, kaiser_uint8, Texture::MipmapFilter::Kaiser, VariableType::UInt8)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(mipmap_downsample_cpu, kaiser_float32, Texture::MipmapFilter::Kaiser, VariableType::Float32)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,94 @@
+/*
+    tests/bench_shader.cpp -- Cost of setting shader parameters by name
+    compared to previously resolved handles
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include "context.h"
+#include <benchmark/benchmark.h>
+
+using namespace nanogui;
+
+/// Render target, pass, and a shader with a few typical uniforms
+struct UniformScene : test::Offscreen {
+    ref<Shader> shader;
+
+    UniformScene() {
+        shader = test::create_shader(
+            pass, "bench_uniforms",
+            R"(uniform mat4 mvp;
+            uniform float scale;
+            attribute vec2 position;
+            void main() {
+                gl_Position = mvp * vec4(position * scale, 0.0, 1.0);
+            })",
+            R"(uniform vec4 tint;
+            void main() {
+                gl_FragColor = tint;
+            })");
+
+        const float positions[] = { -.1f, -.1f, .1f, -.1f, 0.f, .1f };
+        shader->set_buffer("position", VariableType::Float32, { 3, 2 }, positions);
+    }
+};
+
+static const int draws_per_iteration = 1000;
+
+static void uniforms_by_name(benchmark::State &state) {
+    UniformScene scene;
+    Matrix4f mvp = Matrix4f::scale(Vector3f(.5f));
+
+    for (auto _ : state) {
+        scene.pass->begin();
+        for (int i = 0; i < draws_per_iteration; ++i) {
+            scene.shader->set_uniform("mvp", mvp);
+            scene.shader->set_uniform("scale", 1.f + i * 1e-3f);
+            scene.shader->set_uniform("tint", Color(i % 255, 128, 0, 255));
+            if (state.range(0)) {
+                scene.shader->begin();
+                scene.shader->draw_array(Shader::PrimitiveType::Triangle, 0, 3);
+                scene.shader->end();
+            }
+        }
+        scene.pass->end();
+        test::finish();
+    }
+
+    state.SetItemsProcessed(state.iterations() * draws_per_iteration);
+}
+
+static void uniforms_by_handle(benchmark::State &state) {
+    UniformScene scene;
+    Matrix4f mvp = Matrix4f::scale(Vector3f(.5f));
+    Shader::Parameter mvp_param   = scene.shader->parameter("mvp"),
+                      scale_param = scene.shader->parameter("scale"),
+                      tint_param  = scene.shader->parameter("tint");
+
+    for (auto _ : state) {
+        scene.pass->begin();
+        for (int i = 0; i < draws_per_iteration; ++i) {
+            scene.shader->set_uniform(mvp_param, mvp);
+            scene.shader->set_uniform(scale_param, 1.f + i * 1e-3f);
+            scene.shader->set_uniform(tint_param, Color(i % 255, 128, 0, 255));
+            if (state.range(0)) {
+                scene.shader->begin();
+                scene.shader->draw_array(Shader::PrimitiveType::Triangle, 0, 3);
+                scene.shader->end();
+            }
+        }
+        scene.pass->end();
+        test::finish();
+    }
+
+    state.SetItemsProcessed(state.iterations() * draws_per_iteration);
+}
+
+// Argument: whether every set of uniforms is followed by a draw call
+BENCHMARK(uniforms_by_name)->ArgName("draw")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+BENCHMARK(uniforms_by_handle)->ArgName("draw")->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,101 @@
+/*
+    tests/bench_shader_cache.cpp -- Startup cost of creating shaders with
+    a cold and a warm program binary cache
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include "context.h"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <filesystem>
+
+using namespace nanogui;
+namespace fs = std::filesystem;
+
+/// Number of distinct programs created at "startup"
+static const int startup_shaders = 8;
+
+/* Mesa keeps its own on-disk shader cache, which it also needs to support
+   program binaries. Tagging the sources with the start time of the process
+   keeps that cache cold across runs of the benchmark. */
+static const std::string run_tag =
+    std::to_string(std::chrono::system_clock::now().time_since_epoch().count());
+
+/* A fragment shader with enough arithmetic to make compilation measurable.
+   The 'variant' comment makes each source, and hence each cache key, unique */
+static void startup_sources(int variant, int index, std::string &vertex, std::string &fragment) {
+    std::string tag = "// variant " + run_tag + "/" + std::to_string(variant) + "/" +
+                      std::to_string(index) + "\n";
+    vertex = tag + R"(
+        uniform mat4 mvp;
+        attribute vec3 position;
+        varying vec3 p;
+        void main() {
+            p = position;
+            gl_Position = mvp * vec4(position, 1.0);
+        })";
+    fragment = tag + R"(
+        uniform float time;
+        varying vec3 p;
+        void main() {
+            vec3 c = vec3(0.0);
+            for (int i = 0; i < 16; ++i) {
+                float f = float(i) + time;
+                c += sin(p * f) * cos(p.yzx * (f + 1.0)) / (1.0 + f);
+            }
+            gl_FragColor = vec4(abs(c), 1.0);
+        })";
+}
+
+/// Create the startup shaders and return how many came from the cache
+static int create_startup_shaders(RenderPass *pass, int variant) {
+    int cached = 0;
+    for (int i = 0; i < startup_shaders; ++i) {
+        std::string vertex, fragment;
+        startup_sources(variant, i, vertex, fragment);
+        ref<Shader> shader = test::create_shader(pass, "bench_startup", vertex, fragment);
+        cached += shader->loaded_from_cache() ? 1 : 0;
+    }
+    test::finish();
+    return cached;
+}
+
+/**
+ * Argument: 0 = no binary cache, 1 = cold cache (compile and store),
+ * 2 = warm cache (load binaries stored beforehand)
+ */
+static void shader_startup(benchmark::State &state) {
+    test::Offscreen offscreen;
+    int mode = (int) state.range(0);
+
+    fs::path dir = fs::temp_directory_path() / "nanogui_bench_shader_cache";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    Shader::set_binary_cache_directory(mode == 0 ? std::string() : dir.string());
+
+    if (mode == 2 && create_startup_shaders(offscreen.pass, 0) != 0) {
+        state.SkipWithError("stale program binary cache");
+        return;
+    }
+
+    // Never repeat a variant, not even across modes, which Mesa would have cached
+    static int variant = 1;
+    for (auto _ : state) {
+        int cached = create_startup_shaders(offscreen.pass, mode == 2 ? 0 : variant++);
+        if (mode == 2 && cached != startup_shaders) {
+            state.SkipWithError("program binaries are not supported by this driver");
+            break;
+        }
+    }
+
+    Shader::set_binary_cache_directory("");
+    fs::remove_all(dir);
+}
+
+BENCHMARK(shader_startup)->ArgName("cache")->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,74 @@
+/*
+    tests/bench_upload.cpp -- Frame time when streaming 4K video frames
+    into a texture, with synchronous and asynchronous uploads
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include "context.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+using namespace nanogui;
+
+/**
+ * Frame time of streaming 4K RGBA frames into a texture that a 1080p pass
+ * then draws as a full-screen quad, as \ref Canvas::draw_contents() would
+ */
+static void stream_4k(benchmark::State &state, bool async) {
+    const Vector2i size(3840, 2160);
+    test::Offscreen offscreen(Vector2i(1920, 1080));
+
+    ref<Texture> texture = new Texture(
+        Texture::PixelFormat::RGBA, Texture::ComponentFormat::UInt8, size,
+        Texture::InterpolationMode::Bilinear, Texture::InterpolationMode::Nearest);
+
+    ref<Shader> shader = test::create_shader(
+        offscreen.pass, "bench_stream",
+        R"(attribute vec2 position;
+        varying vec2 uv;
+        void main() {
+            uv = position * 0.5 + 0.5;
+            gl_Position = vec4(position, 0.0, 1.0);
+        })",
+        R"(uniform sampler2D image;
+        varying vec2 uv;
+        void main() {
+            gl_FragColor = texture2D(image, uv);
+        })");
+
+    const float positions[] = { -1.f, -1.f, 1.f, -1.f, -1.f, 1.f, 1.f, 1.f };
+    shader->set_buffer("position", VariableType::Float32, { 4, 2 }, positions);
+    shader->set_texture("image", texture);
+
+    // A few distinct frames, so that no driver can skip redundant uploads
+    std::vector<std::vector<uint8_t>> frames(3);
+    for (size_t i = 0; i < frames.size(); ++i)
+        frames[i].resize((size_t) size.x() * size.y() * 4, (uint8_t) (64 * i));
+
+    size_t frame = 0;
+    for (auto _ : state) {
+        const uint8_t *data = frames[frame++ % frames.size()].data();
+        if (async)
+            texture->upload_async(data);
+        else
+            texture->upload(data);
+
+        offscreen.pass->begin();
+        shader->begin();
+        shader->draw_array(Shader::PrimitiveType::TriangleStrip, 0, 4);
+        shader->end();
+        offscreen.pass->end();
+    }
+    test::finish();
+
+    state.SetBytesProcessed((int64_t) state.iterations() * (int64_t) frames[0].size());
+}
+
+BENCHMARK_CAPTURE(stream_4k, sync, false)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(stream_4k, async, true)->Unit(benchmark::kMillisecond)->UseRealTime();
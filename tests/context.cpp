@@ -0,0 +1,83 @@
+/*
+    tests/context.cpp -- Hidden screen shared by the NanoGUI tests and
+    benchmarks
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include "context.h"
+#include <nanogui/opengl.h>
+
+NAMESPACE_BEGIN(nanogui)
+NAMESPACE_BEGIN(test)
+
+static ref<Screen> shared_screen;
+
+Screen *screen() {
+    if (!shared_screen)
+        shared_screen = new Screen(Vector2i(256, 256), "NanoGUI test", false);
+
+    while (shared_screen->child_count() > 0)
+        shared_screen->remove_child_at(shared_screen->child_count() - 1);
+
+    glfwMakeContextCurrent(shared_screen->glfw_window());
+    return shared_screen.get();
+}
+
+void draw_frame() {
+    shared_screen->redraw();
+    shared_screen->draw_all();
+}
+
+void finish() {
+#if !defined(NANOGUI_USE_METAL)
+    glFinish();
+#endif
+}
+
+void release() {
+    shared_screen = nullptr;
+}
+
+Offscreen::Offscreen(const Vector2i &size, bool with_depth) {
+    screen();
+    uint8_t flags = (uint8_t) Texture::TextureFlags::ShaderRead |
+                    (uint8_t) Texture::TextureFlags::RenderTarget;
+    color = new Texture(Texture::PixelFormat::RGBA, Texture::ComponentFormat::UInt8, size,
+                        Texture::InterpolationMode::Nearest,
+                        Texture::InterpolationMode::Nearest,
+                        Texture::WrapMode::ClampToEdge, 1, flags);
+    if (with_depth)
+        depth = new Texture(Texture::PixelFormat::Depth, Texture::ComponentFormat::Float32,
+                            size, Texture::InterpolationMode::Nearest,
+                            Texture::InterpolationMode::Nearest,
+                            Texture::WrapMode::ClampToEdge, 1,
+                            (uint8_t) Texture::TextureFlags::RenderTarget);
+    pass = new RenderPass({ color }, depth);
+}
+
+ref<Shader> create_shader(RenderPass *pass, const std::string &name,
+                          const std::string &vertex, const std::string &fragment) {
+#if defined(NANOGUI_USE_OPENGL)
+    std::string vertex_prelude = "#version 330\n"
+                                 "#define attribute in\n"
+                                 "#define varying out\n",
+                fragment_prelude = "#version 330\n"
+                                   "#define varying in\n"
+                                   "#define texture2D texture\n"
+                                   "#define gl_FragColor frag_color_out\n"
+                                   "out vec4 frag_color_out;\n";
+#else
+    std::string vertex_prelude = "precision highp float;\n",
+                fragment_prelude = vertex_prelude;
+#endif
+    return new Shader(pass, name, vertex_prelude + vertex, fragment_prelude + fragment);
+}
+
+NAMESPACE_END(test)
+NAMESPACE_END(nanogui)
@@ -0,0 +1,64 @@
+/*
+    tests/context.h -- Hidden screen shared by the NanoGUI tests and
+    benchmarks
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#pragma once
+
+#include <nanogui/renderpass.h>
+#include <nanogui/screen.h>
+#include <nanogui/shader.h>
+#include <nanogui/texture.h>
+
+NAMESPACE_BEGIN(nanogui)
+NAMESPACE_BEGIN(test)
+
+/**
+ * \brief Return a hidden screen whose context is current on this thread
+ *
+ * The 256x256 screen is created on first use. Its children are removed on
+ * every call, so that each test or benchmark starts with an empty window.
+ */
+extern Screen *screen();
+
+/// Draw one frame of the screen, including its canvases
+extern void draw_frame();
+
+/// Wait until the GPU has finished all previously issued commands
+extern void finish();
+
+/// Destroy the shared screen (called before \ref nanogui::shutdown())
+extern void release();
+
+/**
+ * \brief Offscreen RGBA8 color target, an optional Float32 depth target,
+ * and a render pass that draws into them
+ *
+ * Constructing it also makes the context of the shared screen current.
+ */
+struct Offscreen {
+    ref<Texture> color, depth;
+    ref<RenderPass> pass;
+
+    Offscreen(const Vector2i &size = Vector2i(64, 64), bool with_depth = false);
+};
+
+/**
+ * \brief Create a shader from sources written in GLSL ES 1.0
+ *
+ * The sources use \c attribute, \c varying, \c texture2D() and \c
+ * gl_FragColor and omit the version and precision directives. A prelude
+ * adds them for the backend, mapping the above to GLSL 3.30 on OpenGL.
+ */
+extern ref<Shader> create_shader(RenderPass *pass, const std::string &name,
+                                 const std::string &vertex, const std::string &fragment);
+
+NAMESPACE_END(test)
+NAMESPACE_END(nanogui)
@@ -0,0 +1,24 @@
+/*
+    tests/test_main.cpp -- Entry point of the NanoGUI tests
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include "context.h"
+#include <gtest/gtest.h>
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    nanogui::init();
+
+    int rv = RUN_ALL_TESTS();
+
+    nanogui::test::release();
+    nanogui::shutdown();
+    return rv;
+}
@@ -0,0 +1,250 @@
+/*
+    tests/test_texture.cpp -- Round trip of block-compressed textures and
+    KTX containers through the GPU
+
+    NanoGUI was developed by Wenzel Jakob <wenzel.jakob@epfl.ch>.
+    The widget drawing code is based on the NanoVG demo application
+    by Mikko Mononen.
+
+    All rights reserved. Use of this source code is governed by a
+    BSD-style license that can be found in the LICENSE.txt file.
+*/
+
+#include "context.h"
+#include <nanogui/opengl.h>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+using namespace nanogui;
+
+/* A single ETC2 block in 'individual' mode: both halves use the base color
+   (0xF, 0x8, 0x0) -> (255, 136, 0), and all pixels use the first entry of
+   modifier table 0 (+2), which decodes to (255, 138, 2) */
+static const uint8_t etc2_block[8] = { 0xFF, 0x88, 0x00, 0x00, 0, 0, 0, 0 };
+static const uint8_t etc2_expected[3] = { 255, 138, 2 };
+
+static void append_u32(std::vector<uint8_t> &out, uint32_t value) {
+    uint8_t bytes[4];
+    memcpy(bytes, &value, 4);
+    out.insert(out.end(), bytes, bytes + 4);
+}
+
+static void append_u64(std::vector<uint8_t> &out, uint64_t value) {
+    append_u32(out, (uint32_t) value);
+    append_u32(out, (uint32_t) (value >> 32));
+}
+
+static void set_u32(std::vector<uint8_t> &out, size_t offset, uint32_t value) {
+    memcpy(out.data() + offset, &value, 4);
+}
+
+static std::string write_file(const std::string &name, const std::vector<uint8_t> &data) {
+    std::string path = testing::TempDir() + name;
+    std::ofstream os(path, std::ios::binary);
+    os.write((const char *) data.data(), (std::streamsize) data.size());
+    return path;
+}
+
+/// KTX 1 container holding a 4x4 ETC2 RGB image
+static std::vector<uint8_t> ktx1_etc2() {
+    const uint8_t identifier[12] = {
+        0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'
+    };
+    std::vector<uint8_t> out(identifier, identifier + 12);
+    append_u32(out, 0x04030201); // endianness
+    append_u32(out, 0);          // glType (compressed)
+    append_u32(out, 1);          // glTypeSize
+    append_u32(out, 0);          // glFormat (compressed)
+    append_u32(out, 0x9274);     // GL_COMPRESSED_RGB8_ETC2
+    append_u32(out, 0x1907);     // GL_RGB
+    append_u32(out, 4);          // width
+    append_u32(out, 4);          // height
+    append_u32(out, 0);          // depth
+    append_u32(out, 0);          // array elements
+    append_u32(out, 1);          // faces
+    append_u32(out, 1);          // mip levels
+    append_u32(out, 0);          // key/value data
+    append_u32(out, sizeof(etc2_block));
+    out.insert(out.end(), etc2_block, etc2_block + sizeof(etc2_block));
+    return out;
+}
+
+/// KTX2 container holding a 4x4 ETC2 RGB image at the given offset
+static std::vector<uint8_t> ktx2_etc2(uint64_t level_offset = 104) {
+    const uint8_t identifier[12] = {
+        0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'
+    };
+    std::vector<uint8_t> out(identifier, identifier + 12);
+    append_u32(out, 147);        // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+    append_u32(out, 1);          // type size
+    append_u32(out, 4);          // width
+    append_u32(out, 4);          // height
+    append_u32(out, 0);          // depth
+    append_u32(out, 0);          // layers
+    append_u32(out, 1);          // faces
+    append_u32(out, 1);          // levels
+    append_u32(out, 0);          // supercompression
+    for (int i = 0; i < 4; ++i)  // DFD and KVD offsets/lengths
+        append_u32(out, 0);
+    append_u64(out, 0);          // SGD offset
+    append_u64(out, 0);          // SGD length
+    append_u64(out, level_offset);
+    append_u64(out, sizeof(etc2_block));
+    append_u64(out, sizeof(etc2_block));
+    out.insert(out.end(), etc2_block, etc2_block + sizeof(etc2_block));
+    return out;
+}
+
+/// Draw a texture into a 4x4 RGBA8 render target and download the result
+static std::vector<uint8_t> render_texture(Texture *texture) {
+    test::Offscreen offscreen(Vector2i(4, 4));
+    offscreen.pass->set_clear_color(0, Color(0, 0, 0, 0));
+
+    ref<Shader> shader = test::create_shader(
+        offscreen.pass, "test_texture",
+        R"(attribute vec2 position;
+        varying vec2 uv;
+        void main() {
+            uv = position * 0.5 + 0.5;
+            gl_Position = vec4(position, 0.0, 1.0);
+        })",
+        R"(uniform sampler2D image;
+        varying vec2 uv;
+        void main() {
+            gl_FragColor = texture2D(image, uv);
+        })");
+
+    const float positions[] = { -1.f, -1.f, 1.f, -1.f, -1.f, 1.f, 1.f, 1.f };
+    shader->set_buffer("position", VariableType::Float32, { 4, 2 }, positions);
+    shader->set_texture("image", texture);
+
+    offscreen.pass->begin();
+    shader->begin();
+    shader->draw_array(Shader::PrimitiveType::TriangleStrip, 0, 4);
+    shader->end();
+    offscreen.pass->end();
+
+    std::vector<uint8_t> result(4 * 4 * 4);
+    offscreen.color->download(result.data());
+    return result;
+}
+
+static void check_etc2(Texture *texture) {
+    ASSERT_EQ(texture->pixel_format(), Texture::PixelFormat::ETC2_RGB);
+    ASSERT_TRUE(texture->compressed());
+    ASSERT_EQ(texture->size(), Vector2i(4, 4));
+    EXPECT_EQ(texture->data_size(texture->size()), sizeof(etc2_block));
+
+    std::vector<uint8_t> pixels = render_texture(texture);
+    for (size_t i = 0; i < 16; ++i) {
+        for (size_t ch = 0; ch < 3; ++ch)
+            EXPECT_NEAR(pixels[i * 4 + ch], etc2_expected[ch], 1) << "pixel " << i;
+        EXPECT_EQ(pixels[i * 4 + 3], 255) << "pixel " << i;
+    }
+}
+
+/* ETC2 is part of OpenGL 4.3 and OpenGL ES 3 */
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+#  define SKIP_WITHOUT_ETC2() GTEST_SKIP() << "ETC2 requires OpenGL ES 3"
+#else
+#  define SKIP_WITHOUT_ETC2() (void) 0
+#endif
+
+TEST(Texture, ETC2Upload) {
+    SKIP_WITHOUT_ETC2();
+    test::screen();
+    ref<Texture> texture = new Texture(
+        Texture::PixelFormat::ETC2_RGB, Texture::ComponentFormat::UInt8, Vector2i(4, 4),
+        Texture::InterpolationMode::Nearest, Texture::InterpolationMode::Nearest);
+    texture->upload(etc2_block);
+    check_etc2(texture);
+}
+
+TEST(Texture, ETC2UploadAsync) {
+    SKIP_WITHOUT_ETC2();
+    test::screen();
+    ref<Texture> texture = new Texture(
+        Texture::PixelFormat::ETC2_RGB, Texture::ComponentFormat::UInt8, Vector2i(4, 4),
+        Texture::InterpolationMode::Nearest, Texture::InterpolationMode::Nearest);
+    texture->upload_async(etc2_block);
+    check_etc2(texture);
+}
+
+TEST(Texture, ETC2FromKTX1) {
+    SKIP_WITHOUT_ETC2();
+    test::screen();
+    ref<Texture> texture = new Texture(write_file("nanogui_etc2.ktx", ktx1_etc2()),
+                                       Texture::InterpolationMode::Nearest,
+                                       Texture::InterpolationMode::Nearest);
+    check_etc2(texture);
+}
+
+TEST(Texture, ETC2FromKTX2) {
+    SKIP_WITHOUT_ETC2();
+    test::screen();
+    ref<Texture> texture = new Texture(write_file("nanogui_etc2.ktx2", ktx2_etc2()),
+                                       Texture::InterpolationMode::Nearest,
+                                       Texture::InterpolationMode::Nearest);
+    check_etc2(texture);
+}
+
+TEST(Texture, KTXTruncated) {
+    test::screen();
+    ref<Texture> texture;
+    std::vector<uint8_t> data = ktx1_etc2();
+    data.resize(data.size() - 1);
+    EXPECT_THROW(texture = new Texture(write_file("nanogui_truncated.ktx", data)),
+                 std::runtime_error);
+
+    data = ktx2_etc2(200);
+    EXPECT_THROW(texture = new Texture(write_file("nanogui_truncated.ktx2", data)),
+                 std::runtime_error);
+
+    // The end of this level wraps around to a small offset
+    data = ktx2_etc2(UINT64_MAX - 4);
+    EXPECT_THROW(texture = new Texture(write_file("nanogui_overflow.ktx2", data)),
+                 std::runtime_error);
+    // More mip levels than a 4x4 image can have (the loop used to shift by >= 32)
+    data = ktx1_etc2();
+    set_u32(data, 56, 40);
+    EXPECT_THROW(texture = new Texture(write_file("nanogui_levels.ktx", data)),
+                 std::runtime_error);
+    data = ktx2_etc2();
+    set_u32(data, 40, 40);
+    EXPECT_THROW(texture = new Texture(write_file("nanogui_levels.ktx2", data)),
+                 std::runtime_error);
+
+    // A huge uncompressed RGBA image backed by 8 bytes must not be allocated
+    data = ktx1_etc2();
+    set_u32(data, 16, 0x1401);   // GL_UNSIGNED_BYTE
+    set_u32(data, 24, 0x1908);   // GL_RGBA
+    set_u32(data, 28, 0x8058);   // GL_RGBA8
+    set_u32(data, 36, 65535);
+    set_u32(data, 40, 65535);
+    EXPECT_THROW(texture = new Texture(write_file("nanogui_huge.ktx", data)),
+                 std::runtime_error);
+}
+
+TEST(Texture, DownloadKeepsReadFramebuffer) {
+#if defined(NANOGUI_USE_GLES) && NANOGUI_GLES_VERSION == 2
+    GTEST_SKIP() << "readback requires OpenGL ES 3";
+#endif
+    test::Offscreen source(Vector2i(4, 4)), target(Vector2i(4, 4));
+    std::vector<uint8_t> pixels(4 * 4 * 4, 0x7F), result(pixels.size());
+    target.color->upload(pixels.data());
+
+    // The framebuffer of an active pass, e.g. the source of a blit
+    source.pass->begin();
+    GLint expected = 0, read_framebuffer = 0;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &expected);
+    target.color->download(result.data());
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &read_framebuffer);
+    source.pass->end();
+
+    EXPECT_NE(expected, 0);
+    EXPECT_EQ(read_framebuffer, expected);
+    EXPECT_EQ(result, pixels);
+}